@@ -63,6 +63,8 @@ AC_DEFUN([OMPI_CONFIG_FILES],[
         ompi/tools/wrappers/ompi-fort.pc
         ompi/tools/wrappers/mpijavac.pl
         ompi/tools/mpisync/Makefile
+        ompi/tools/ompi_init_timing/Makefile
+        ompi/tools/ompi_coll_tune/Makefile
         ompi/tools/mpirun/Makefile
     ])
 ])
@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+# Write the index of the dynamic components installed in a directory,
+# which the MCA base reads instead of checking every file of the directory
+# at startup (see mca_base_component_repository_add()). Each line is the
+# name of a component file.
+#
+# The index must be written after the components are installed: it is
+# ignored at run time if the component files of the directory are not
+# exactly the ones it lists.
+#
+# Usage: opal_make_component_index.sh <component directory>
+
+dir="$1"
+index=opal-component-index
+
+if test -z "$dir" || test ! -d "$dir"; then
+    exit 0
+fi
+
+cd "$dir" || exit 1
+
+{
+    echo "# Open MPI component index, written by opal_make_component_index.sh"
+    for file in mca_*; do
+        test -f "$file" || continue
+        case "$file" in
+        *.la|*.lo) continue ;;
+        esac
+        echo "$file"
+    done | sort -u
+} > $index
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+# Convert the trace files written by the opal event tracer
+# (opal_trace_sample_rate > 0) to the Chrome trace event format, which can
+# be loaded in Perfetto or chrome://tracing. Every process becomes a trace
+# process named after its rank, every thread a trace thread. Events are
+# instant events; their arguments hold the peer, tag, communicator and size.
+#
+# Usage: opal-trace-to-json.py opal_trace.*.trc > trace.json
+
+import json
+import struct
+import sys
+
+# must match opal/runtime/opal_trace.h
+FORMAT_VERSION = 1
+FILE_HEADER = struct.Struct('=8sIIQIIII')
+THREAD_HEADER = struct.Struct('=IIQ')
+RECORD = struct.Struct('=QQIiiI')
+
+EVENTS = {
+    1: 'pml_send_start',
+    2: 'pml_send_complete',
+    3: 'pml_recv_post',
+    4: 'pml_recv_match',
+    5: 'pml_recv_complete',
+    6: 'btl_sm_send_complete',
+    7: 'btl_tcp_send_complete',
+}
+
+
+def convert(filename, events):
+    with open(filename, 'rb') as f:
+        data = f.read()
+
+    magic, version, record_size, freq, jobid, vpid, pid, nthreads = \
+        FILE_HEADER.unpack_from(data, 0)
+    if magic.rstrip(b'\0') != b'OPALTRC' or version != FORMAT_VERSION \
+       or record_size != RECORD.size:
+        sys.exit('%s: not a version %d opal trace file' % (filename, FORMAT_VERSION))
+
+    events.append({'ph': 'M', 'name': 'process_name', 'pid': vpid,
+                   'args': {'name': 'rank %d (pid %d)' % (vpid, pid)}})
+
+    offset = FILE_HEADER.size
+    for _ in range(nthreads):
+        thread, nrecords, dropped = THREAD_HEADER.unpack_from(data, offset)
+        offset += THREAD_HEADER.size
+        if dropped:
+            sys.stderr.write('%s: thread %d: %d older records were overwritten\n'
+                             % (filename, thread, dropped))
+        for _ in range(nrecords):
+            timestamp, size, event, peer, tag, cid = RECORD.unpack_from(data, offset)
+            offset += RECORD.size
+            events.append({'ph': 'i', 's': 't', 'pid': vpid, 'tid': thread,
+                           'name': EVENTS.get(event, 'event_%d' % event),
+                           'ts': timestamp * 1e6 / freq,
+                           'args': {'peer': peer, 'tag': tag, 'cid': cid, 'size': size}})
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit('usage: %s <trace file>...' % sys.argv[0])
+
+    events = []
+    for filename in sys.argv[1:]:
+        convert(filename, events)
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -36,34 +36,34 @@ static ompi_coll_tree_t *create_topology(
         }
         case OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL:
         {
-            return ompi_coll_base_topo_build_bmtree(comm, root);
+            return ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_BMTREE, comm, root, 0);
         }
         case OMPI_COLL_ADAPT_ALGORITHM_IN_ORDER_BINOMIAL:
         {
-            return ompi_coll_base_topo_build_in_order_bmtree(comm, root);
+            return ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_IN_ORDER_BMTREE, comm, root, 0);
         }
         case OMPI_COLL_ADAPT_ALGORITHM_BINARY:
         {
-            return ompi_coll_base_topo_build_tree(2, comm, root);
+            return ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_TREE, comm, root, 2);
         }
         case OMPI_COLL_ADAPT_ALGORITHM_PIPELINE:
         {
-            return ompi_coll_base_topo_build_chain(1, comm, root);
+            return ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_CHAIN, comm, root, 1);
         }
         case OMPI_COLL_ADAPT_ALGORITHM_CHAIN:
         {
-            return ompi_coll_base_topo_build_chain(4, comm, root);
+            return ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_CHAIN, comm, root, 4);
         }
         case OMPI_COLL_ADAPT_ALGORITHM_LINEAR:
         {
             int fanout = ompi_comm_size(comm) - 1;
             ompi_coll_tree_t *tree;
             if (fanout < 1) {
-                tree = ompi_coll_base_topo_build_chain(1, comm, root);
+                tree = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_CHAIN, comm, root, 1);
             } else if (fanout <= MAXTREEFANOUT) {
-                tree = ompi_coll_base_topo_build_tree(ompi_comm_size(comm) - 1, comm, root);
+                tree = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_TREE, comm, root, fanout);
             } else {
-                tree = ompi_coll_base_topo_build_tree(MAXTREEFANOUT, comm, root);
+                tree = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_TREE, comm, root, MAXTREEFANOUT);
             }
             return tree;
         }
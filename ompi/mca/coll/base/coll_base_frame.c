@@ -130,5 +130,27 @@ ompi_request_t** ompi_coll_base_comm_get_reqs(mca_coll_base_comm_t* data, int nr
     return data->mcct_reqs;
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, coll, "Collectives", NULL, NULL, NULL,
+static int mca_coll_base_register(mca_base_register_flag_t flags)
+{
+    (void) flags;
+    return ompi_coll_base_topo_cache_register();
+}
+
+static int mca_coll_base_open(mca_base_open_flag_t flags)
+{
+    int ret = ompi_coll_base_topo_cache_init();
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    return mca_base_framework_components_open(&ompi_coll_base_framework, flags);
+}
+
+static int mca_coll_base_close(void)
+{
+    ompi_coll_base_topo_cache_fini();
+    return mca_base_framework_components_close(&ompi_coll_base_framework, NULL);
+}
+
+MCA_BASE_FRAMEWORK_DECLARE(ompi, coll, "Collectives", mca_coll_base_register,
+                           mca_coll_base_open, mca_coll_base_close,
                            mca_coll_base_static_components, 0);
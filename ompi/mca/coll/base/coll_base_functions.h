@@ -332,7 +332,7 @@ do {
         if( coll_comm->cached_bintree ) { /* destroy previous binomial if defined */       \
             ompi_coll_base_topo_destroy_tree( &(coll_comm->cached_bintree) );             \
         }                                                                                  \
-        coll_comm->cached_bintree = ompi_coll_base_topo_build_tree(2,(OMPI_COMM),(ROOT)); \
+        coll_comm->cached_bintree = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_TREE,(OMPI_COMM),(ROOT),2); \
         coll_comm->cached_bintree_root = (ROOT);                                           \
     }                                                                                      \
 } while (0)
@@ -345,7 +345,7 @@ do {
         if( coll_comm->cached_bmtree ) { /* destroy previous binomial if defined */          \
             ompi_coll_base_topo_destroy_tree( &(coll_comm->cached_bmtree) );                \
         }                                                                                    \
-        coll_comm->cached_bmtree = ompi_coll_base_topo_build_bmtree( (OMPI_COMM), (ROOT) ); \
+        coll_comm->cached_bmtree = ompi_coll_base_topo_get_tree( COLL_BASE_TOPO_BMTREE, (OMPI_COMM), (ROOT), 0 ); \
         coll_comm->cached_bmtree_root = (ROOT);                                              \
     }                                                                                        \
 } while (0)
@@ -358,7 +358,7 @@ do {
         if( coll_comm->cached_in_order_bmtree ) { /* destroy previous binomial if defined */ \
             ompi_coll_base_topo_destroy_tree( &(coll_comm->cached_in_order_bmtree) );       \
         }                                                                                    \
-        coll_comm->cached_in_order_bmtree = ompi_coll_base_topo_build_in_order_bmtree( (OMPI_COMM), (ROOT) ); \
+        coll_comm->cached_in_order_bmtree = ompi_coll_base_topo_get_tree( COLL_BASE_TOPO_IN_ORDER_BMTREE, (OMPI_COMM), (ROOT), 0 ); \
         coll_comm->cached_in_order_bmtree_root = (ROOT);                                     \
     }                                                                                        \
 } while (0)
@@ -373,7 +373,7 @@ do {
         if (coll_comm->cached_kmtree ) { /* destroy previous k-nomial tree if defined */     \
             ompi_coll_base_topo_destroy_tree(&(coll_comm->cached_kmtree));                  \
         }                                                                                    \
-        coll_comm->cached_kmtree = ompi_coll_base_topo_build_kmtree((OMPI_COMM), (ROOT), (RADIX)); \
+        coll_comm->cached_kmtree = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_KMTREE, (OMPI_COMM), (ROOT), (RADIX)); \
         coll_comm->cached_kmtree_root = (ROOT);                                              \
         coll_comm->cached_kmtree_radix = (RADIX);                                              \
     }                                                                                        \
@@ -387,7 +387,7 @@ do {
         if (coll_comm->cached_pipeline) { /* destroy previous pipeline if defined */             \
             ompi_coll_base_topo_destroy_tree( &(coll_comm->cached_pipeline) );                  \
         }                                                                                        \
-        coll_comm->cached_pipeline = ompi_coll_base_topo_build_chain( 1, (OMPI_COMM), (ROOT) ); \
+        coll_comm->cached_pipeline = ompi_coll_base_topo_get_tree( COLL_BASE_TOPO_CHAIN, (OMPI_COMM), (ROOT), 1 ); \
         coll_comm->cached_pipeline_root = (ROOT);                                                \
     }                                                                                            \
 } while (0)
@@ -401,7 +401,7 @@ do {
         if( coll_comm->cached_chain) { /* destroy previous chain if defined */                   \
             ompi_coll_base_topo_destroy_tree( &(coll_comm->cached_chain) );                     \
         }                                                                                        \
-        coll_comm->cached_chain = ompi_coll_base_topo_build_chain((FANOUT), (OMPI_COMM), (ROOT)); \
+        coll_comm->cached_chain = ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_CHAIN, (OMPI_COMM), (ROOT), (FANOUT)); \
         coll_comm->cached_chain_root = (ROOT);                                                   \
         coll_comm->cached_chain_fanout = (FANOUT);                                               \
     }                                                                                            \
@@ -414,7 +414,7 @@ do {                                                                           \
         /* In-order binary tree topology is defined by communicator size */    \
         /* Thus, there is no need to destroy anything */                       \
         coll_comm->cached_in_order_bintree =                                   \
-        ompi_coll_base_topo_build_in_order_bintree((OMPI_COMM)); \
+        ompi_coll_base_topo_get_tree(COLL_BASE_TOPO_IN_ORDER_BINTREE, (OMPI_COMM), 0, 0); \
     }                                                                          \
 } while (0)
 
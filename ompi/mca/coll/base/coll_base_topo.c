@@ -304,7 +304,9 @@ int ompi_coll_base_topo_destroy_tree( ompi_coll_tree_t** tree )
 
     ptr = *tree;
 
-    free (ptr);
+    if (!ompi_coll_base_topo_cache_release(ptr)) {
+        free (ptr);
+    }
     *tree = NULL;   /* mark tree as gone */
 
     return OMPI_SUCCESS;
@@ -65,6 +65,33 @@ ompi_coll_base_topo_build_chain( int fanout,
 
 int ompi_coll_base_topo_destroy_tree( ompi_coll_tree_t** tree );
 
+/*
+ * Shared tree cache. Trees returned by ompi_coll_base_topo_get_tree are
+ * shared between all communicators with the same size and local rank,
+ * and must be released with ompi_coll_base_topo_destroy_tree.
+ */
+typedef enum {
+    COLL_BASE_TOPO_TREE = 0,          /* fanout-ary tree */
+    COLL_BASE_TOPO_IN_ORDER_BINTREE,  /* root and fanout are ignored */
+    COLL_BASE_TOPO_BMTREE,            /* fanout is ignored */
+    COLL_BASE_TOPO_IN_ORDER_BMTREE,   /* fanout is ignored */
+    COLL_BASE_TOPO_KMTREE,            /* fanout is the radix */
+    COLL_BASE_TOPO_CHAIN              /* fanout is the number of chains */
+} ompi_coll_base_topo_shape_t;
+
+extern int ompi_coll_base_tree_cache_size;
+
+ompi_coll_tree_t*
+ompi_coll_base_topo_get_tree( ompi_coll_base_topo_shape_t shape,
+                              struct ompi_communicator_t* comm,
+                              int root, int fanout );
+
+/* returns true if the tree belongs to the cache and its reference was dropped */
+bool ompi_coll_base_topo_cache_release( ompi_coll_tree_t* tree );
+int ompi_coll_base_topo_cache_register( void );
+int ompi_coll_base_topo_cache_init( void );
+void ompi_coll_base_topo_cache_fini( void );
+
 /* debugging stuff, will be removed later */
 int ompi_coll_base_topo_dump_tree (ompi_coll_tree_t* tree, int rank);
 
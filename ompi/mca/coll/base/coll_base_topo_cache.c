@@ -0,0 +1,279 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Process-wide cache of the collective trees.
+ *
+ * The trees built in coll_base_topo.c only depend on the size of the
+ * communicator, the rank of the local process, the root and the shape
+ * parameters (fanout or radix), so communicators with the same size
+ * and local rank can share them. Each communicator keeps its own
+ * pointers to the trees it currently uses (the cached_* fields of
+ * mca_coll_base_comm_t), and these pointers are now references into
+ * this cache. Trees that are no longer referenced are kept on an LRU
+ * list and evicted once the cache reaches coll_base_tree_cache_size
+ * entries.
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/threads/mutex.h"
+#include "coll_base_topo.h"
+
+typedef struct {
+    int32_t shape;
+    int32_t size;
+    int32_t rank;
+    int32_t root;
+    int32_t fanout;
+} coll_base_topo_key_t;
+
+typedef struct {
+    opal_list_item_t super;   /* linked in the idle list while unreferenced */
+    coll_base_topo_key_t key;
+    ompi_coll_tree_t *tree;
+    int refcount;
+} coll_base_topo_entry_t;
+
+static OBJ_CLASS_INSTANCE(coll_base_topo_entry_t, opal_list_item_t, NULL, NULL);
+
+int ompi_coll_base_tree_cache_size = 128;
+
+static opal_hash_table_t tree_by_key;   /* coll_base_topo_key_t -> entry */
+static opal_hash_table_t tree_by_ptr;   /* tree address -> entry */
+static opal_list_t idle_trees;          /* unreferenced entries, least recently used first */
+static opal_mutex_t cache_lock = OPAL_MUTEX_STATIC_INIT;
+static bool cache_initialized = false;
+static size_t cache_entries = 0;
+
+static unsigned long long cache_hits = 0;
+static unsigned long long cache_misses = 0;
+static unsigned long long cache_evictions = 0;
+
+static ompi_coll_tree_t *
+coll_base_topo_build(ompi_coll_base_topo_shape_t shape,
+                     struct ompi_communicator_t *comm,
+                     int root, int fanout)
+{
+    switch (shape) {
+    case COLL_BASE_TOPO_TREE:
+        return ompi_coll_base_topo_build_tree(fanout, comm, root);
+    case COLL_BASE_TOPO_IN_ORDER_BINTREE:
+        return ompi_coll_base_topo_build_in_order_bintree(comm);
+    case COLL_BASE_TOPO_BMTREE:
+        return ompi_coll_base_topo_build_bmtree(comm, root);
+    case COLL_BASE_TOPO_IN_ORDER_BMTREE:
+        return ompi_coll_base_topo_build_in_order_bmtree(comm, root);
+    case COLL_BASE_TOPO_KMTREE:
+        return ompi_coll_base_topo_build_kmtree(comm, root, fanout);
+    case COLL_BASE_TOPO_CHAIN:
+        return ompi_coll_base_topo_build_chain(fanout, comm, root);
+    }
+    return NULL;
+}
+
+/* Drop the least recently used idle entry. Called with the lock held. */
+static bool coll_base_topo_cache_evict(void)
+{
+    coll_base_topo_entry_t *entry;
+
+    entry = (coll_base_topo_entry_t *) opal_list_remove_first(&idle_trees);
+    if (NULL == entry) {
+        return false;
+    }
+    opal_hash_table_remove_value_ptr(&tree_by_key, &entry->key, sizeof(entry->key));
+    opal_hash_table_remove_value_uint64(&tree_by_ptr, (uint64_t) (uintptr_t) entry->tree);
+    free(entry->tree);
+    OBJ_RELEASE(entry);
+    cache_entries--;
+    cache_evictions++;
+    return true;
+}
+
+ompi_coll_tree_t *
+ompi_coll_base_topo_get_tree(ompi_coll_base_topo_shape_t shape,
+                             struct ompi_communicator_t *comm,
+                             int root, int fanout)
+{
+    coll_base_topo_entry_t *entry;
+    coll_base_topo_key_t key;
+    ompi_coll_tree_t *tree;
+
+    if (!cache_initialized || 0 >= ompi_coll_base_tree_cache_size) {
+        return coll_base_topo_build(shape, comm, root, fanout);
+    }
+
+    /* normalize the parameters the shape does not depend on */
+    if (COLL_BASE_TOPO_BMTREE == shape || COLL_BASE_TOPO_IN_ORDER_BMTREE == shape) {
+        fanout = 0;
+    } else if (COLL_BASE_TOPO_IN_ORDER_BINTREE == shape) {
+        root = 0;
+        fanout = 0;
+    }
+    key.shape = (int32_t) shape;
+    key.size = ompi_comm_size(comm);
+    key.rank = ompi_comm_rank(comm);
+    key.root = root;
+    key.fanout = fanout;
+
+    OPAL_THREAD_LOCK(&cache_lock);
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&tree_by_key, &key, sizeof(key),
+                                                      (void **) &entry)) {
+        if (0 == entry->refcount++) {
+            opal_list_remove_item(&idle_trees, &entry->super);
+        }
+        cache_hits++;
+        OPAL_THREAD_UNLOCK(&cache_lock);
+        return entry->tree;
+    }
+    cache_misses++;
+    OPAL_THREAD_UNLOCK(&cache_lock);
+
+    tree = coll_base_topo_build(shape, comm, root, fanout);
+    if (NULL == tree) {
+        return NULL;
+    }
+
+    OPAL_THREAD_LOCK(&cache_lock);
+    /* another thread might have inserted the same tree in the meantime */
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&tree_by_key, &key, sizeof(key),
+                                                      (void **) &entry)) {
+        if (0 == entry->refcount++) {
+            opal_list_remove_item(&idle_trees, &entry->super);
+        }
+        OPAL_THREAD_UNLOCK(&cache_lock);
+        free(tree);
+        return entry->tree;
+    }
+    if (cache_entries >= (size_t) ompi_coll_base_tree_cache_size
+        && !coll_base_topo_cache_evict()) {
+        /* every cached tree is in use, hand out a private copy */
+        OPAL_THREAD_UNLOCK(&cache_lock);
+        return tree;
+    }
+    entry = OBJ_NEW(coll_base_topo_entry_t);
+    if (NULL == entry) {
+        OPAL_THREAD_UNLOCK(&cache_lock);
+        return tree;
+    }
+    entry->key = key;
+    entry->tree = tree;
+    entry->refcount = 1;
+    opal_hash_table_set_value_ptr(&tree_by_key, &entry->key, sizeof(entry->key), entry);
+    opal_hash_table_set_value_uint64(&tree_by_ptr, (uint64_t) (uintptr_t) tree, entry);
+    cache_entries++;
+    OPAL_THREAD_UNLOCK(&cache_lock);
+
+    return tree;
+}
+
+bool ompi_coll_base_topo_cache_release(ompi_coll_tree_t *tree)
+{
+    coll_base_topo_entry_t *entry;
+
+    if (!cache_initialized) {
+        return false;
+    }
+
+    OPAL_THREAD_LOCK(&cache_lock);
+    if (OPAL_SUCCESS != opal_hash_table_get_value_uint64(&tree_by_ptr, (uint64_t) (uintptr_t) tree,
+                                                         (void **) &entry)) {
+        OPAL_THREAD_UNLOCK(&cache_lock);
+        return false;
+    }
+    if (0 == --entry->refcount) {
+        opal_list_append(&idle_trees, &entry->super);
+    }
+    OPAL_THREAD_UNLOCK(&cache_lock);
+    return true;
+}
+
+int ompi_coll_base_topo_cache_register(void)
+{
+    ompi_coll_base_tree_cache_size = 128;
+    (void) mca_base_var_register("ompi", "coll", "base", "tree_cache_size",
+                                 "Maximum number of collective trees kept in the process-wide "
+                                 "cache shared by all communicators (0 disables the cache)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_coll_base_tree_cache_size);
+
+    (void) mca_base_pvar_register("ompi", "coll", "base", "tree_cache_hits",
+                                  "Number of collective trees found in the shared tree cache",
+                                  OPAL_INFO_LVL_6, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL, MPI_T_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  NULL, NULL, NULL, (void *) &cache_hits);
+    (void) mca_base_pvar_register("ompi", "coll", "base", "tree_cache_misses",
+                                  "Number of collective trees built because they were not "
+                                  "in the shared tree cache",
+                                  OPAL_INFO_LVL_6, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL, MPI_T_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  NULL, NULL, NULL, (void *) &cache_misses);
+    (void) mca_base_pvar_register("ompi", "coll", "base", "tree_cache_evictions",
+                                  "Number of unused collective trees evicted from the shared "
+                                  "tree cache",
+                                  OPAL_INFO_LVL_6, MCA_BASE_PVAR_CLASS_COUNTER,
+                                  MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL, MPI_T_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  NULL, NULL, NULL, (void *) &cache_evictions);
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_base_topo_cache_init(void)
+{
+    if (cache_initialized) {
+        return OMPI_SUCCESS;
+    }
+    OBJ_CONSTRUCT(&tree_by_key, opal_hash_table_t);
+    OBJ_CONSTRUCT(&tree_by_ptr, opal_hash_table_t);
+    OBJ_CONSTRUCT(&idle_trees, opal_list_t);
+    opal_hash_table_init(&tree_by_key, 64);
+    opal_hash_table_init(&tree_by_ptr, 64);
+    cache_entries = 0;
+    cache_initialized = true;
+    return OMPI_SUCCESS;
+}
+
+void ompi_coll_base_topo_cache_fini(void)
+{
+    coll_base_topo_entry_t *entry;
+    uint64_t key;
+
+    if (!cache_initialized) {
+        return;
+    }
+
+    OPAL_THREAD_LOCK(&cache_lock);
+    cache_initialized = false;
+    /* Trees still referenced by a communicator are left to their owner,
+     * ompi_coll_base_topo_destroy_tree frees them once the cache is gone. */
+    OPAL_HASH_TABLE_FOREACH(key, uint64, entry, &tree_by_ptr) {
+        if (0 == entry->refcount) {
+            opal_list_remove_item(&idle_trees, &entry->super);
+            free(entry->tree);
+        }
+        OBJ_RELEASE(entry);
+    }
+    OBJ_DESTRUCT(&idle_trees);
+    OBJ_DESTRUCT(&tree_by_ptr);
+    OBJ_DESTRUCT(&tree_by_key);
+    cache_entries = 0;
+    OPAL_THREAD_UNLOCK(&cache_lock);
+}
@@ -46,6 +46,8 @@ extern int   ompi_coll_tuned_scatter_intermediate_msg;
 extern int   ompi_coll_tuned_scatter_large_msg;
 extern int   ompi_coll_tuned_scatter_min_procs;
 extern int   ompi_coll_tuned_scatter_blocking_send_ratio;
+extern bool  ompi_coll_tuned_adaptive;
+extern int   ompi_coll_tuned_adaptive_calls;
 
 /* forced algorithm choices */
 /* this structure is for storing the indexes to the forced algorithm mca params... */
@@ -113,6 +115,7 @@ int ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorith
 /* All Reduce */
 int ompi_coll_tuned_allreduce_intra_dec_fixed(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_dec_dynamic(ALLREDUCE_ARGS);
+int ompi_coll_tuned_allreduce_intra_dec_adaptive(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_do_this(ALLREDUCE_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -137,6 +140,7 @@ int ompi_coll_tuned_barrier_intra_check_forced_init (coll_tuned_force_algorithm_
 /* Bcast */
 int ompi_coll_tuned_bcast_intra_dec_fixed(BCAST_ARGS);
 int ompi_coll_tuned_bcast_intra_dec_dynamic(BCAST_ARGS);
+int ompi_coll_tuned_bcast_intra_dec_adaptive(BCAST_ARGS);
 int ompi_coll_tuned_bcast_intra_do_this(BCAST_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_bcast_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -149,6 +153,7 @@ int ompi_coll_tuned_gather_intra_check_forced_init (coll_tuned_force_algorithm_m
 /* Reduce */
 int ompi_coll_tuned_reduce_intra_dec_fixed(REDUCE_ARGS);
 int ompi_coll_tuned_reduce_intra_dec_dynamic(REDUCE_ARGS);
+int ompi_coll_tuned_reduce_intra_dec_adaptive(REDUCE_ARGS);
 int ompi_coll_tuned_reduce_intra_do_this(REDUCE_ARGS, int algorithm, int faninout, int segsize, int max_oustanding_reqs);
 int ompi_coll_tuned_reduce_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
@@ -206,6 +211,26 @@ typedef struct mca_coll_tuned_component_t mca_coll_tuned_component_t;
  */
 OMPI_MODULE_DECLSPEC extern mca_coll_tuned_component_t mca_coll_tuned_component;
 
+/*
+ * Adaptive selection (coll_tuned_adaptive): the algorithms of a collective
+ * are each tried for coll_tuned_adaptive_calls calls, for every message
+ * size bucket of every communicator, then the fastest one is kept. Bucket
+ * 0 holds empty messages and bucket b > 0 the sizes in [2^(b-1), 2^b).
+ */
+#define COLL_TUNED_ADAPTIVE_BUCKETS        48
+#define COLL_TUNED_ADAPTIVE_MAX_ALGORITHMS 16
+/* bucket algorithm when the fastest candidates tie: use the fixed decision */
+#define COLL_TUNED_ADAPTIVE_FIXED          -1
+
+struct coll_tuned_adaptive_bucket_t {
+    int calls;      /* calls made while exploring */
+    int algorithm;  /* chosen algorithm, 0 while exploring */
+    double time[COLL_TUNED_ADAPTIVE_MAX_ALGORITHMS];  /* usec spent in each candidate */
+};
+typedef struct coll_tuned_adaptive_bucket_t coll_tuned_adaptive_bucket_t;
+
+int ompi_coll_tuned_adaptive_register(void);
+
 struct mca_coll_tuned_module_t {
     mca_coll_base_module_t super;
 
@@ -215,6 +240,9 @@ struct mca_coll_tuned_module_t {
 
     /* the communicator rules for each MPI collective for ONLY my comsize */
     ompi_coll_com_rule_t *com_rules[COLLCOUNT];
+
+    /* adaptive selection state, allocated on the first call */
+    coll_tuned_adaptive_bucket_t *adaptive[COLLCOUNT];
 };
 typedef struct mca_coll_tuned_module_t mca_coll_tuned_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_tuned_module_t);
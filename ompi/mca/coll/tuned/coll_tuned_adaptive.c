@@ -0,0 +1,315 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Adaptive algorithm selection.
+ *
+ * For each communicator, collective and message size bucket the
+ * algorithms are tried in turn, coll_tuned_adaptive_calls calls each. All
+ * the processes call the collective with the same message size, so they
+ * go through the same candidates in the same order. Once all have been
+ * tried the time spent in each candidate is reduced with MPI_MAX over the
+ * communicator and every process keeps the same, fastest, algorithm for
+ * the rest of the life of the communicator. If the fastest candidates
+ * tie, the fixed decision is kept instead. Reductions with a non
+ * commutative operation keep the fixed decision, which takes care of the
+ * order of the operands.
+ *
+ * The choices can be read through the coll_tuned_adaptive_<collective>
+ * performance variables, bound to a communicator: element b holds the
+ * algorithm chosen for the message size bucket b, 0 if none was chosen
+ * yet or the fixed decision is kept, and can be written to a dynamic
+ * rules file.
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/op/op.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "opal/mca/timer/base/base.h"
+#include "opal/util/printf.h"
+#include "coll_tuned.h"
+
+static int adaptive_bucket_index(size_t dsize)
+{
+    int b = 0;
+
+    while (0 != dsize && b < COLL_TUNED_ADAPTIVE_BUCKETS - 1) {
+        dsize >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+static int adaptive_candidates(int coll)
+{
+    /* algorithm 0 is the fixed decision */
+    int count = ompi_coll_tuned_forced_max_algorithms[coll] - 1;
+
+    if (count > COLL_TUNED_ADAPTIVE_MAX_ALGORITHMS) {
+        return COLL_TUNED_ADAPTIVE_MAX_ALGORITHMS;
+    }
+    return count < 1 ? 1 : count;
+}
+
+static coll_tuned_adaptive_bucket_t *
+adaptive_bucket(mca_coll_tuned_module_t *tuned_module, int coll, size_t dsize)
+{
+    if (OPAL_UNLIKELY(NULL == tuned_module->adaptive[coll])) {
+        tuned_module->adaptive[coll] = calloc(COLL_TUNED_ADAPTIVE_BUCKETS,
+                                              sizeof(coll_tuned_adaptive_bucket_t));
+        if (NULL == tuned_module->adaptive[coll]) {
+            return NULL;
+        }
+    }
+    return tuned_module->adaptive[coll] + adaptive_bucket_index(dsize);
+}
+
+/* Algorithm to try for the next exploration call */
+static inline int adaptive_next(const coll_tuned_adaptive_bucket_t *bucket)
+{
+    return bucket->calls / ompi_coll_tuned_adaptive_calls + 1;
+}
+
+/*
+ * Account for an exploration call that started at start, and pick the
+ * algorithm once all candidates have been tried.
+ */
+static void adaptive_done(coll_tuned_adaptive_bucket_t *bucket, int coll, opal_timer_t start,
+                          struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    int candidates = adaptive_candidates(coll), best = 0, rc;
+    double elapsed = (double) (opal_timer_base_get_cycles() - start) * 1000000.0
+                     / (double) opal_timer_base_get_freq();
+    bool tie = false;
+
+    /* the first call of each candidate pays for its setup, e.g. the trees */
+    if (1 == ompi_coll_tuned_adaptive_calls
+        || 0 != bucket->calls % ompi_coll_tuned_adaptive_calls) {
+        bucket->time[adaptive_next(bucket) - 1] += elapsed;
+    }
+    if (++bucket->calls < candidates * ompi_coll_tuned_adaptive_calls) {
+        return;
+    }
+
+    /* agree on the times of the slowest process, so that all the processes
+     * pick the same algorithm */
+    rc = ompi_coll_tuned_allreduce_intra_dec_fixed(MPI_IN_PLACE, bucket->time, candidates,
+                                                   MPI_DOUBLE, MPI_MAX, comm, module);
+    if (OMPI_SUCCESS != rc) {
+        /* try again on the next calls */
+        memset(bucket, 0, sizeof(*bucket));
+        return;
+    }
+    for (int i = 1; i < candidates; ++i) {
+        if (bucket->time[i] < bucket->time[best]) {
+            best = i;
+            tie = false;
+        } else if (bucket->time[i] == bucket->time[best]) {
+            tie = true;
+        }
+    }
+    /* nothing tells the fastest candidates apart, e.g. the timer did not
+     * tick: keep the fixed decision rather than the first of them */
+    bucket->algorithm = tie ? COLL_TUNED_ADAPTIVE_FIXED : best + 1;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:adaptive %s on %s: algorithm %d selected for bucket %d",
+                 mca_coll_base_colltype_to_str(coll), comm->c_name, bucket->algorithm,
+                 (int) (bucket - ((mca_coll_tuned_module_t *) module)->adaptive[coll])));
+}
+
+int ompi_coll_tuned_allreduce_intra_dec_adaptive(const void *sbuf, void *rbuf, int count,
+                                                 struct ompi_datatype_t *dtype,
+                                                 struct ompi_op_t *op,
+                                                 struct ompi_communicator_t *comm,
+                                                 mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t *) module;
+    coll_tuned_force_algorithm_params_t *params = &tuned_module->user_forced[ALLREDUCE];
+    coll_tuned_adaptive_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int rc;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    bucket = adaptive_bucket(tuned_module, ALLREDUCE, dsize * (size_t) count);
+    if (OPAL_UNLIKELY(NULL == bucket || !ompi_op_is_commute(op)
+                      || COLL_TUNED_ADAPTIVE_FIXED == bucket->algorithm)) {
+        return ompi_coll_tuned_allreduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op,
+                                                         comm, module);
+    }
+    if (OPAL_LIKELY(0 != bucket->algorithm)) {
+        return ompi_coll_tuned_allreduce_intra_do_this(sbuf, rbuf, count, dtype, op, comm,
+                                                       module, bucket->algorithm,
+                                                       params->tree_fanout, params->segsize);
+    }
+
+    start = opal_timer_base_get_cycles();
+    rc = ompi_coll_tuned_allreduce_intra_do_this(sbuf, rbuf, count, dtype, op, comm, module,
+                                                 adaptive_next(bucket), params->tree_fanout,
+                                                 params->segsize);
+    adaptive_done(bucket, ALLREDUCE, start, comm, module);
+    return rc;
+}
+
+int ompi_coll_tuned_bcast_intra_dec_adaptive(void *buf, int count,
+                                             struct ompi_datatype_t *dtype, int root,
+                                             struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t *) module;
+    coll_tuned_force_algorithm_params_t *params = &tuned_module->user_forced[BCAST];
+    coll_tuned_adaptive_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int rc;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    bucket = adaptive_bucket(tuned_module, BCAST, dsize * (size_t) count);
+    if (OPAL_UNLIKELY(NULL == bucket || COLL_TUNED_ADAPTIVE_FIXED == bucket->algorithm)) {
+        return ompi_coll_tuned_bcast_intra_dec_fixed(buf, count, dtype, root, comm, module);
+    }
+    if (OPAL_LIKELY(0 != bucket->algorithm)) {
+        return ompi_coll_tuned_bcast_intra_do_this(buf, count, dtype, root, comm, module,
+                                                   bucket->algorithm, params->chain_fanout,
+                                                   params->segsize);
+    }
+
+    start = opal_timer_base_get_cycles();
+    rc = ompi_coll_tuned_bcast_intra_do_this(buf, count, dtype, root, comm, module,
+                                             adaptive_next(bucket), params->chain_fanout,
+                                             params->segsize);
+    adaptive_done(bucket, BCAST, start, comm, module);
+    return rc;
+}
+
+int ompi_coll_tuned_reduce_intra_dec_adaptive(const void *sbuf, void *rbuf, int count,
+                                              struct ompi_datatype_t *dtype,
+                                              struct ompi_op_t *op, int root,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t *) module;
+    coll_tuned_force_algorithm_params_t *params = &tuned_module->user_forced[REDUCE];
+    coll_tuned_adaptive_bucket_t *bucket;
+    opal_timer_t start;
+    size_t dsize;
+    int rc;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    bucket = adaptive_bucket(tuned_module, REDUCE, dsize * (size_t) count);
+    if (OPAL_UNLIKELY(NULL == bucket || !ompi_op_is_commute(op)
+                      || COLL_TUNED_ADAPTIVE_FIXED == bucket->algorithm)) {
+        return ompi_coll_tuned_reduce_intra_dec_fixed(sbuf, rbuf, count, dtype, op, root,
+                                                      comm, module);
+    }
+    if (OPAL_LIKELY(0 != bucket->algorithm)) {
+        return ompi_coll_tuned_reduce_intra_do_this(sbuf, rbuf, count, dtype, op, root, comm,
+                                                    module, bucket->algorithm,
+                                                    params->chain_fanout, params->segsize,
+                                                    params->max_requests);
+    }
+
+    start = opal_timer_base_get_cycles();
+    rc = ompi_coll_tuned_reduce_intra_do_this(sbuf, rbuf, count, dtype, op, root, comm, module,
+                                              adaptive_next(bucket), params->chain_fanout,
+                                              params->segsize, params->max_requests);
+    adaptive_done(bucket, REDUCE, start, comm, module);
+    return rc;
+}
+
+/*
+ * Performance variables
+ */
+
+static int adaptive_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event, void *obj,
+                           int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = COLL_TUNED_ADAPTIVE_BUCKETS;
+    }
+    return OMPI_SUCCESS;
+}
+
+static int adaptive_get_value(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    struct ompi_communicator_t *comm = (struct ompi_communicator_t *) obj;
+    int coll = (int) (intptr_t) pvar->ctx, *choices = (int *) value;
+    mca_coll_tuned_module_t *tuned_module = NULL;
+
+    memset(choices, 0, COLL_TUNED_ADAPTIVE_BUCKETS * sizeof(int));
+
+    /* only when this component provides the collective on the communicator */
+    switch (coll) {
+    case ALLREDUCE:
+        if (ompi_coll_tuned_allreduce_intra_dec_adaptive == comm->c_coll->coll_allreduce) {
+            tuned_module = (mca_coll_tuned_module_t *) comm->c_coll->coll_allreduce_module;
+        }
+        break;
+    case BCAST:
+        if (ompi_coll_tuned_bcast_intra_dec_adaptive == comm->c_coll->coll_bcast) {
+            tuned_module = (mca_coll_tuned_module_t *) comm->c_coll->coll_bcast_module;
+        }
+        break;
+    case REDUCE:
+        if (ompi_coll_tuned_reduce_intra_dec_adaptive == comm->c_coll->coll_reduce) {
+            tuned_module = (mca_coll_tuned_module_t *) comm->c_coll->coll_reduce_module;
+        }
+        break;
+    }
+    if (NULL == tuned_module || NULL == tuned_module->adaptive[coll]) {
+        return OMPI_SUCCESS;
+    }
+
+    for (int b = 0; b < COLL_TUNED_ADAPTIVE_BUCKETS; ++b) {
+        choices[b] = tuned_module->adaptive[coll][b].algorithm;
+        if (COLL_TUNED_ADAPTIVE_FIXED == choices[b]) {
+            choices[b] = 0;
+        }
+    }
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_tuned_adaptive_register(void)
+{
+    static const int colls[] = {ALLREDUCE, BCAST, REDUCE};
+
+    for (size_t i = 0; i < sizeof(colls) / sizeof(colls[0]); ++i) {
+        char name[64], *desc;
+
+        snprintf(name, sizeof(name), "adaptive_%s", mca_coll_base_colltype_to_str(colls[i]));
+        opal_asprintf(&desc,
+                      "Algorithms chosen by the adaptive %s selection on a communicator, "
+                      "one per message size bucket: bucket 0 holds empty messages and bucket "
+                      "b the sizes in [2^(b-1), 2^b). 0 while no algorithm is chosen, or when "
+                      "the fixed decision is kept because the candidates tie",
+                      mca_coll_base_colltype_to_str(colls[i]));
+        (void) mca_base_component_pvar_register(&mca_coll_tuned_component.super.collm_version,
+                                                name, desc, OPAL_INFO_LVL_6,
+                                                MCA_BASE_PVAR_CLASS_GENERIC,
+                                                MCA_BASE_VAR_TYPE_INT, NULL, MPI_T_BIND_MPI_COMM,
+                                                MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                                adaptive_get_value, NULL, adaptive_notify,
+                                                (void *) (intptr_t) colls[i]);
+        free(desc);
+    }
+
+    return OMPI_SUCCESS;
+}
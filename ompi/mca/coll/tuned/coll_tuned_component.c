@@ -71,6 +71,10 @@ int   ompi_coll_tuned_scatter_large_msg = 0;
 int   ompi_coll_tuned_scatter_min_procs = 0;
 int   ompi_coll_tuned_scatter_blocking_send_ratio = 0;
 
+/* Disabled by default */
+bool  ompi_coll_tuned_adaptive = false;
+int   ompi_coll_tuned_adaptive_calls = 3;
+
 /* forced alogrithm variables */
 /* indices for the MCA parameters */
 coll_tuned_force_algorithm_mca_param_indices_t ompi_coll_tuned_forced_params[COLLCOUNT] = {{0}};
@@ -191,6 +195,28 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_coll_tuned_dynamic_rules_filename);
 
+    ompi_coll_tuned_adaptive = false;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "adaptive",
+                                           "Select the allreduce, bcast and reduce algorithms at runtime: each communicator times the algorithms during the first calls for each message size and keeps the fastest. The choices are exposed by the coll_tuned_adaptive_<collective> performance variables. Not used for a collective with dynamic rules or a forced algorithm",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_adaptive);
+
+    ompi_coll_tuned_adaptive_calls = 3;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "adaptive_calls",
+                                           "Number of calls each algorithm is tried for by the adaptive selection, for each communicator and message size. The first call of an algorithm is not timed unless this is 1",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_adaptive_calls);
+    if (ompi_coll_tuned_adaptive_calls < 1) {
+        ompi_coll_tuned_adaptive_calls = 1;
+    }
+    (void) ompi_coll_tuned_adaptive_register();
+
     /* register forced params */
     ompi_coll_tuned_allreduce_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLREDUCE]);
     ompi_coll_tuned_alltoall_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLTOALL]);
@@ -276,8 +302,18 @@ mca_coll_tuned_module_construct(mca_coll_tuned_module_t *module)
     for( int i = 0; i < COLLCOUNT; i++ ) {
         tuned_module->user_forced[i].algorithm = 0;
         tuned_module->com_rules[i] = NULL;
+        tuned_module->adaptive[i] = NULL;
+    }
+}
+
+static void
+mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
+{
+    for( int i = 0; i < COLLCOUNT; i++ ) {
+        free(module->adaptive[i]);
+        module->adaptive[i] = NULL;
     }
 }
 
 OBJ_CLASS_INSTANCE(mca_coll_tuned_module_t, mca_coll_base_module_t,
-                   mca_coll_tuned_module_construct, NULL);
+                   mca_coll_tuned_module_construct, mca_coll_tuned_module_destruct);
@@ -250,6 +250,24 @@ tuned_module_enable( mca_coll_base_module_t *module,
                                       tuned_module->super.coll_scatterv   = NULL);
     }
 
+    /* the adaptive selection applies to the collectives with neither dynamic
+     * rules nor a forced algorithm. The fanout and segment size are those
+     * of the forced algorithms */
+    if (ompi_coll_tuned_adaptive) {
+        if (ompi_coll_tuned_allreduce_intra_dec_fixed == tuned_module->super.coll_allreduce) {
+            ompi_coll_tuned_forced_getvalues(ALLREDUCE, &tuned_module->user_forced[ALLREDUCE]);
+            tuned_module->super.coll_allreduce = ompi_coll_tuned_allreduce_intra_dec_adaptive;
+        }
+        if (ompi_coll_tuned_bcast_intra_dec_fixed == tuned_module->super.coll_bcast) {
+            ompi_coll_tuned_forced_getvalues(BCAST, &tuned_module->user_forced[BCAST]);
+            tuned_module->super.coll_bcast = ompi_coll_tuned_bcast_intra_dec_adaptive;
+        }
+        if (ompi_coll_tuned_reduce_intra_dec_fixed == tuned_module->super.coll_reduce) {
+            ompi_coll_tuned_forced_getvalues(REDUCE, &tuned_module->user_forced[REDUCE]);
+            tuned_module->super.coll_reduce = ompi_coll_tuned_reduce_intra_dec_adaptive;
+        }
+    }
+
     /* general n fan out tree */
     data->cached_ntree = NULL;
     /* binary tree */
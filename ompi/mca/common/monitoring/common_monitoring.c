@@ -28,7 +28,9 @@
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 #include "opal/runtime/opal.h"
-#include <math.h>
+#include "opal/mca/threads/mutex.h"
+#include "opal/mca/threads/thread_usage.h"
+#include <stddef.h>
 
 #if SIZEOF_LONG_LONG == SIZEOF_SIZE_T
 #define MCA_MONITORING_VAR_TYPE MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG
@@ -64,21 +66,66 @@ static int mca_common_monitoring_output_enabled = 0;
 static char* mca_common_monitoring_initial_filename = "";
 static char* mca_common_monitoring_current_filename = NULL;
 
-/* array for stroring monitoring data*/
-static opal_atomic_size_t* pml_data = NULL;
-static opal_atomic_size_t* pml_count = NULL;
-static opal_atomic_size_t* filtered_pml_data = NULL;
-static opal_atomic_size_t* filtered_pml_count = NULL;
-static opal_atomic_size_t* osc_data_s = NULL;
-static opal_atomic_size_t* osc_count_s = NULL;
-static opal_atomic_size_t* osc_data_r = NULL;
-static opal_atomic_size_t* osc_count_r = NULL;
-static opal_atomic_size_t* coll_data = NULL;
-static opal_atomic_size_t* coll_count = NULL;
-
-static opal_atomic_size_t* size_histogram = NULL;
-static const int max_size_histogram = 66;
-static double log10_2 = 0.;
+#define MCA_COMMON_MONITORING_HISTOGRAM_SIZE 66
+static const int max_size_histogram = MCA_COMMON_MONITORING_HISTOGRAM_SIZE;
+
+/* Monitoring data for one peer. Only the peers a process actually
+ * communicates with get one, so the memory used does not grow with the
+ * size of MPI_COMM_WORLD. */
+typedef struct mca_common_monitoring_peer_t {
+    int world_rank;
+    size_t pml_data;
+    size_t pml_count;
+    size_t filtered_pml_data;
+    size_t filtered_pml_count;
+    size_t osc_data_s;
+    size_t osc_count_s;
+    size_t osc_data_r;
+    size_t osc_count_r;
+    size_t coll_data;
+    size_t coll_count;
+    size_t size_histogram[MCA_COMMON_MONITORING_HISTOGRAM_SIZE];
+} mca_common_monitoring_peer_t;
+
+#define MCA_COMMON_MONITORING_CHUNK_SIZE 32
+
+/* Peers are allocated in chunks and never move, so that readers can walk
+ * them while the owner keeps adding new ones. */
+typedef struct mca_common_monitoring_chunk_t {
+    struct mca_common_monitoring_chunk_t *next;
+    opal_atomic_int32_t count;  /* number of initialized peers */
+    mca_common_monitoring_peer_t peers[MCA_COMMON_MONITORING_CHUNK_SIZE];
+} mca_common_monitoring_chunk_t;
+
+/* The peers recorded by one thread. The counters are only updated by the
+ * owning thread without atomics. The values of all threads are summed up
+ * when the data is read. The slots index the peers by rank and are private
+ * to the owner. */
+typedef struct mca_common_monitoring_table_t {
+    struct mca_common_monitoring_table_t *next;
+    mca_common_monitoring_chunk_t *chunks;
+    mca_common_monitoring_peer_t **slots;
+    size_t nslots;
+    size_t npeers;
+    /* value of mca_common_monitoring_reset_generation the counters belong to */
+    opal_atomic_int32_t reset_generation;
+} mca_common_monitoring_table_t;
+
+/* all the tables, protected by mca_common_monitoring_lock */
+static mca_common_monitoring_table_t *mca_common_monitoring_tables = NULL;
+static opal_mutex_t mca_common_monitoring_lock = OPAL_MUTEX_STATIC_INIT;
+
+/* Bumped under mca_common_monitoring_lock to reset the data. Only the owner
+ * of a table writes its counters, so the owner clears them the next time it
+ * records something, and until then the readers ignore the table. */
+static opal_atomic_int32_t mca_common_monitoring_reset_generation = 0;
+
+#if OPAL_HAVE_THREAD_LOCAL
+/* bumped when the tables are released to invalidate the thread pointers */
+static int32_t mca_common_monitoring_generation = 1;
+static opal_thread_local mca_common_monitoring_table_t *mca_common_monitoring_local_table = NULL;
+static opal_thread_local int32_t mca_common_monitoring_local_generation = 0;
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
 
 static int rank_world = -1;
 static int nprocs_world = 0;
@@ -210,14 +257,253 @@ static int mca_common_monitoring_comm_size_notify(mca_base_pvar_t *pvar,
     return OMPI_ERROR;
 }
 
+static mca_common_monitoring_table_t *mca_common_monitoring_table_new( void )
+{
+    mca_common_monitoring_table_t *table = calloc(1, sizeof(*table));
+    if( NULL == table ) return NULL;
+
+    table->nslots = 64;
+    table->slots = calloc(table->nslots, sizeof(table->slots[0]));
+    if( NULL == table->slots ) {
+        free(table);
+        return NULL;
+    }
+    table->reset_generation = mca_common_monitoring_reset_generation;
+    return table;
+}
+
+static void mca_common_monitoring_table_free( mca_common_monitoring_table_t *table )
+{
+    mca_common_monitoring_chunk_t *chunk, *next;
+
+    for( chunk = table->chunks; NULL != chunk; chunk = next ) {
+        next = chunk->next;
+        free(chunk);
+    }
+    free(table->slots);
+    free(table);
+}
+
+static inline size_t mca_common_monitoring_hash( int world_rank, size_t nslots )
+{
+    return ((uint32_t) world_rank * 2654435761u) & (nslots - 1);
+}
+
+static int mca_common_monitoring_table_grow( mca_common_monitoring_table_t *table )
+{
+    size_t nslots = 2 * table->nslots;
+    mca_common_monitoring_peer_t **slots = calloc(nslots, sizeof(slots[0]));
+    if( NULL == slots ) return OMPI_ERR_OUT_OF_RESOURCE;
+
+    for( size_t i = 0; i < table->nslots; ++i ) {
+        mca_common_monitoring_peer_t *peer = table->slots[i];
+        if( NULL == peer ) continue;
+        size_t j = mca_common_monitoring_hash(peer->world_rank, nslots);
+        while( NULL != slots[j] ) j = (j + 1) & (nslots - 1);
+        slots[j] = peer;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->nslots = nslots;
+    return OMPI_SUCCESS;
+}
+
+/* Find the data of a peer in a table, adding it if this is the first time
+ * the peer is seen. Only called by the owner of the table. */
+static mca_common_monitoring_peer_t *
+mca_common_monitoring_table_lookup( mca_common_monitoring_table_t *table, int world_rank )
+{
+    mca_common_monitoring_chunk_t *chunk = table->chunks;
+    mca_common_monitoring_peer_t *peer;
+    size_t i = mca_common_monitoring_hash(world_rank, table->nslots);
+
+    while( NULL != (peer = table->slots[i]) ) {
+        if( peer->world_rank == world_rank ) return peer;
+        i = (i + 1) & (table->nslots - 1);
+    }
+
+    if( NULL == chunk || MCA_COMMON_MONITORING_CHUNK_SIZE == chunk->count ) {
+        chunk = calloc(1, sizeof(*chunk));
+        if( NULL == chunk ) return NULL;
+        chunk->next = table->chunks;
+        /* make the chunk visible to the readers once it is initialized */
+        opal_atomic_wmb();
+        table->chunks = chunk;
+    }
+
+    peer = &chunk->peers[chunk->count];
+    peer->world_rank = world_rank;
+    opal_atomic_wmb();
+    chunk->count = chunk->count + 1;
+
+    table->slots[i] = peer;
+    if( 2 * ++table->npeers > table->nslots ) {
+        /* on failure the table is just fuller than it should be */
+        (void) mca_common_monitoring_table_grow(table);
+    }
+    return peer;
+}
+
+/* Clear the counters of a table after a reset. Only called by the owner of
+ * the table. */
+static void mca_common_monitoring_table_refresh( mca_common_monitoring_table_t *table )
+{
+    int32_t generation = mca_common_monitoring_reset_generation;
+
+    for( mca_common_monitoring_chunk_t *chunk = table->chunks;
+         NULL != chunk; chunk = chunk->next ) {
+        for( int32_t i = 0; i < chunk->count; ++i ) {
+            mca_common_monitoring_peer_t *peer = &chunk->peers[i];
+            int world_rank = peer->world_rank;
+            memset(peer, 0, sizeof(*peer));
+            peer->world_rank = world_rank;
+        }
+    }
+    /* the readers only look at the counters once the generation matches */
+    opal_atomic_wmb();
+    table->reset_generation = generation;
+}
+
+/* Get the table of the calling thread. Without thread local storage all
+ * threads share a table and the caller holds mca_common_monitoring_lock. */
+static inline mca_common_monitoring_table_t *mca_common_monitoring_get_table( void )
+{
+    mca_common_monitoring_table_t *table;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    if( OPAL_LIKELY(mca_common_monitoring_local_generation == mca_common_monitoring_generation) ) {
+        return mca_common_monitoring_local_table;
+    }
+#else
+    if( OPAL_LIKELY(NULL != mca_common_monitoring_tables) ) {
+        return mca_common_monitoring_tables;
+    }
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
+    table = mca_common_monitoring_table_new();
+    if( NULL == table ) return NULL;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    opal_mutex_lock(&mca_common_monitoring_lock);
+    table->next = mca_common_monitoring_tables;
+    mca_common_monitoring_tables = table;
+    mca_common_monitoring_local_table = table;
+    mca_common_monitoring_local_generation = mca_common_monitoring_generation;
+    opal_mutex_unlock(&mca_common_monitoring_lock);
+#else
+    mca_common_monitoring_tables = table;
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
+    return table;
+}
+
+#if OPAL_HAVE_THREAD_LOCAL
+#define MCA_COMMON_MONITORING_RECORD_LOCK()
+#define MCA_COMMON_MONITORING_RECORD_UNLOCK()
+#else
+#define MCA_COMMON_MONITORING_RECORD_LOCK() opal_mutex_lock(&mca_common_monitoring_lock)
+#define MCA_COMMON_MONITORING_RECORD_UNLOCK() opal_mutex_unlock(&mca_common_monitoring_lock)
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
+/* Apply fn to the data of every peer in every table. Must be called with
+ * mca_common_monitoring_lock held. Tables not yet cleared by their owner
+ * since the last reset only hold stale data and are skipped. */
+static void mca_common_monitoring_foreach_peer( void (*fn)(mca_common_monitoring_peer_t *peer,
+                                                           void *ctx), void *ctx )
+{
+    for( mca_common_monitoring_table_t *table = mca_common_monitoring_tables;
+         NULL != table; table = table->next ) {
+        if( table->reset_generation != mca_common_monitoring_reset_generation ) continue;
+        opal_atomic_rmb();
+        for( mca_common_monitoring_chunk_t *chunk = table->chunks;
+             NULL != chunk; chunk = chunk->next ) {
+            int32_t count = chunk->count;
+            opal_atomic_rmb();
+            for( int32_t i = 0; i < count; ++i ) {
+                fn(&chunk->peers[i], ctx);
+            }
+        }
+    }
+}
+
+static void mca_common_monitoring_tables_release( void )
+{
+    mca_common_monitoring_table_t *table, *next;
+
+    opal_mutex_lock(&mca_common_monitoring_lock);
+    for( table = mca_common_monitoring_tables; NULL != table; table = next ) {
+        next = table->next;
+        mca_common_monitoring_table_free(table);
+    }
+    mca_common_monitoring_tables = NULL;
+#if OPAL_HAVE_THREAD_LOCAL
+    ++mca_common_monitoring_generation;
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+    opal_mutex_unlock(&mca_common_monitoring_lock);
+}
+
+struct mca_common_monitoring_fold_t {
+    size_t offset;
+    size_t *values;
+    int nvalues;
+};
+
+static void mca_common_monitoring_fold_peer( mca_common_monitoring_peer_t *peer, void *ctx )
+{
+    struct mca_common_monitoring_fold_t *fold = (struct mca_common_monitoring_fold_t *) ctx;
+
+    if( peer->world_rank < fold->nvalues ) {
+        fold->values[peer->world_rank] += *(size_t *) ((uintptr_t) peer + fold->offset);
+    }
+}
+
+/* Sum up one counter of all threads into a dense array indexed by rank. */
+static void mca_common_monitoring_fold( size_t offset, size_t *values, int nvalues )
+{
+    struct mca_common_monitoring_fold_t fold = {.offset = offset, .values = values,
+                                                 .nvalues = nvalues};
+
+    memset(values, 0, nvalues * sizeof(size_t));
+    opal_mutex_lock(&mca_common_monitoring_lock);
+    mca_common_monitoring_foreach_peer(mca_common_monitoring_fold_peer, &fold);
+    opal_mutex_unlock(&mca_common_monitoring_lock);
+}
+
+/* Get the data of world_rank in the table of the calling thread. */
+#define MCA_COMMON_MONITORING_GET_PEER(peer, world_rank)                 \
+    do {                                                                \
+        mca_common_monitoring_table_t *_table = mca_common_monitoring_get_table(); \
+        if( NULL != _table && OPAL_UNLIKELY(_table->reset_generation   \
+                                            != mca_common_monitoring_reset_generation) ) \
+            mca_common_monitoring_table_refresh(_table);                \
+        (peer) = (NULL == _table) ? NULL                                \
+            : mca_common_monitoring_table_lookup(_table, (world_rank)); \
+    } while (0)
+
+/* Histogram bin of a message size: 0 for empty messages, log2(size) + 1
+ * otherwise. */
+static inline int mca_common_monitoring_size_bin( size_t data_size )
+{
+    int log2_size;
+
+    if( 0 == data_size ) return 0;
+#if OPAL_C_HAVE_BUILTIN_CLZ
+    log2_size = (int) (8 * sizeof(unsigned long long) - 1)
+        - __builtin_clzll((unsigned long long) data_size);
+#else
+    for( log2_size = 0; data_size >>= 1; ++log2_size );
+#endif  /* OPAL_C_HAVE_BUILTIN_CLZ */
+    if( log2_size > max_size_histogram - 2 ) /* Avoid out-of-bound write */
+        log2_size = max_size_histogram - 2;
+    return log2_size + 1;
+}
+
 int mca_common_monitoring_init( void )
 {
     if( !mca_common_monitoring_enabled ) return OMPI_ERROR;
     if( 1 < opal_atomic_add_fetch_32(&mca_common_monitoring_hold, 1) ) return OMPI_SUCCESS; /* Already initialized */
 
     const char *hostname;
-    /* Initialize constant */
-    log10_2 = log10(2.);
     /* Open the opal_output stream */
     hostname = opal_gethostname();
     opal_asprintf(&mca_common_monitoring_output_stream_obj.lds_prefix,
@@ -245,7 +531,7 @@ void mca_common_monitoring_finalize( void )
     opal_output_close(mca_common_monitoring_output_stream_id);
     free(mca_common_monitoring_output_stream_obj.lds_prefix);
     /* Free internal data structure */
-    free((void *) pml_data);  /* a single allocation */
+    mca_common_monitoring_tables_release();
     opal_hash_table_remove_all( common_monitoring_translation_ht );
     OBJ_RELEASE(common_monitoring_translation_ht);
     mca_common_monitoring_coll_finalize();
@@ -448,22 +734,6 @@ int mca_common_monitoring_add_procs(struct ompi_proc_t **procs,
     if( !nprocs_world )
         nprocs_world = ompi_comm_size((ompi_communicator_t*)&ompi_mpi_comm_world);
 
-    if( NULL == pml_data ) {
-        int array_size = (10 + max_size_histogram) * nprocs_world;
-        pml_data           = (opal_atomic_size_t*)calloc(array_size, sizeof(size_t));
-        pml_count          = pml_data + nprocs_world;
-        filtered_pml_data  = pml_count + nprocs_world;
-        filtered_pml_count = filtered_pml_data + nprocs_world;
-        osc_data_s         = filtered_pml_count + nprocs_world;
-        osc_count_s        = osc_data_s + nprocs_world;
-        osc_data_r         = osc_count_s + nprocs_world;
-        osc_count_r        = osc_data_r + nprocs_world;
-        coll_data          = osc_count_r + nprocs_world;
-        coll_count         = coll_data + nprocs_world;
-
-        size_histogram     = coll_count + nprocs_world;
-    }
-
     /* For all procs in the same MPI_COMM_WORLD we need to add them to the hash table */
     for( i = 0; i < nprocs; i++ ) {
 
@@ -496,235 +766,277 @@ int mca_common_monitoring_add_procs(struct ompi_proc_t **procs,
 
 static void mca_common_monitoring_reset( void )
 {
-    int array_size = (10 + max_size_histogram) * nprocs_world;
-    memset((void *) pml_data, 0, array_size * sizeof(size_t));
+    /* the counters are cleared by the owner of each table, see
+     * mca_common_monitoring_table_refresh */
+    opal_mutex_lock(&mca_common_monitoring_lock);
+    ++mca_common_monitoring_reset_generation;
+    opal_mutex_unlock(&mca_common_monitoring_lock);
     mca_common_monitoring_coll_reset();
 }
 
 void mca_common_monitoring_record_pml(int world_rank, size_t data_size, int tag)
 {
+    mca_common_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
 
-    /* Keep tracks of the data_size distribution */
-    if( 0 == data_size ) {
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram], 1);
-    } else {
-        int log2_size = log10(data_size)/log10_2;
-        if(log2_size > max_size_histogram - 2) /* Avoid out-of-bound write */
-            log2_size = max_size_histogram - 2;
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram + log2_size + 1], 1);
+    MCA_COMMON_MONITORING_RECORD_LOCK();
+    MCA_COMMON_MONITORING_GET_PEER(peer, world_rank);
+    if( OPAL_UNLIKELY(NULL == peer) ) {
+        MCA_COMMON_MONITORING_RECORD_UNLOCK();
+        return;
     }
 
+    /* Keep tracks of the data_size distribution */
+    peer->size_histogram[mca_common_monitoring_size_bin(data_size)]++;
+
     /* distinguishses positive and negative tags if requested */
     if( (tag < 0) && (mca_common_monitoring_filter()) ) {
-        opal_atomic_add_fetch_size_t(&filtered_pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&filtered_pml_count[world_rank], 1);
+        peer->filtered_pml_data += data_size;
+        peer->filtered_pml_count++;
     } else { /* if filtered monitoring is not activated data is aggregated indifferently */
-        opal_atomic_add_fetch_size_t(&pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&pml_count[world_rank], 1);
+        peer->pml_data += data_size;
+        peer->pml_count++;
     }
+    MCA_COMMON_MONITORING_RECORD_UNLOCK();
 }
 
-static int mca_common_monitoring_get_pml_count(const struct mca_base_pvar_t *pvar,
-                                               void *value,
-                                               void *obj_handle)
+static int mca_common_monitoring_get_values(size_t offset, void *value, void *obj_handle)
 {
     ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
 
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
+    if(comm != &ompi_mpi_comm_world.comm || 0 == nprocs_world)
         return OMPI_ERROR;
 
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = pml_count[i];
-    }
+    mca_common_monitoring_fold(offset, (size_t*) value, ompi_comm_size (comm));
 
     return OMPI_SUCCESS;
 }
 
+static int mca_common_monitoring_get_pml_count(const struct mca_base_pvar_t *pvar,
+                                               void *value,
+                                               void *obj_handle)
+{
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, pml_count),
+                                            value, obj_handle);
+}
+
 static int mca_common_monitoring_get_pml_size(const struct mca_base_pvar_t *pvar,
                                               void *value,
                                               void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = pml_data[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, pml_data),
+                                            value, obj_handle);
 }
 
 void mca_common_monitoring_record_osc(int world_rank, size_t data_size,
                                       enum mca_monitoring_osc_direction dir)
 {
+    mca_common_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
 
-    if( SEND == dir ) {
-        opal_atomic_add_fetch_size_t(&osc_data_s[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&osc_count_s[world_rank], 1);
-    } else {
-        opal_atomic_add_fetch_size_t(&osc_data_r[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&osc_count_r[world_rank], 1);
+    MCA_COMMON_MONITORING_RECORD_LOCK();
+    MCA_COMMON_MONITORING_GET_PEER(peer, world_rank);
+    if( OPAL_LIKELY(NULL != peer) ) {
+        if( SEND == dir ) {
+            peer->osc_data_s += data_size;
+            peer->osc_count_s++;
+        } else {
+            peer->osc_data_r += data_size;
+            peer->osc_count_r++;
+        }
     }
+    MCA_COMMON_MONITORING_RECORD_UNLOCK();
 }
 
 static int mca_common_monitoring_get_osc_sent_count(const struct mca_base_pvar_t *pvar,
                                                     void *value,
                                                     void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_count_s[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, osc_count_s),
+                                            value, obj_handle);
 }
 
 static int mca_common_monitoring_get_osc_sent_size(const struct mca_base_pvar_t *pvar,
                                                    void *value,
                                                    void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_data_s[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, osc_data_s),
+                                            value, obj_handle);
 }
 
 static int mca_common_monitoring_get_osc_recv_count(const struct mca_base_pvar_t *pvar,
                                                     void *value,
                                                     void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_count_r[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, osc_count_r),
+                                            value, obj_handle);
 }
 
 static int mca_common_monitoring_get_osc_recv_size(const struct mca_base_pvar_t *pvar,
                                                    void *value,
                                                    void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = osc_data_r[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, osc_data_r),
+                                            value, obj_handle);
 }
 
 void mca_common_monitoring_record_coll(int world_rank, size_t data_size)
 {
+    mca_common_monitoring_peer_t *peer;
+
     if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
 
-    opal_atomic_add_fetch_size_t(&coll_data[world_rank], data_size);
-    opal_atomic_add_fetch_size_t(&coll_count[world_rank], 1);
+    MCA_COMMON_MONITORING_RECORD_LOCK();
+    MCA_COMMON_MONITORING_GET_PEER(peer, world_rank);
+    if( OPAL_LIKELY(NULL != peer) ) {
+        peer->coll_data += data_size;
+        peer->coll_count++;
+    }
+    MCA_COMMON_MONITORING_RECORD_UNLOCK();
 }
 
 static int mca_common_monitoring_get_coll_count(const struct mca_base_pvar_t *pvar,
                                                 void *value,
                                                 void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int i, comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
-        return OMPI_ERROR;
-
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = coll_count[i];
-    }
-
-    return OMPI_SUCCESS;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, coll_count),
+                                            value, obj_handle);
 }
 
 static int mca_common_monitoring_get_coll_size(const struct mca_base_pvar_t *pvar,
                                                void *value,
                                                void *obj_handle)
 {
-    ompi_communicator_t *comm = (ompi_communicator_t *) obj_handle;
-    int comm_size = ompi_comm_size (comm);
-    size_t *values = (size_t*) value;
-    int i;
+    return mca_common_monitoring_get_values(offsetof(mca_common_monitoring_peer_t, coll_data),
+                                            value, obj_handle);
+}
 
-    if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
-        return OMPI_ERROR;
+struct mca_common_monitoring_collect_t {
+    mca_common_monitoring_peer_t **peers;
+    size_t npeers;
+    size_t max_peers;
+};
+
+static void mca_common_monitoring_count_peer( mca_common_monitoring_peer_t *peer, void *ctx )
+{
+    ((struct mca_common_monitoring_collect_t *) ctx)->npeers++;
+}
+
+static void mca_common_monitoring_collect_peer( mca_common_monitoring_peer_t *peer, void *ctx )
+{
+    struct mca_common_monitoring_collect_t *collect = ctx;
+    /* peers added since they were counted are left for the next flush */
+    if( collect->npeers < collect->max_peers )
+        collect->peers[collect->npeers++] = peer;
+}
 
-    for (i = 0 ; i < comm_size ; ++i) {
-        values[i] = coll_data[i];
+static int mca_common_monitoring_peer_compare( const void *a, const void *b )
+{
+    const mca_common_monitoring_peer_t *pa = *(mca_common_monitoring_peer_t * const *) a;
+    const mca_common_monitoring_peer_t *pb = *(mca_common_monitoring_peer_t * const *) b;
+    return (pa->world_rank > pb->world_rank) - (pa->world_rank < pb->world_rank);
+}
+
+/*
+ * Sum up the data of all the threads into one record per peer, sorted by
+ * rank. Returns the number of records, or -1 if out of memory.
+ */
+static int mca_common_monitoring_merge( mca_common_monitoring_peer_t **merged )
+{
+    struct mca_common_monitoring_collect_t collect = {.peers = NULL, .npeers = 0,
+                                                      .max_peers = 0};
+    mca_common_monitoring_peer_t *out = NULL;
+    size_t npeers;
+    int nmerged = 0;
+
+    opal_mutex_lock(&mca_common_monitoring_lock);
+    mca_common_monitoring_foreach_peer(mca_common_monitoring_count_peer, &collect);
+    npeers = collect.npeers;
+    if( 0 < npeers ) {
+        collect.peers = malloc(npeers * sizeof(collect.peers[0]));
+        out = calloc(npeers, sizeof(out[0]));
+        if( NULL == collect.peers || NULL == out ) {
+            opal_mutex_unlock(&mca_common_monitoring_lock);
+            free(collect.peers);
+            free(out);
+            return -1;
+        }
+        collect.npeers = 0;
+        collect.max_peers = npeers;
+        mca_common_monitoring_foreach_peer(mca_common_monitoring_collect_peer, &collect);
+        npeers = collect.npeers;
     }
 
-    return OMPI_SUCCESS;
+    qsort(collect.peers, npeers, sizeof(collect.peers[0]), mca_common_monitoring_peer_compare);
+    for( size_t i = 0; i < npeers; ++i ) {
+        const mca_common_monitoring_peer_t *peer = collect.peers[i];
+        mca_common_monitoring_peer_t *m;
+        if( 0 == nmerged || out[nmerged - 1].world_rank != peer->world_rank ) {
+            out[nmerged++].world_rank = peer->world_rank;
+        }
+        m = &out[nmerged - 1];
+        m->pml_data += peer->pml_data;
+        m->pml_count += peer->pml_count;
+        m->filtered_pml_data += peer->filtered_pml_data;
+        m->filtered_pml_count += peer->filtered_pml_count;
+        m->osc_data_s += peer->osc_data_s;
+        m->osc_count_s += peer->osc_count_s;
+        m->osc_data_r += peer->osc_data_r;
+        m->osc_count_r += peer->osc_count_r;
+        m->coll_data += peer->coll_data;
+        m->coll_count += peer->coll_count;
+        for( int j = 0; j < max_size_histogram; ++j )
+            m->size_histogram[j] += peer->size_histogram[j];
+    }
+    opal_mutex_unlock(&mca_common_monitoring_lock);
+
+    free(collect.peers);
+    *merged = out;
+    return nmerged;
 }
 
-static void mca_common_monitoring_output( FILE *pf, int my_rank, int nbprocs )
+static void mca_common_monitoring_output( FILE *pf, int my_rank )
 {
+    mca_common_monitoring_peer_t *peers = NULL;
+    int npeers = mca_common_monitoring_merge(&peers);
+
+    if( 0 > npeers ) {
+        OPAL_MONITORING_PRINT_ERR("Error while flushing: out of memory");
+        return;
+    }
+
     /* Dump outgoing messages */
     fprintf(pf, "# POINT TO POINT\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(pml_count[i] > 0) {
+    for (int i = 0 ; i < npeers ; i++) {
+        const mca_common_monitoring_peer_t *peer = &peers[i];
+        if(peer->pml_count > 0) {
             fprintf(pf, "E\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\t",
-                    my_rank, i, pml_data[i], pml_count[i]);
+                    my_rank, peer->world_rank, peer->pml_data, peer->pml_count);
             for(int j = 0 ; j < max_size_histogram ; ++j)
-                fprintf(pf, "%zu%s", size_histogram[i * max_size_histogram + j],
+                fprintf(pf, "%zu%s", peer->size_histogram[j],
                         j < max_size_histogram - 1 ? "," : "\n");
         }
     }
 
     /* Dump outgoing synchronization/collective messages */
     if( mca_common_monitoring_filter() ) {
-        for (int i = 0 ; i < nbprocs ; i++) {
-            if(filtered_pml_count[i] > 0) {
+        for (int i = 0 ; i < npeers ; i++) {
+            const mca_common_monitoring_peer_t *peer = &peers[i];
+            if(peer->filtered_pml_count > 0) {
                 fprintf(pf, "I\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent%s",
-                        my_rank, i, filtered_pml_data[i], filtered_pml_count[i],
-                        0 == pml_count[i] ? "\t" : "\n");
+                        my_rank, peer->world_rank, peer->filtered_pml_data,
+                        peer->filtered_pml_count, 0 == peer->pml_count ? "\t" : "\n");
                 /* 
                  * In the case there was no external messages
                  * exchanged between the two processes, the histogram
                  * has not yet been dumpped. Then we need to add it at
                  * the end of the internal category.
                  */
-                if(0 == pml_count[i]) {
+                if(0 == peer->pml_count) {
                     for(int j = 0 ; j < max_size_histogram ; ++j)
-                        fprintf(pf, "%zu%s", size_histogram[i * max_size_histogram + j],
+                        fprintf(pf, "%zu%s", peer->size_histogram[j],
                                 j < max_size_histogram - 1 ? "," : "\n");
                 }
             }
@@ -733,26 +1045,29 @@ static void mca_common_monitoring_output( FILE *pf, int my_rank, int nbprocs )
 
     /* Dump incoming messages */
     fprintf(pf, "# OSC\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(osc_count_s[i] > 0) {
+    for (int i = 0 ; i < npeers ; i++) {
+        const mca_common_monitoring_peer_t *peer = &peers[i];
+        if(peer->osc_count_s > 0) {
             fprintf(pf, "S\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, osc_data_s[i], osc_count_s[i]);
+                    my_rank, peer->world_rank, peer->osc_data_s, peer->osc_count_s);
         }
-        if(osc_count_r[i] > 0) {
+        if(peer->osc_count_r > 0) {
             fprintf(pf, "R\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, osc_data_r[i], osc_count_r[i]);
+                    my_rank, peer->world_rank, peer->osc_data_r, peer->osc_count_r);
         }
     }
 
     /* Dump collectives */
     fprintf(pf, "# COLLECTIVES\n");
-    for (int i = 0 ; i < nbprocs ; i++) {
-        if(coll_count[i] > 0) {
+    for (int i = 0 ; i < npeers ; i++) {
+        const mca_common_monitoring_peer_t *peer = &peers[i];
+        if(peer->coll_count > 0) {
             fprintf(pf, "C\t%" PRId32 "\t%" PRId32 "\t%zu bytes\t%zu msgs sent\n",
-                    my_rank, i, coll_data[i], coll_count[i]);
+                    my_rank, peer->world_rank, peer->coll_data, peer->coll_count);
         }
     }
     mca_common_monitoring_coll_flush_all(pf);
+    free(peers);
 }
 
 /*
@@ -767,10 +1082,10 @@ static int mca_common_monitoring_flush(int fd, char* filename)
 
     if( 1 == fd ) {
         OPAL_MONITORING_PRINT_INFO("Proc %" PRId32 " flushing monitoring to stdout", rank_world);
-        mca_common_monitoring_output( stdout, rank_world, nprocs_world );
+        mca_common_monitoring_output( stdout, rank_world );
     } else if( 2 == fd ) {
         OPAL_MONITORING_PRINT_INFO("Proc %" PRId32 " flushing monitoring to stderr", rank_world);
-        mca_common_monitoring_output( stderr, rank_world, nprocs_world );
+        mca_common_monitoring_output( stderr, rank_world );
     } else {
         FILE *pf = NULL;
         char* tmpfn = NULL;
@@ -793,7 +1108,7 @@ static int mca_common_monitoring_flush(int fd, char* filename)
         OPAL_MONITORING_PRINT_INFO("Proc %d flushing monitoring to: %s.%" PRId32 ".prof",
                                    rank_world, filename, rank_world);
 
-        mca_common_monitoring_output( pf, rank_world, nprocs_world );
+        mca_common_monitoring_output( pf, rank_world );
 
         fclose(pf);
     }
@@ -83,6 +83,7 @@
 #define SIMPLE                          5
 #define NO_REFINEMENT                   6
 #define SIMPLE_PLUS                     7
+#define TOPOLOGY_AWARE                  8
 
 #define OMPIO_LOCK_ENTIRE_REGION  10
 #define OMPIO_LOCK_SELECTIVE      11
@@ -142,6 +143,7 @@ typedef int (*mca_common_ompio_get_mca_parameter_value_fn_t) ( char *mca_paramet
 
 
 struct mca_common_ompio_print_queue;
+struct mca_common_ompio_wbcache_t;
 
 /**
  * Back-end structure for MPI_File
@@ -198,6 +200,9 @@ struct ompio_file_t {
     mca_common_ompio_io_array_t *f_io_array;
     int                      f_num_of_io_entries;
 
+    /* write-behind cache for independent writes, NULL if disabled */
+    struct mca_common_ompio_wbcache_t *f_wb_cache;
+
     /* Hooks for modules to hang things */
     mca_base_component_t *f_fs_component;
     mca_base_component_t *f_fcoll_component;
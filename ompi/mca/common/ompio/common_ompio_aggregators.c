@@ -51,15 +51,28 @@
 ** 2. fview_based_grouping: analysis the fileview to detect regular patterns
 ** 3. cart_based_grouping: uses a cartesian communicator to derive certain (probable) properties
 **    of the access pattern
+** 4. topo_aware_grouping: simple_grouping with the no. of aggregators aligned to the file
+**    striping and aggregators spread evenly across nodes
 */
 
 static double cost_calc (int P, int P_agg, size_t Data_proc, size_t coll_buffer, int dim );
 #define DIM1 1
 #define DIM2 2
 
+static int simple_num_groups (ompio_file_t *fh);
+
 int mca_common_ompio_simple_grouping(ompio_file_t *fh,
                                      int *num_groups_out,
                                      mca_common_ompio_contg *contg_groups)
+{
+    int num_groups = simple_num_groups (fh);
+
+    *num_groups_out = num_groups;
+
+    return mca_common_ompio_forced_grouping ( fh, num_groups, contg_groups);
+}
+
+static int simple_num_groups (ompio_file_t *fh)
 {
     int num_groups=1;
 
@@ -181,10 +194,8 @@ int mca_common_ompio_simple_grouping(ompio_file_t *fh,
     if ( 1 >= num_groups ) {
 	num_groups = 1;
     }
-    
-    *num_groups_out = num_groups;
 
-    return mca_common_ompio_forced_grouping ( fh, num_groups, contg_groups);
+    return num_groups;
 }
 
 int  mca_common_ompio_forced_grouping ( ompio_file_t *fh,
@@ -225,6 +236,197 @@ int  mca_common_ompio_forced_grouping ( ompio_file_t *fh,
     return OMPI_SUCCESS;
 }
 
+/*
+** Topology and stripe aware version of simple_grouping. The no. of aggregators
+** is taken from the cost model, adjusted to the stripe count of the file if the
+** file system provided one, such that every aggregator serves the same no. of
+** stripes (OSTs in case of Lustre). Aggregators are then placed round-robin
+** across the nodes used by the communicator, and every other process is attached
+** to a group whose aggregator is located on the same node if possible.
+*/
+static int get_node_leader (ompio_file_t *fh)
+{
+    ompi_group_t *group = fh->f_comm->c_local_group;
+    int i;
+
+    /* the node is identified by the lowest rank located on it */
+    for ( i=0; i<fh->f_rank; i++ ) {
+        ompi_proc_t *proc = NULL;
+#if OMPI_GROUP_SPARSE
+        proc = ompi_group_peer_lookup (group, i);
+#else
+        proc = ompi_group_get_proc_ptr_raw (group, i);
+        if ( ompi_proc_is_sentinel (proc) ) {
+            /* procs on the local node are never sentinels */
+            continue;
+        }
+#endif
+        if ( OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags) ) {
+            return i;
+        }
+    }
+
+    return fh->f_rank;
+}
+
+int mca_common_ompio_topo_aware_grouping(ompio_file_t *fh,
+                                         int *num_groups_out,
+                                         mca_common_ompio_contg *contg_groups)
+{
+    int num_groups, num_nodes=0;
+    int group_size, rest;
+    int i, k, n, g, leader;
+    int ret = OMPI_SUCCESS;
+    int *node_of_rank=NULL, *node_index=NULL;
+    int *node_first=NULL, *node_next=NULL;
+    int *group_node=NULL, *node_group_cursor=NULL;
+    int *is_aggr=NULL;
+
+    num_groups = simple_num_groups (fh);
+
+    /* Align the no. of aggregators to the stripe count. A multiple of the
+    ** stripe count if there are more aggregators than stripes, a divisor
+    ** of it otherwise.
+    */
+    if ( fh->f_stripe_size > 0 && fh->f_stripe_count > 1 ) {
+        if ( num_groups >= fh->f_stripe_count ) {
+            num_groups -= num_groups % fh->f_stripe_count;
+        }
+        else {
+            while ( fh->f_stripe_count % num_groups ) {
+                num_groups--;
+            }
+        }
+    }
+    if ( num_groups > fh->f_size ) {
+        num_groups = fh->f_size;
+    }
+    if ( 1 >= num_groups ) {
+        num_groups = 1;
+    }
+
+    leader = get_node_leader (fh);
+
+    node_of_rank = (int *) malloc ( fh->f_size * sizeof(int));
+    node_index   = (int *) malloc ( fh->f_size * sizeof(int));
+    node_first   = (int *) malloc ( fh->f_size * sizeof(int));
+    node_next    = (int *) malloc ( fh->f_size * sizeof(int));
+    is_aggr      = (int *) calloc ( fh->f_size, sizeof(int));
+    group_node   = (int *) malloc ( num_groups * sizeof(int));
+    node_group_cursor = (int *) malloc ( fh->f_size * sizeof(int));
+    if ( NULL == node_of_rank || NULL == node_index || NULL == node_first ||
+         NULL == node_next || NULL == is_aggr || NULL == group_node ||
+         NULL == node_group_cursor ) {
+        opal_output (1, "OUT OF MEMORY\n");
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+
+    ret = fh->f_comm->c_coll->coll_allgather (&leader,
+                                             1,
+                                             MPI_INT,
+                                             node_of_rank,
+                                             1,
+                                             MPI_INT,
+                                             fh->f_comm,
+                                             fh->f_comm->c_coll->coll_allgather_module);
+    if ( OMPI_SUCCESS != ret ) {
+        goto exit;
+    }
+
+    /* Translate node leaders into consecutive node indices and build a
+    ** list of ranks per node, in rank order.
+    */
+    for ( i=0; i<fh->f_size; i++ ) {
+        node_index[i] = -1;
+        node_first[i] = -1;
+        node_next[i]  = -1;
+    }
+    for ( i=fh->f_size-1; i>=0; i-- ) {
+        node_next[i] = node_first[node_of_rank[i]];
+        node_first[node_of_rank[i]] = i;
+    }
+    for ( i=0; i<fh->f_size; i++ ) {
+        if ( node_of_rank[i] == i ) {
+            node_index[i] = num_nodes;
+            node_first[num_nodes] = node_first[i];
+            num_nodes++;
+        }
+    }
+    for ( i=0; i<fh->f_size; i++ ) {
+        node_of_rank[i] = node_index[node_of_rank[i]];
+    }
+
+    group_size = fh->f_size / num_groups;
+    rest       = fh->f_size % num_groups;
+    for ( g=0; g<num_groups; g++ ) {
+        contg_groups[g].procs_per_contg_group = 0;
+    }
+
+    /* Place aggregators round-robin across nodes */
+    for ( i=0; i<num_nodes; i++ ) {
+        node_group_cursor[i] = node_first[i];
+    }
+    for ( g=0, n=0; g<num_groups; n = (n+1) % num_nodes ) {
+        k = node_group_cursor[n];
+        if ( -1 == k ) {
+            /* all processes on this node are aggregators already */
+            continue;
+        }
+        node_group_cursor[n] = node_next[k];
+        contg_groups[g].procs_in_contg_group[0] = k;
+        contg_groups[g].procs_per_contg_group   = 1;
+        group_node[g] = n;
+        is_aggr[k] = 1;
+        g++;
+    }
+
+    /* Attach the remaining processes to a group on the same node first */
+    for ( i=0; i<num_nodes; i++ ) {
+        node_group_cursor[i] = 0;
+    }
+    for ( k=0, g=0; k<fh->f_size; k++ ) {
+        int target = -1;
+
+        if ( is_aggr[k] ) {
+            continue;
+        }
+        n = node_of_rank[k];
+        for ( ; node_group_cursor[n] < num_groups; node_group_cursor[n]++ ) {
+            int cur = node_group_cursor[n];
+            int max = ( cur < rest ) ? group_size+1 : group_size;
+
+            if ( group_node[cur] == n && contg_groups[cur].procs_per_contg_group < max ) {
+                target = cur;
+                break;
+            }
+        }
+        if ( -1 == target ) {
+            for ( ; g < num_groups; g++ ) {
+                int max = ( g < rest ) ? group_size+1 : group_size;
+                if ( contg_groups[g].procs_per_contg_group < max ) {
+                    target = g;
+                    break;
+                }
+            }
+        }
+        contg_groups[target].procs_in_contg_group[contg_groups[target].procs_per_contg_group++] = k;
+    }
+
+    *num_groups_out = num_groups;
+
+exit:
+    free (node_of_rank);
+    free (node_index);
+    free (node_first);
+    free (node_next);
+    free (is_aggr);
+    free (group_node);
+    free (node_group_cursor);
+
+    return ret;
+}
+
 int mca_common_ompio_fview_based_grouping(ompio_file_t *fh,
                      		          int *num_groups,
 				          mca_common_ompio_contg *contg_groups)
@@ -512,9 +714,10 @@ int mca_common_ompio_set_aggregator_props (struct ompio_file_t *fh,
     fh->f_flags |= OMPIO_AGGREGATOR_IS_SET;
 
     if ( (-1 == num_aggregators) && 
-         ((SIMPLE        != OMPIO_MCA_GET(fh, grouping_option) &&
-           NO_REFINEMENT != OMPIO_MCA_GET(fh, grouping_option) &&
-           SIMPLE_PLUS   != OMPIO_MCA_GET(fh, grouping_option) ))) {
+         ((SIMPLE         != OMPIO_MCA_GET(fh, grouping_option) &&
+           NO_REFINEMENT  != OMPIO_MCA_GET(fh, grouping_option) &&
+           SIMPLE_PLUS    != OMPIO_MCA_GET(fh, grouping_option) &&
+           TOPOLOGY_AWARE != OMPIO_MCA_GET(fh, grouping_option) ))) {
         ret = mca_common_ompio_create_groups(fh,bytes_per_proc);
     }
     else {
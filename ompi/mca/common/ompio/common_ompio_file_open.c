@@ -40,6 +40,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "common_ompio.h"
+#include "common_ompio_wbcache.h"
 #include "ompi/mca/topo/topo.h"
 
 static mca_common_ompio_generate_current_file_view_fn_t generate_current_file_view_fn;
@@ -57,6 +58,7 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
 
     ompio_fh->f_iov_type = MPI_DATATYPE_NULL;
     ompio_fh->f_comm     = MPI_COMM_NULL;
+    ompio_fh->f_wb_cache = NULL;
 
     if ( ((amode&MPI_MODE_RDONLY)?1:0) + ((amode&MPI_MODE_RDWR)?1:0) +
 	 ((amode&MPI_MODE_WRONLY)?1:0) != 1 ) {
@@ -183,6 +185,11 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
 	}
     }
 
+    ret = mca_common_ompio_wbcache_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
     /* Set default file view */
     mca_common_ompio_set_view(ompio_fh,
                               0,
@@ -232,12 +239,20 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
 int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
 {
     int ret = OMPI_SUCCESS;
+    int flush_ret;
     int delete_flag = 0;
     char name[256];
 
     /* Call coll_barrier only if collectives are set (same reasoning as below for f_fs) */
     if (NULL == ompio_fh->f_comm || NULL == ompio_fh->f_comm->c_coll) {
-        return OMPI_SUCCESS;
+        return mca_common_ompio_wbcache_fini (ompio_fh);
+    }
+
+    /* Cached data has to be in the file before the other processes
+       return from the close operation */
+    flush_ret = mca_common_ompio_wbcache_fini (ompio_fh);
+    if ( OMPI_SUCCESS != flush_ret ) {
+        opal_output (1,"mca_common_ompio_file_close: error writing cached data\n");
     }
 
     ret = ompio_fh->f_comm->c_coll->coll_barrier ( ompio_fh->f_comm, ompio_fh->f_comm->c_coll->coll_barrier_module);
@@ -377,6 +392,11 @@ int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
         ompi_comm_free (&ompio_fh->f_comm);
     }
 
+    /* losing the cached data is worse than any error above */
+    if ( OMPI_SUCCESS != flush_ret ) {
+        ret = flush_ret;
+    }
+
     return ret;
 }
 
@@ -385,6 +405,10 @@ int mca_common_ompio_file_get_size (ompio_file_t *ompio_fh,
 {
     int ret = OMPI_SUCCESS;
 
+    ret = mca_common_ompio_wbcache_flush (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
     ret = ompio_fh->f_fs->fs_file_get_size (ompio_fh, size);
 
     return ret;
@@ -34,6 +34,7 @@
 #include "common_ompio.h"
 #include "common_ompio_request.h"
 #include "common_ompio_buffer.h"
+#include "common_ompio_wbcache.h"
 #include <unistd.h>
 #include <math.h>
 
@@ -81,6 +82,12 @@ int mca_common_ompio_file_read (ompio_file_t *fh,
       return ret;
     }
 
+    /* Data still in the write-behind cache has to be visible */
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( 0 == count ) {
         if ( MPI_STATUS_IGNORE != status ) {
             status->_ucount = 0;
@@ -245,6 +252,12 @@ int mca_common_ompio_file_iread (ompio_file_t *fh,
       return ret;
     }
 
+    /* Data still in the write-behind cache has to be visible */
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_READ);
 
     if ( 0 == count ) {
@@ -411,6 +424,11 @@ int mca_common_ompio_file_read_all (ompio_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
 
+    /* Data still in the write-behind cache has to be visible */
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
 
     if ( !( fh->f_flags & OMPIO_DATAREP_NATIVE ) &&
          !(datatype == &ompi_mpi_byte.dt  ||
@@ -489,6 +507,12 @@ int mca_common_ompio_file_iread_all (ompio_file_t *fp,
 {
     int ret = OMPI_SUCCESS;
 
+    /* Data still in the write-behind cache has to be visible */
+    ret = mca_common_ompio_wbcache_flush (fp);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( NULL != fp->f_fcoll->fcoll_file_iread_all ) {
 	ret = fp->f_fcoll->fcoll_file_iread_all (fp,
 						 buf,
@@ -32,6 +32,7 @@
 #include "common_ompio.h"
 #include "common_ompio_request.h"
 #include "common_ompio_buffer.h"
+#include "common_ompio_wbcache.h"
 #include <unistd.h>
 #include <math.h>
 
@@ -151,7 +152,12 @@ int mca_common_ompio_file_write (ompio_file_t *fh,
                                           &fh->f_num_of_io_entries);
 
         if (fh->f_num_of_io_entries) {
-            ret_code =fh->f_fbtl->fbtl_pwritev (fh);
+            if ( NULL != fh->f_wb_cache ) {
+                ret_code = mca_common_ompio_wbcache_pwritev (fh);
+            }
+            else {
+                ret_code =fh->f_fbtl->fbtl_pwritev (fh);
+            }
             if ( 0<= ret_code ) {
                 real_bytes_written+= (size_t)ret_code;
             }
@@ -220,7 +226,13 @@ int mca_common_ompio_file_iwrite (ompio_file_t *fh,
         ret = MPI_ERR_READ_ONLY;
       return ret;
     }
-    
+
+    /* Keep the order with respect to the data in the write-behind cache */
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_WRITE);
 
     if ( 0 == count ) {
@@ -387,7 +399,13 @@ int mca_common_ompio_file_write_all (ompio_file_t *fh,
                                      ompi_status_public_t *status)
 {
     int ret = OMPI_SUCCESS;
-    
+
+    /* Keep the order with respect to the data in the write-behind cache */
+    ret = mca_common_ompio_wbcache_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( !( fh->f_flags & OMPIO_DATAREP_NATIVE ) &&
          !(datatype == &ompi_mpi_byte.dt  ||
            datatype == &ompi_mpi_char.dt   )) {
@@ -467,6 +485,12 @@ int mca_common_ompio_file_iwrite_all (ompio_file_t *fp,
 {
     int ret = OMPI_SUCCESS;
 
+    /* Keep the order with respect to the data in the write-behind cache */
+    ret = mca_common_ompio_wbcache_flush (fp);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( NULL != fp->f_fcoll->fcoll_file_iwrite_all ) {
 	ret = fp->f_fcoll->fcoll_file_iwrite_all (fp,
 						  buf,
@@ -0,0 +1,184 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2007 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2021 University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "ompi/mca/fbtl/fbtl.h"
+#include "opal/util/output.h"
+
+#include "common_ompio.h"
+#include "common_ompio_wbcache.h"
+
+int mca_common_ompio_wbcache_init (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *cache;
+    int size;
+
+    fh->f_wb_cache = NULL;
+
+    size = OMPIO_MCA_GET(fh, write_behind_size);
+    if ( 0 >= size || OMPI_ERR_MAX == size || (fh->f_amode & MPI_MODE_RDONLY) ) {
+        return OMPI_SUCCESS;
+    }
+
+    cache = (mca_common_ompio_wbcache_t *) malloc ( sizeof(mca_common_ompio_wbcache_t));
+    if ( NULL == cache ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cache->wb_buf     = (char *) malloc ( size );
+    cache->wb_entries = (mca_common_ompio_io_array_t *) malloc ( OMPIO_WBCACHE_MAX_ENTRIES *
+                                                                 sizeof(mca_common_ompio_io_array_t));
+    if ( NULL == cache->wb_buf || NULL == cache->wb_entries ) {
+        free ( cache->wb_buf );
+        free ( cache->wb_entries );
+        free ( cache );
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cache->wb_size        = (size_t) size;
+    cache->wb_used        = 0;
+    cache->wb_num_entries = 0;
+
+    fh->f_wb_cache = cache;
+    return OMPI_SUCCESS;
+}
+
+int mca_common_ompio_wbcache_fini (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *cache = fh->f_wb_cache;
+    int ret;
+
+    if ( NULL == cache ) {
+        return OMPI_SUCCESS;
+    }
+
+    ret = mca_common_ompio_wbcache_flush (fh);
+
+    free ( cache->wb_buf );
+    free ( cache->wb_entries );
+    free ( cache );
+    fh->f_wb_cache = NULL;
+
+    return ret;
+}
+
+int mca_common_ompio_wbcache_flush (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *cache = fh->f_wb_cache;
+    mca_common_ompio_io_array_t *io_array;
+    int num_of_io_entries;
+    ssize_t ret_code;
+
+    if ( NULL == cache || 0 == cache->wb_num_entries ) {
+        return OMPI_SUCCESS;
+    }
+
+    /* The cache might be flushed in the middle of a write operation,
+       keep the io_array of that operation */
+    io_array          = fh->f_io_array;
+    num_of_io_entries = fh->f_num_of_io_entries;
+
+    fh->f_io_array          = cache->wb_entries;
+    fh->f_num_of_io_entries = cache->wb_num_entries;
+    ret_code = fh->f_fbtl->fbtl_pwritev (fh);
+
+    fh->f_io_array          = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    cache->wb_num_entries = 0;
+    cache->wb_used        = 0;
+
+    if ( 0 > ret_code ) {
+        opal_output (1, "mca_common_ompio_wbcache_flush: error writing cached data of file %s\n",
+                     fh->f_filename);
+        return OMPI_ERROR;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Used instead of fbtl_pwritev for independent writes. Copies the
+ * elements of fh->f_io_array into the cache and returns the number of
+ * bytes accepted, or an error code.
+ */
+ssize_t mca_common_ompio_wbcache_pwritev (ompio_file_t *fh)
+{
+    mca_common_ompio_wbcache_t *cache = fh->f_wb_cache;
+    mca_common_ompio_io_array_t *last;
+    size_t total_bytes = 0;
+    int i;
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        total_bytes += fh->f_io_array[i].length;
+    }
+
+    /* Large operations and operations in atomic mode bypass the cache,
+       after all previously cached data has been written. */
+    if ( fh->f_atomicity || total_bytes > cache->wb_size ||
+         fh->f_num_of_io_entries > OMPIO_WBCACHE_MAX_ENTRIES ) {
+        if ( OMPI_SUCCESS != mca_common_ompio_wbcache_flush (fh) ) {
+            return OMPI_ERROR;
+        }
+        return fh->f_fbtl->fbtl_pwritev (fh);
+    }
+
+    if ( total_bytes > cache->wb_size - cache->wb_used ||
+         fh->f_num_of_io_entries > OMPIO_WBCACHE_MAX_ENTRIES - cache->wb_num_entries ) {
+        if ( OMPI_SUCCESS != mca_common_ompio_wbcache_flush (fh) ) {
+            return OMPI_ERROR;
+        }
+    }
+
+    for ( i = 0; i < fh->f_num_of_io_entries; i++ ) {
+        OMPI_MPI_OFFSET_TYPE offset = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[i].offset;
+        size_t len = fh->f_io_array[i].length;
+
+        if ( 0 < cache->wb_num_entries ) {
+            last = &cache->wb_entries[cache->wb_num_entries - 1];
+            /* The fbtl expects ascending, non-overlapping extents. Write out
+               what we have before accepting data that goes backwards. */
+            if ( offset < (OMPI_MPI_OFFSET_TYPE)(intptr_t) last->offset + (OMPI_MPI_OFFSET_TYPE) last->length ) {
+                if ( OMPI_SUCCESS != mca_common_ompio_wbcache_flush (fh) ) {
+                    return OMPI_ERROR;
+                }
+            }
+        }
+
+        memcpy ( cache->wb_buf + cache->wb_used, fh->f_io_array[i].memory_address, len );
+
+        last = (0 < cache->wb_num_entries) ? &cache->wb_entries[cache->wb_num_entries - 1] : NULL;
+        if ( NULL != last &&
+             (OMPI_MPI_OFFSET_TYPE)(intptr_t) last->offset + (OMPI_MPI_OFFSET_TYPE) last->length == offset ) {
+            /* appended data is also contiguous in wb_buf */
+            last->length += len;
+        }
+        else {
+            cache->wb_entries[cache->wb_num_entries].offset         = fh->f_io_array[i].offset;
+            cache->wb_entries[cache->wb_num_entries].length         = len;
+            cache->wb_entries[cache->wb_num_entries].memory_address = cache->wb_buf + cache->wb_used;
+            cache->wb_num_entries++;
+        }
+        cache->wb_used += len;
+    }
+
+    return (ssize_t) total_bytes;
+}
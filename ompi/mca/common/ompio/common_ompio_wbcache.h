@@ -0,0 +1,54 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2007 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2021 University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COMMON_OMPIO_WBCACHE_H
+#define MCA_COMMON_OMPIO_WBCACHE_H
+
+#include "common_ompio.h"
+
+BEGIN_C_DECLS
+
+/* Maximum number of separate extents kept in the write-behind cache */
+#define OMPIO_WBCACHE_MAX_ENTRIES 1024
+
+/**
+ * Write-behind cache for independent writes. Data of small writes
+ * is copied into wb_buf and written with a single fbtl operation once
+ * the buffer is full, or when the file is synced, closed or accessed in a
+ * way that needs to see the data. The extents are kept sorted by offset
+ * and do not overlap, adjacent extents are merged.
+ */
+struct mca_common_ompio_wbcache_t {
+    char                        *wb_buf;          /* staging buffer */
+    size_t                       wb_size;         /* size of wb_buf */
+    size_t                       wb_used;         /* bytes currently cached */
+    mca_common_ompio_io_array_t *wb_entries;      /* extents, pointing into wb_buf */
+    int                          wb_num_entries;
+};
+typedef struct mca_common_ompio_wbcache_t mca_common_ompio_wbcache_t;
+
+OMPI_DECLSPEC int mca_common_ompio_wbcache_init (ompio_file_t *fh);
+OMPI_DECLSPEC int mca_common_ompio_wbcache_fini (ompio_file_t *fh);
+OMPI_DECLSPEC int mca_common_ompio_wbcache_flush (ompio_file_t *fh);
+OMPI_DECLSPEC ssize_t mca_common_ompio_wbcache_pwritev (ompio_file_t *fh);
+
+END_C_DECLS
+
+#endif /* MCA_COMMON_OMPIO_WBCACHE_H */
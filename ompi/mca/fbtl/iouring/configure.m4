@@ -0,0 +1,45 @@
+# -*- shell-script -*-
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_fbtl_iouring_CONFIG(action-if-can-compile,
+#                        [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_fbtl_iouring_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/fbtl/iouring/Makefile])
+
+    OPAL_VAR_SCOPE_PUSH([fbtl_iouring_happy fbtl_iouring_dir])
+
+    AC_ARG_WITH([liburing],
+        [AS_HELP_STRING([--with-liburing(=DIR)],
+             [Build the io_uring fbtl component, optionally adding DIR/include, DIR/lib, and DIR/lib64 to the search path for headers and libraries])])
+    OPAL_CHECK_WITHDIR([liburing], [$with_liburing], [include/liburing.h])
+
+    AS_IF([test "$with_liburing" = "no"],
+          [fbtl_iouring_happy="no"],
+          [AS_IF([test -n "$with_liburing" && test "$with_liburing" != "yes"],
+                 [fbtl_iouring_dir=$with_liburing])
+
+           OPAL_CHECK_PACKAGE([fbtl_iouring], [liburing.h], [uring], [io_uring_queue_init],
+                              [], [$fbtl_iouring_dir], [],
+                              [fbtl_iouring_happy="yes"],
+                              [fbtl_iouring_happy="no"])])
+
+    AS_IF([test "$fbtl_iouring_happy" = "yes"],
+          [$1],
+          [AS_IF([test -n "$with_liburing" && test "$with_liburing" != "no"],
+                 [AC_MSG_ERROR([io_uring support requested but liburing not found.  Aborting])])
+           $2])
+
+    # substitute in the things needed to build iouring
+    AC_SUBST([fbtl_iouring_CPPFLAGS])
+    AC_SUBST([fbtl_iouring_LDFLAGS])
+    AC_SUBST([fbtl_iouring_LIBS])
+
+    OPAL_VAR_SCOPE_POP
+])dnl
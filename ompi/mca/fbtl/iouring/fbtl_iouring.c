@@ -0,0 +1,591 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/util/output.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+#include "ompi/mca/fbtl/iouring/fbtl_iouring.h"
+
+/* Number of completion queue entries reaped at once */
+#define FBTL_IOURING_REAP_BATCH     64
+/* Size of the registered file table */
+#define FBTL_IOURING_MAX_FIXED_FILES 64
+
+/* Per-file state, created on the first operation on a file */
+struct mca_fbtl_iouring_file_t {
+    int direct_fd;          /* fd opened with O_DIRECT, -1 if not used */
+    int fixed_idx;          /* index of fh->fd in the registered files, or -1 */
+    int direct_fixed_idx;   /* index of direct_fd in the registered files, or -1 */
+};
+typedef struct mca_fbtl_iouring_file_t mca_fbtl_iouring_file_t;
+
+/*
+ * The ring is shared by all files of the process and created when the
+ * first file is queried. All accesses to the ring and to the state below
+ * are protected by mca_fbtl_iouring_lock.
+ */
+static struct io_uring mca_fbtl_iouring_ring;
+static bool mca_fbtl_iouring_ring_initialized = false;
+static bool mca_fbtl_iouring_ring_failed = false;
+static int mca_fbtl_iouring_inflight = 0;
+/* a thread is blocked in io_uring_wait_cqe without holding the lock. It is
+   the only one consuming completions until it is back. */
+static bool mca_fbtl_iouring_waiting = false;
+static opal_mutex_t mca_fbtl_iouring_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_hash_table_t mca_fbtl_iouring_files;
+static int *mca_fbtl_iouring_fixed_fds = NULL;
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_fbtl_base_module_1_0_0_t iouring =  {
+    mca_fbtl_iouring_module_init,     /* initalise after being selected */
+    mca_fbtl_iouring_module_finalize, /* close a module on a communicator */
+    mca_fbtl_iouring_preadv,          /* blocking read */
+    mca_fbtl_iouring_ipreadv,         /* non-blocking read*/
+    mca_fbtl_iouring_pwritev,         /* blocking write */
+    mca_fbtl_iouring_ipwritev,        /* non-blocking write */
+    mca_fbtl_iouring_progress,        /* module specific progress */
+    mca_fbtl_iouring_request_free,    /* free module specific data items on the request */
+    mca_fbtl_base_check_atomicity     /* check whether atomicity is supported on this fs */
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_fbtl_iouring_component_init_query(bool enable_progress_threads,
+                                          bool enable_mpi_threads)
+{
+    /* The ring is only created once a file is opened, see file_query */
+    return OMPI_SUCCESS;
+}
+
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_iouring_component_file_query (ompio_file_t *fh, int *priority)
+{
+    /* The default priority is below the one of fbtl/posix on UFS, the
+       component is only used if requested */
+    *priority = mca_fbtl_iouring_priority;
+
+    /* The component is only usable if the kernel lets us create a ring */
+    if (UFS == fh->f_fstype && OMPI_SUCCESS == mca_fbtl_iouring_ring_init ()) {
+        return &iouring;
+    }
+
+    return NULL;
+}
+
+int mca_fbtl_iouring_component_file_unquery (ompio_file_t *file)
+{
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_fbtl_iouring_module_init (ompio_file_t *file)
+{
+    /* The file is not open yet at this point, the per-file state
+       is set up with the first operation */
+    return OMPI_SUCCESS;
+}
+
+static void iouring_unregister_file (int idx)
+{
+    int fd = -1;
+
+    if (0 > idx) {
+        return;
+    }
+    io_uring_register_files_update (&mca_fbtl_iouring_ring, idx, &fd, 1);
+    mca_fbtl_iouring_fixed_fds[idx] = -1;
+}
+
+int mca_fbtl_iouring_module_finalize (ompio_file_t *file)
+{
+    mca_fbtl_iouring_file_t *ufile = NULL;
+    int ret;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    ret = opal_hash_table_get_value_uint64 (&mca_fbtl_iouring_files,
+                                            (uint64_t)(uintptr_t) file,
+                                            (void **) &ufile);
+    if (OPAL_SUCCESS == ret && NULL != ufile) {
+        opal_hash_table_remove_value_uint64 (&mca_fbtl_iouring_files,
+                                             (uint64_t)(uintptr_t) file);
+        iouring_unregister_file (ufile->fixed_idx);
+        iouring_unregister_file (ufile->direct_fixed_idx);
+        if (0 <= ufile->direct_fd) {
+            close (ufile->direct_fd);
+        }
+        free (ufile);
+    }
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    return OMPI_SUCCESS;
+}
+
+int mca_fbtl_iouring_ring_init (void)
+{
+    int i, ret;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    if (mca_fbtl_iouring_ring_initialized || mca_fbtl_iouring_ring_failed) {
+        ret = mca_fbtl_iouring_ring_initialized ? OMPI_SUCCESS : OMPI_ERR_NOT_AVAILABLE;
+        OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+        return ret;
+    }
+
+    if (0 >= mca_fbtl_iouring_queue_depth) {
+        mca_fbtl_iouring_queue_depth = FBTL_IOURING_QUEUE_DEPTH;
+    }
+    if (0 == mca_fbtl_iouring_direct_alignment ||
+        0 != (mca_fbtl_iouring_direct_alignment & (mca_fbtl_iouring_direct_alignment - 1))) {
+        opal_output_verbose (10, ompi_fbtl_base_framework.framework_output,
+                             "fbtl_iouring: direct_alignment %lu is not a power of two, O_DIRECT disabled",
+                             (unsigned long) mca_fbtl_iouring_direct_alignment);
+        mca_fbtl_iouring_use_direct = false;
+    }
+
+    ret = io_uring_queue_init (mca_fbtl_iouring_queue_depth, &mca_fbtl_iouring_ring, 0);
+    if (0 > ret) {
+        opal_output_verbose (10, ompi_fbtl_base_framework.framework_output,
+                             "fbtl_iouring: io_uring_queue_init failed: %s", strerror(-ret));
+        mca_fbtl_iouring_ring_failed = true;
+        OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    OBJ_CONSTRUCT(&mca_fbtl_iouring_files, opal_hash_table_t);
+    opal_hash_table_init (&mca_fbtl_iouring_files, 32);
+
+    if (mca_fbtl_iouring_register_files) {
+        mca_fbtl_iouring_fixed_fds = (int *) malloc (FBTL_IOURING_MAX_FIXED_FILES * sizeof(int));
+        if (NULL != mca_fbtl_iouring_fixed_fds) {
+            for (i = 0; i < FBTL_IOURING_MAX_FIXED_FILES; i++) {
+                mca_fbtl_iouring_fixed_fds[i] = -1;
+            }
+            /* Sparse file tables are not supported by older kernels,
+               operations use the regular file descriptors in that case */
+            if (0 > io_uring_register_files (&mca_fbtl_iouring_ring, mca_fbtl_iouring_fixed_fds,
+                                             FBTL_IOURING_MAX_FIXED_FILES)) {
+                free (mca_fbtl_iouring_fixed_fds);
+                mca_fbtl_iouring_fixed_fds = NULL;
+            }
+        }
+    }
+
+    mca_fbtl_iouring_inflight = 0;
+    mca_fbtl_iouring_ring_initialized = true;
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+    return OMPI_SUCCESS;
+}
+
+void mca_fbtl_iouring_ring_fini (void)
+{
+    if (!mca_fbtl_iouring_ring_initialized) {
+        return;
+    }
+
+    if (NULL != mca_fbtl_iouring_fixed_fds) {
+        io_uring_unregister_files (&mca_fbtl_iouring_ring);
+        free (mca_fbtl_iouring_fixed_fds);
+        mca_fbtl_iouring_fixed_fds = NULL;
+    }
+    io_uring_queue_exit (&mca_fbtl_iouring_ring);
+
+    OBJ_DESTRUCT(&mca_fbtl_iouring_files);
+    mca_fbtl_iouring_ring_initialized = false;
+}
+
+/* Must be called with mca_fbtl_iouring_lock held */
+static int iouring_register_file (int fd)
+{
+    int i;
+
+    if (NULL == mca_fbtl_iouring_fixed_fds || 0 > fd) {
+        return -1;
+    }
+    for (i = 0; i < FBTL_IOURING_MAX_FIXED_FILES; i++) {
+        if (-1 == mca_fbtl_iouring_fixed_fds[i]) {
+            if (1 != io_uring_register_files_update (&mca_fbtl_iouring_ring, i, &fd, 1)) {
+                return -1;
+            }
+            mca_fbtl_iouring_fixed_fds[i] = fd;
+            return i;
+        }
+    }
+
+    /* table is full */
+    return -1;
+}
+
+/* Must be called with mca_fbtl_iouring_lock held */
+static mca_fbtl_iouring_file_t *iouring_get_file (ompio_file_t *fh)
+{
+    mca_fbtl_iouring_file_t *ufile = NULL;
+    int ret;
+
+    ret = opal_hash_table_get_value_uint64 (&mca_fbtl_iouring_files,
+                                            (uint64_t)(uintptr_t) fh,
+                                            (void **) &ufile);
+    if (OPAL_SUCCESS == ret) {
+        return ufile;
+    }
+
+    ufile = (mca_fbtl_iouring_file_t *) malloc (sizeof(mca_fbtl_iouring_file_t));
+    if (NULL == ufile) {
+        return NULL;
+    }
+    ufile->direct_fd        = -1;
+    ufile->fixed_idx        = -1;
+    ufile->direct_fixed_idx = -1;
+
+#if defined(O_DIRECT)
+    if (mca_fbtl_iouring_use_direct && NULL != fh->f_filename) {
+        int flags = fcntl (fh->fd, F_GETFL);
+        if (-1 != flags) {
+            ufile->direct_fd = open (fh->f_filename, (flags & O_ACCMODE) | O_DIRECT);
+            if (0 > ufile->direct_fd) {
+                opal_output_verbose (10, ompi_fbtl_base_framework.framework_output,
+                                     "fbtl_iouring: could not open %s with O_DIRECT: %s",
+                                     fh->f_filename, strerror(errno));
+            }
+        }
+    }
+#endif
+
+    ufile->fixed_idx        = iouring_register_file (fh->fd);
+    ufile->direct_fixed_idx = iouring_register_file (ufile->direct_fd);
+
+    opal_hash_table_set_value_uint64 (&mca_fbtl_iouring_files,
+                                      (uint64_t)(uintptr_t) fh, ufile);
+    return ufile;
+}
+
+static inline bool iouring_is_aligned (mca_fbtl_iouring_entry_t *entry)
+{
+    size_t align = mca_fbtl_iouring_direct_alignment;
+
+    return 0 == (((uintptr_t) entry->ur_iov.iov_base | (uintptr_t) entry->ur_offset |
+                  (uintptr_t) entry->ur_iov.iov_len) & (align - 1));
+}
+
+int mca_fbtl_iouring_request_setup (ompio_file_t *fh, int type,
+                                    mca_fbtl_iouring_request_data_t **data_out)
+{
+    mca_fbtl_iouring_request_data_t *data;
+    mca_fbtl_iouring_file_t *ufile;
+    off_t start_offset, end_offset;
+    int i;
+
+    data = (mca_fbtl_iouring_request_data_t *) malloc (sizeof(mca_fbtl_iouring_request_data_t));
+    if (NULL == data) {
+        opal_output (1, "mca_fbtl_iouring_request_setup: could not allocate memory\n");
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    data->ur_entries = (mca_fbtl_iouring_entry_t *) malloc (fh->f_num_of_io_entries *
+                                                            sizeof(mca_fbtl_iouring_entry_t));
+    if (NULL == data->ur_entries) {
+        opal_output (1, "mca_fbtl_iouring_request_setup: could not allocate memory\n");
+        free (data);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    data->ur_req_count = fh->f_num_of_io_entries;
+    data->ur_next_req  = 0;
+    data->ur_open_reqs = 0;
+    data->ur_req_type  = type;
+    data->ur_error     = 0;
+    data->ur_total_len = 0;
+    data->ur_locked    = false;
+    data->ur_fh        = fh;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    ufile = iouring_get_file (fh);
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    start_offset = (off_t)fh->f_io_array[0].offset;
+    end_offset   = start_offset;
+    for (i = 0; i < fh->f_num_of_io_entries; i++) {
+        mca_fbtl_iouring_entry_t *entry = &data->ur_entries[i];
+
+        entry->ur_iov.iov_base = fh->f_io_array[i].memory_address;
+        entry->ur_iov.iov_len  = fh->f_io_array[i].length;
+        entry->ur_offset       = (off_t)fh->f_io_array[i].offset;
+        entry->ur_data         = data;
+        entry->ur_fd           = fh->fd;
+        entry->ur_fixed        = false;
+        entry->ur_direct       = false;
+        entry->ur_redo         = 0;
+
+        if (NULL != ufile) {
+            if (0 <= ufile->direct_fd && iouring_is_aligned (entry)) {
+                entry->ur_direct = true;
+                if (0 <= ufile->direct_fixed_idx) {
+                    entry->ur_fd    = ufile->direct_fixed_idx;
+                    entry->ur_fixed = true;
+                }
+                else {
+                    entry->ur_fd = ufile->direct_fd;
+                }
+            }
+            else if (0 <= ufile->fixed_idx) {
+                entry->ur_fd    = ufile->fixed_idx;
+                entry->ur_fixed = true;
+            }
+        }
+
+        if (entry->ur_offset < start_offset) {
+            start_offset = entry->ur_offset;
+        }
+        if ((off_t)(entry->ur_offset + entry->ur_iov.iov_len) > end_offset) {
+            end_offset = entry->ur_offset + entry->ur_iov.iov_len;
+        }
+    }
+
+    /* The ring does not know about file locks, lock the entire region
+       touched by this operation for the file systems requiring it. */
+    if (!(fh->f_flags & OMPIO_LOCK_NEVER) &&
+        (fh->f_atomicity || (fh->f_flags & OMPIO_LOCK_ENTIRE_FILE))) {
+        data->ur_lock.l_type   = (FBTL_IOURING_WRITE == type) ? F_WRLCK : F_RDLCK;
+        data->ur_lock.l_whence = SEEK_SET;
+        data->ur_lock.l_start  = start_offset;
+        data->ur_lock.l_len    = end_offset - start_offset;
+        data->ur_lock.l_pid    = 0;
+        if (fh->f_flags & OMPIO_LOCK_ENTIRE_FILE) {
+            data->ur_lock.l_start = 0;
+            data->ur_lock.l_len   = 0;
+        }
+        if (-1 == fcntl (fh->fd, F_SETLKW, &data->ur_lock)) {
+            opal_output(1, "mca_fbtl_iouring_request_setup: error in fcntl(F_SETLKW): %s",
+                        strerror(errno));
+            free (data->ur_entries);
+            free (data);
+            return OMPI_ERROR;
+        }
+        data->ur_locked = true;
+    }
+
+    *data_out = data;
+    return OMPI_SUCCESS;
+}
+
+static void iouring_unlock (mca_fbtl_iouring_request_data_t *data)
+{
+    if (data->ur_locked) {
+        data->ur_lock.l_type = F_UNLCK;
+        fcntl (data->ur_fh->fd, F_SETLK, &data->ur_lock);
+        data->ur_locked = false;
+    }
+}
+
+void mca_fbtl_iouring_request_release (mca_fbtl_iouring_request_data_t *data)
+{
+    if (NULL == data) {
+        return;
+    }
+    iouring_unlock (data);
+    free (data->ur_entries);
+    free (data);
+}
+
+/* Must be called with mca_fbtl_iouring_lock held */
+static bool iouring_queue_entry (mca_fbtl_iouring_entry_t *entry)
+{
+    struct io_uring_sqe *sqe;
+
+    sqe = io_uring_get_sqe (&mca_fbtl_iouring_ring);
+    if (NULL == sqe) {
+        return false;
+    }
+    if (FBTL_IOURING_READ == entry->ur_data->ur_req_type) {
+        io_uring_prep_readv (sqe, entry->ur_fd, &entry->ur_iov, 1, entry->ur_offset);
+    }
+    else {
+        io_uring_prep_writev (sqe, entry->ur_fd, &entry->ur_iov, 1, entry->ur_offset);
+    }
+    if (entry->ur_fixed) {
+        io_uring_sqe_set_flags (sqe, IOSQE_FIXED_FILE);
+    }
+    io_uring_sqe_set_data (sqe, entry);
+    mca_fbtl_iouring_inflight++;
+
+    return true;
+}
+
+/* Must be called with mca_fbtl_iouring_lock held. Queues as many not yet
+   submitted elements of the request as the ring allows. */
+static int iouring_queue_pending (mca_fbtl_iouring_request_data_t *data)
+{
+    int queued = 0;
+
+    while (0 == data->ur_error &&
+           data->ur_next_req < data->ur_req_count &&
+           mca_fbtl_iouring_inflight < mca_fbtl_iouring_queue_depth) {
+        if (!iouring_queue_entry (&data->ur_entries[data->ur_next_req])) {
+            break;
+        }
+        data->ur_next_req++;
+        data->ur_open_reqs++;
+        queued++;
+    }
+
+    return queued;
+}
+
+/* Must be called with mca_fbtl_iouring_lock held. Reaps a batch of
+   completions of any request using the ring. Returns the number of
+   completions processed. */
+static int iouring_reap (void)
+{
+    struct io_uring_cqe *cqes[FBTL_IOURING_REAP_BATCH];
+    unsigned i, count;
+    int requeued = 0;
+
+    count = io_uring_peek_batch_cqe (&mca_fbtl_iouring_ring, cqes, FBTL_IOURING_REAP_BATCH);
+    for (i = 0; i < count; i++) {
+        mca_fbtl_iouring_entry_t *entry = (mca_fbtl_iouring_entry_t *) io_uring_cqe_get_data (cqes[i]);
+        mca_fbtl_iouring_request_data_t *data = entry->ur_data;
+        int res = cqes[i]->res;
+
+        mca_fbtl_iouring_inflight--;
+        if (0 > res) {
+            if ((-EAGAIN == res || -EINTR == res) && iouring_queue_entry (entry)) {
+                requeued++;
+                continue;
+            }
+            if (0 == data->ur_error) {
+                data->ur_error = -res;
+            }
+            data->ur_open_reqs--;
+            continue;
+        }
+
+        if ((size_t)res <= entry->ur_redo) {
+            /* nothing new after a realignment: end of file for reads */
+            if (0 < res && FBTL_IOURING_WRITE == data->ur_req_type && 0 == data->ur_error) {
+                data->ur_error = EIO;
+            }
+            data->ur_open_reqs--;
+            continue;
+        }
+        data->ur_total_len += res - entry->ur_redo;
+        entry->ur_redo = 0;
+        if ((size_t)res < entry->ur_iov.iov_len) {
+            /* Partial completion, continue with the remainder */
+            entry->ur_iov.iov_base = (char *) entry->ur_iov.iov_base + res;
+            entry->ur_iov.iov_len -= res;
+            entry->ur_offset      += res;
+            if (entry->ur_direct) {
+                /* The element started and ends aligned, so backing up to
+                   the previous aligned offset makes the remainder aligned
+                   again. The bytes in between are transferred twice, but
+                   the range never mixes direct and buffered I/O. */
+                size_t head = (size_t) entry->ur_offset & (mca_fbtl_iouring_direct_alignment - 1);
+                entry->ur_iov.iov_base = (char *) entry->ur_iov.iov_base - head;
+                entry->ur_iov.iov_len += head;
+                entry->ur_offset      -= head;
+                entry->ur_redo         = head;
+            }
+            if (iouring_queue_entry (entry)) {
+                requeued++;
+                continue;
+            }
+            if (0 == data->ur_error) {
+                data->ur_error = EAGAIN;
+            }
+        }
+        /* complete, or end of file for reads */
+        data->ur_open_reqs--;
+    }
+    if (0 < count) {
+        io_uring_cq_advance (&mca_fbtl_iouring_ring, count);
+    }
+    if (0 < requeued) {
+        io_uring_submit (&mca_fbtl_iouring_ring);
+    }
+
+    return (int) count;
+}
+
+bool mca_fbtl_iouring_request_test (mca_fbtl_iouring_request_data_t *data, bool blocking)
+{
+    struct io_uring_cqe *cqe;
+    bool done;
+    int ret;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+    if (0 < iouring_queue_pending (data)) {
+        io_uring_submit (&mca_fbtl_iouring_ring);
+    }
+    /* Completions are left to the waiting thread. Reaping them here could
+       leave it blocked in the kernel with its own operations finished. */
+    if (!mca_fbtl_iouring_waiting && 0 == iouring_reap () &&
+        blocking && 0 < data->ur_open_reqs) {
+        mca_fbtl_iouring_waiting = true;
+        OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+        ret = io_uring_wait_cqe (&mca_fbtl_iouring_ring, &cqe);
+        OPAL_THREAD_LOCK(&mca_fbtl_iouring_lock);
+        mca_fbtl_iouring_waiting = false;
+        if (0 == ret) {
+            iouring_reap ();
+        }
+    }
+    done = (0 == data->ur_open_reqs) &&
+        (0 != data->ur_error || data->ur_next_req == data->ur_req_count);
+    OPAL_THREAD_UNLOCK(&mca_fbtl_iouring_lock);
+
+    if (done) {
+        iouring_unlock (data);
+    }
+    return done;
+}
+
+bool mca_fbtl_iouring_progress ( mca_ompio_request_t *req)
+{
+    mca_fbtl_iouring_request_data_t *data = (mca_fbtl_iouring_request_data_t *) req->req_data;
+
+    if (!mca_fbtl_iouring_request_test (data, false)) {
+        return false;
+    }
+
+    if (0 != data->ur_error) {
+        opal_output(1, "mca_fbtl_iouring_progress: error in %s: %s",
+                    (FBTL_IOURING_READ == data->ur_req_type) ? "read" : "write",
+                    strerror(data->ur_error));
+        req->req_ompi.req_status.MPI_ERROR = OMPI_ERROR;
+    }
+    else {
+        req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
+    }
+    req->req_ompi.req_status._ucount = data->ur_total_len;
+    return true;
+}
+
+void mca_fbtl_iouring_request_free ( mca_ompio_request_t *req)
+{
+    /* Free the fbtl specific data structures */
+    mca_fbtl_iouring_request_release ((mca_fbtl_iouring_request_data_t *) req->req_data);
+    req->req_data = NULL;
+}
@@ -0,0 +1,109 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_FBTL_IOURING_H
+#define MCA_FBTL_IOURING_H
+
+#include "ompi_config.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <liburing.h>
+
+#include "ompi/mca/mca.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
+
+extern int mca_fbtl_iouring_priority;
+extern int mca_fbtl_iouring_queue_depth;
+extern bool mca_fbtl_iouring_use_direct;
+extern size_t mca_fbtl_iouring_direct_alignment;
+extern bool mca_fbtl_iouring_register_files;
+
+#define FBTL_IOURING_BASE_PRIORITY      10
+#define FBTL_IOURING_QUEUE_DEPTH        256
+
+BEGIN_C_DECLS
+
+int mca_fbtl_iouring_component_init_query(bool enable_progress_threads,
+                                          bool enable_mpi_threads);
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_iouring_component_file_query (ompio_file_t *file, int *priority);
+int mca_fbtl_iouring_component_file_unquery (ompio_file_t *file);
+
+int mca_fbtl_iouring_module_init (ompio_file_t *file);
+int mca_fbtl_iouring_module_finalize (ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_iouring_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+
+ssize_t mca_fbtl_iouring_preadv (ompio_file_t *file );
+ssize_t mca_fbtl_iouring_pwritev (ompio_file_t *file );
+ssize_t mca_fbtl_iouring_ipreadv (ompio_file_t *file,
+                                  ompi_request_t *request);
+ssize_t mca_fbtl_iouring_ipwritev (ompio_file_t *file,
+                                   ompi_request_t *request);
+
+bool mca_fbtl_iouring_progress     ( mca_ompio_request_t *req);
+void mca_fbtl_iouring_request_free ( mca_ompio_request_t *req);
+
+struct mca_fbtl_iouring_request_data_t;
+
+/* One element of f_io_array. The address of the entry is used as
+   user_data of its submission queue entry. */
+struct mca_fbtl_iouring_entry_t {
+    struct iovec   ur_iov;             /* remaining part of the element */
+    off_t          ur_offset;          /* file offset of ur_iov */
+    int            ur_fd;              /* fd (or fixed file index) used for this element */
+    bool           ur_fixed;           /* ur_fd is an index into the registered files */
+    bool           ur_direct;          /* ur_fd was opened with O_DIRECT */
+    size_t         ur_redo;            /* bytes at the start of ur_iov already transferred */
+    struct mca_fbtl_iouring_request_data_t *ur_data;
+};
+typedef struct mca_fbtl_iouring_entry_t mca_fbtl_iouring_entry_t;
+
+struct mca_fbtl_iouring_request_data_t {
+    int            ur_req_count;       /* total number of elements */
+    int            ur_next_req;        /* first element not submitted yet */
+    int            ur_open_reqs;       /* number of submitted, unfinished elements */
+    int            ur_req_type;        /* read or write */
+    int            ur_error;           /* first error reported by the kernel */
+    ssize_t        ur_total_len;       /* total amount of data read/written */
+    bool           ur_locked;          /* ur_lock is held on the file */
+    struct flock   ur_lock;            /* lock used for certain file systems */
+    ompio_file_t  *ur_fh;              /* pointer back to the file handle */
+    mca_fbtl_iouring_entry_t *ur_entries;
+};
+typedef struct mca_fbtl_iouring_request_data_t mca_fbtl_iouring_request_data_t;
+
+/* define constants for read/write operations */
+#define FBTL_IOURING_READ  1
+#define FBTL_IOURING_WRITE 2
+
+/* Internal interface shared by the blocking and non-blocking operations */
+int  mca_fbtl_iouring_ring_init (void);
+void mca_fbtl_iouring_ring_fini (void);
+int  mca_fbtl_iouring_request_setup (ompio_file_t *fh, int type,
+                                     mca_fbtl_iouring_request_data_t **data);
+void mca_fbtl_iouring_request_release (mca_fbtl_iouring_request_data_t *data);
+bool mca_fbtl_iouring_request_test (mca_fbtl_iouring_request_data_t *data, bool blocking);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_FBTL_IOURING_H */
@@ -0,0 +1,61 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_iouring.h"
+
+#include <string.h>
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+static ssize_t mca_fbtl_iouring_blocking_op (ompio_file_t *fh, int type)
+{
+    mca_fbtl_iouring_request_data_t *data = NULL;
+    ssize_t bytes;
+    int ret;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+    if (0 == fh->f_num_of_io_entries) {
+        return 0;
+    }
+
+    ret = mca_fbtl_iouring_request_setup (fh, type, &data);
+    if (OMPI_SUCCESS != ret) {
+        return OMPI_ERROR;
+    }
+
+    while (!mca_fbtl_iouring_request_test (data, true)) {
+        ;
+    }
+
+    if (0 != data->ur_error) {
+        opal_output(1, "mca_fbtl_iouring_%s: error in io_uring operation: %s",
+                    (FBTL_IOURING_READ == type) ? "preadv" : "pwritev",
+                    strerror(data->ur_error));
+        bytes = OMPI_ERROR;
+    }
+    else {
+        bytes = data->ur_total_len;
+    }
+    mca_fbtl_iouring_request_release (data);
+
+    return bytes;
+}
+
+ssize_t mca_fbtl_iouring_preadv (ompio_file_t *fh)
+{
+    return mca_fbtl_iouring_blocking_op (fh, FBTL_IOURING_READ);
+}
+
+ssize_t mca_fbtl_iouring_pwritev (ompio_file_t *fh)
+{
+    return mca_fbtl_iouring_blocking_op (fh, FBTL_IOURING_WRITE);
+}
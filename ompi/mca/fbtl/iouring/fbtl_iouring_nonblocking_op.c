@@ -0,0 +1,58 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_iouring.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+static ssize_t mca_fbtl_iouring_nonblocking_op (ompio_file_t *fh,
+                                                ompi_request_t *request,
+                                                int type)
+{
+    mca_fbtl_iouring_request_data_t *data = NULL;
+    mca_ompio_request_t *req = (mca_ompio_request_t *) request;
+    int ret;
+
+    if (0 == fh->f_num_of_io_entries) {
+        req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
+        req->req_ompi.req_status._ucount = 0;
+        ompi_request_complete (&req->req_ompi, false);
+        return OMPI_SUCCESS;
+    }
+
+    ret = mca_fbtl_iouring_request_setup (fh, type, &data);
+    if (OMPI_SUCCESS != ret) {
+        return OMPI_ERROR;
+    }
+
+    /* The elements are copied, f_io_array can be released by the caller.
+       Submit the first batch right away, the remaining elements and the
+       completions are handled from the progress function. */
+    mca_fbtl_iouring_request_test (data, false);
+
+    req->req_data = data;
+    req->req_progress_fn = mca_fbtl_iouring_progress;
+    req->req_free_fn     = mca_fbtl_iouring_request_free;
+
+    return OMPI_SUCCESS;
+}
+
+ssize_t mca_fbtl_iouring_ipreadv (ompio_file_t *fh,
+                                  ompi_request_t *request)
+{
+    return mca_fbtl_iouring_nonblocking_op (fh, request, FBTL_IOURING_READ);
+}
+
+ssize_t mca_fbtl_iouring_ipwritev (ompio_file_t *fh,
+                                   ompi_request_t *request)
+{
+    return mca_fbtl_iouring_nonblocking_op (fh, request, FBTL_IOURING_WRITE);
+}
@@ -44,6 +44,7 @@ int mca_fcoll_vulcan_priority = 10;
 int mca_fcoll_vulcan_num_groups = 1;
 int mca_fcoll_vulcan_write_chunksize = -1;
 int mca_fcoll_vulcan_async_io = 0;
+int mca_fcoll_vulcan_read_buffers = 2;
 
 /*
  * Local function
@@ -111,5 +112,14 @@ vulcan_register(void)
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_vulcan_async_io);
 
+    mca_fcoll_vulcan_read_buffers = 2;
+    (void) mca_base_component_var_register(&mca_fcoll_vulcan_component.fcollm_version,
+                                           "read_buffers", "Number of buffers used by the aggregators to read ahead "
+                                           "in collective read operations when asynchronous I/O is used (minimum 2, default 2). "
+                                           "The collective buffer is split evenly among them.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_vulcan_read_buffers);
+
     return OMPI_SUCCESS;
 }
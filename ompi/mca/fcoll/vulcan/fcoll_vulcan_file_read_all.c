@@ -28,6 +28,7 @@
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
 #include "ompi/mca/io/io.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
 #include <unistd.h>
@@ -42,10 +43,26 @@ typedef struct mca_io_ompio_local_io_array{
 }mca_io_ompio_local_io_array;
 
 
+/*Per-cycle state of the read pipeline*/
+typedef struct mca_io_ompio_read_cycle_data {
+    char                *global_buf;
+    int                 *disp_index;
+    int                **blocklen_per_process;
+    MPI_Aint           **displs_per_process;
+    ompi_datatype_t    **sendtype;
+    MPI_Request         *send_req;
+    ompi_request_t      *read_req;
+    int                  entries_per_aggregator;
+    int                  bytes_received;
+} mca_io_ompio_read_cycle_data;
+
+
 static int read_heap_sort (mca_io_ompio_local_io_array *io_array,
                            int num_entries,
                            int *sorted);
 
+static int read_init (ompio_file_t *fh, int read_synchType, ompi_request_t **request);
+
 
 
 int
@@ -64,8 +81,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     int n=0; /* current position in total_bytes_per_process array */
     MPI_Aint bytes_remaining = 0; /* how many bytes have been read from the current
                                      value from total_bytes_per_process */
-    int *sorted_file_offsets=NULL, entries_per_aggregator=0;
-    int bytes_received = 0;
+    int *sorted_file_offsets=NULL;
     int blocks = 0;
     /* iovec structure and count of the buffer passed in */
     uint32_t iov_count = 0;
@@ -78,11 +94,8 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
        file_set_view */
     uint32_t total_fview_count = 0;
     int local_count = 0;
-    int *fview_count = NULL, *disp_index=NULL, *temp_disp_index=NULL;
+    int *fview_count = NULL, *temp_disp_index=NULL;
     int current_index=0, temp_index=0;
-    int **blocklen_per_process=NULL;
-    MPI_Aint **displs_per_process=NULL;
-    char *global_buf = NULL;
     MPI_Aint global_count = 0;
     mca_io_ompio_local_io_array *file_offsets_for_agg=NULL;
 
@@ -92,11 +105,14 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     int vulcan_num_io_procs;
     size_t max_data = 0;
     MPI_Aint *total_bytes_per_process = NULL;
-    ompi_datatype_t **sendtype = NULL;
-    MPI_Request *send_req = NULL;
     MPI_Request recv_req = MPI_REQUEST_NULL;
     int my_aggregator =-1;
 
+    /* read pipeline: cycle next_cycle-1 is the last one that was started */
+    mca_io_ompio_read_cycle_data *cycle_data = NULL, *cur = NULL;
+    int num_buffers = 1, next_cycle = 0, b = 0;
+    int read_synch_type = 2;
+
     int* blocklength_proc       = NULL;
     ptrdiff_t* displs_proc      = NULL;
 
@@ -132,6 +148,12 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
         goto exit;
     }
 
+    if( (1 == mca_fcoll_vulcan_async_io) && (NULL == fh->f_fbtl->fbtl_ipreadv) ) {
+        opal_output (1, "vulcan_read_all: fbtl Does NOT support ipreadv() (asynchrounous read) \n");
+        ret = MPI_ERR_UNSUPPORTED_OPERATION;
+        goto exit;
+    }
+
     ret = mca_common_ompio_set_aggregator_props ((struct ompio_file_t *) fh,
                                                  vulcan_num_io_procs,
                                                  max_data);
@@ -322,61 +344,93 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
      *************************************************************/
     bytes_per_cycle = fh->f_bytes_per_agg;
     cycles = ceil((double)total_bytes/bytes_per_cycle);
+    /* As in write_all, the pipeline is only chosen automatically if there
+       are enough cycles to overlap */
+    if ( (1 == mca_fcoll_vulcan_async_io) ||
+         ((0 == mca_fcoll_vulcan_async_io) && (NULL != fh->f_fbtl->fbtl_ipreadv) && (2 < cycles)) ) {
+        /* Cycle N+1 is read while the data of cycle N is scattered. The
+           collective buffer is split among the buffers of the pipeline. */
+        read_synch_type = 1;
+        num_buffers = mca_fcoll_vulcan_read_buffers;
+        if ( 2 > num_buffers ) {
+            num_buffers = 2;
+        }
+        /* each buffer holds at least one byte */
+        if ( num_buffers > bytes_per_cycle ) {
+            num_buffers = (int) bytes_per_cycle;
+        }
+        bytes_per_cycle = bytes_per_cycle / num_buffers;
+        cycles = ceil((double)total_bytes/bytes_per_cycle);
+    }
+
+    cycle_data = (mca_io_ompio_read_cycle_data *) calloc (num_buffers, sizeof(mca_io_ompio_read_cycle_data));
+    if (NULL == cycle_data) {
+        opal_output (1, "OUT OF MEMORY\n");
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+    for (b=0; b<num_buffers; b++) {
+        cycle_data[b].read_req = MPI_REQUEST_NULL;
+    }
 
     if ( my_aggregator == fh->f_rank) {
-      disp_index = (int *)malloc (fh->f_procs_per_group * sizeof (int));
-      if (NULL == disp_index) {
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
-        }
+        for (b=0; b<num_buffers; b++) {
+            cur = &cycle_data[b];
 
-        blocklen_per_process = (int **)malloc (fh->f_procs_per_group * sizeof (int*));
-        if (NULL == blocklen_per_process) {
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
-        }
+            cur->disp_index = (int *)malloc (fh->f_procs_per_group * sizeof (int));
+            if (NULL == cur->disp_index) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
-        displs_per_process = (MPI_Aint **)malloc (fh->f_procs_per_group * sizeof (MPI_Aint*));
-        if (NULL == displs_per_process){
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
-        }
+            cur->blocklen_per_process = (int **)calloc (fh->f_procs_per_group, sizeof (int*));
+            if (NULL == cur->blocklen_per_process) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
-        for (i=0;i<fh->f_procs_per_group;i++){
-            blocklen_per_process[i] = NULL;
-            displs_per_process[i] = NULL;
-        }
+            cur->displs_per_process = (MPI_Aint **)calloc (fh->f_procs_per_group, sizeof (MPI_Aint*));
+            if (NULL == cur->displs_per_process){
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
-	send_req = (MPI_Request *) malloc (fh->f_procs_per_group * sizeof(MPI_Request));
-	if (NULL == send_req){
-	    opal_output ( 1, "OUT OF MEMORY\n");
-	    ret = OMPI_ERR_OUT_OF_RESOURCE;
-	    goto exit;
-	}
-
-	global_buf = (char *) malloc (bytes_per_cycle);
-	if (NULL == global_buf){
-	    opal_output(1, "OUT OF MEMORY\n");
-	    ret = OMPI_ERR_OUT_OF_RESOURCE;
-	    goto exit;
-	}
-
-	sendtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group * sizeof(ompi_datatype_t *));
-	if (NULL == sendtype) {
-            opal_output (1, "OUT OF MEMORY\n");
-	    ret = OMPI_ERR_OUT_OF_RESOURCE;
-	    goto exit;
-	}
+            cur->send_req = (MPI_Request *) malloc (fh->f_procs_per_group * sizeof(MPI_Request));
+            if (NULL == cur->send_req){
+                opal_output ( 1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+            for(l=0;l<fh->f_procs_per_group;l++){
+                cur->send_req[l] = MPI_REQUEST_NULL;
+            }
 
-	for(l=0;l<fh->f_procs_per_group;l++){
-            sendtype[l] = MPI_DATATYPE_NULL;
-	}
-    }
+            cur->global_buf = (char *) malloc (bytes_per_cycle);
+            if (NULL == cur->global_buf){
+                opal_output(1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
+            cur->sendtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group * sizeof(ompi_datatype_t *));
+            if (NULL == cur->sendtype) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+            for(l=0;l<fh->f_procs_per_group;l++){
+                cur->sendtype[l] = MPI_DATATYPE_NULL;
+            }
+        }
 
+        if ( 1 == read_synch_type && cycles > 0 ) {
+            // Register progress function that should be used by ompi_request_wait
+            mca_common_ompio_register_progress ();
+        }
+    }
 
 
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
@@ -385,264 +439,273 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
     n = 0;
     bytes_remaining = 0;
     current_index = 0;
+    next_cycle = 0;
 
     for (index = 0; index < cycles; index++) {
         /**********************************************************************
-         ***  7a. Getting ready for next cycle: initializing and freeing buffers
-	 **********************************************************************/
-        if (my_aggregator == fh->f_rank) {
-             if (NULL != fh->f_io_array) {
-                free (fh->f_io_array);
-                fh->f_io_array = NULL;
-            }
-            fh->f_num_of_io_entries = 0;
-
-            if (NULL != sendtype){
+         ***  7. Prepare and start reading all cycles that fit into the
+         ***     pipeline. With a single buffer this is just the current cycle,
+         ***     otherwise the next cycles are read ahead while the data of
+         ***     the current one is scattered.
+         **********************************************************************/
+        for ( ; next_cycle < cycles && next_cycle < index + num_buffers; next_cycle++ ) {
+            cur = &cycle_data[next_cycle % num_buffers];
+
+            /**********************************************************************
+             ***  7a. Getting ready for next cycle: initializing and freeing buffers
+             **********************************************************************/
+            if (my_aggregator == fh->f_rank) {
                 for (i =0; i< fh->f_procs_per_group; i++) {
-		    if ( MPI_DATATYPE_NULL != sendtype[i] ) {
-                        ompi_datatype_destroy(&sendtype[i]);
-                        sendtype[i] = MPI_DATATYPE_NULL;
+                    if ( MPI_DATATYPE_NULL != cur->sendtype[i] ) {
+                        ompi_datatype_destroy(&cur->sendtype[i]);
+                        cur->sendtype[i] = MPI_DATATYPE_NULL;
                     }
-		}
-            }
+                }
 
-            for(l=0;l<fh->f_procs_per_group;l++){
-                disp_index[l] =  1;
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    cur->disp_index[l] =  1;
 
-                if (NULL != blocklen_per_process[l]){
-                    free(blocklen_per_process[l]);
-                    blocklen_per_process[l] = NULL;
+                    if (NULL != cur->blocklen_per_process[l]){
+                        free(cur->blocklen_per_process[l]);
+                        cur->blocklen_per_process[l] = NULL;
+                    }
+                    if (NULL != cur->displs_per_process[l]){
+                        free(cur->displs_per_process[l]);
+                        cur->displs_per_process[l] = NULL;
+                    }
+                    cur->blocklen_per_process[l] = (int *) calloc (1, sizeof(int));
+                    if (NULL == cur->blocklen_per_process[l]) {
+                        opal_output (1, "OUT OF MEMORY for blocklen\n");
+                        ret = OMPI_ERR_OUT_OF_RESOURCE;
+                        goto exit;
+                    }
+                    cur->displs_per_process[l] = (MPI_Aint *) calloc (1, sizeof(MPI_Aint));
+                    if (NULL == cur->displs_per_process[l]){
+                        opal_output (1, "OUT OF MEMORY for displs\n");
+                        ret = OMPI_ERR_OUT_OF_RESOURCE;
+                        goto exit;
+                    }
                 }
-                if (NULL != displs_per_process[l]){
-                    free(displs_per_process[l]);
-                    displs_per_process[l] = NULL;
+
+                if (NULL != sorted_file_offsets){
+                    free(sorted_file_offsets);
+                    sorted_file_offsets = NULL;
                 }
-                blocklen_per_process[l] = (int *) calloc (1, sizeof(int));
-                if (NULL == blocklen_per_process[l]) {
-                    opal_output (1, "OUT OF MEMORY for blocklen\n");
-                    ret = OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
+
+                if(NULL != file_offsets_for_agg){
+                    free(file_offsets_for_agg);
+                    file_offsets_for_agg = NULL;
                 }
-                displs_per_process[l] = (MPI_Aint *) calloc (1, sizeof(MPI_Aint));
-                if (NULL == displs_per_process[l]){
-                    opal_output (1, "OUT OF MEMORY for displs\n");
-                    ret = OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
+                if (NULL != memory_displacements){
+                    free(memory_displacements);
+                    memory_displacements = NULL;
                 }
-            }
+            }  /* (my_aggregator == fh->f_rank */
 
-            if (NULL != sorted_file_offsets){
-                free(sorted_file_offsets);
-                sorted_file_offsets = NULL;
+            /**************************************************************************
+             ***  7b. Determine the number of bytes to be actually read in this cycle
+             **************************************************************************/
+            if (cycles-1 == next_cycle) {
+                bytes_to_read_in_cycle = total_bytes - bytes_per_cycle*next_cycle;
             }
-
-            if(NULL != file_offsets_for_agg){
-                free(file_offsets_for_agg);
-                file_offsets_for_agg = NULL;
-            }
-            if (NULL != memory_displacements){
-                free(memory_displacements);
-                memory_displacements = NULL;
+            else {
+                bytes_to_read_in_cycle = bytes_per_cycle;
             }
-        }  /* (my_aggregator == fh->f_rank */
-
-        /**************************************************************************
-         ***  7b. Determine the number of bytes to be actually read in this cycle
-	 **************************************************************************/
-        if (cycles-1 == index) {
-            bytes_to_read_in_cycle = total_bytes - bytes_per_cycle*index;
-        }
-        else {
-            bytes_to_read_in_cycle = bytes_per_cycle;
-        }
 
 #if DEBUG_ON
-        if (my_aggregator == fh->f_rank) {
-            printf ("****%d: CYCLE %d   Bytes %d**********\n",
-                    fh->f_rank,
-                    index,
-                    bytes_to_write_in_cycle);
-        }
-#endif
-
-        /*****************************************************************
-         *** 7c. Calculate how much data will be contributed in this cycle
-	 ***     by each process
-         *****************************************************************/
-        bytes_received = 0;
-
-        while (bytes_to_read_in_cycle) {
-            /* This next block identifies which process is the holder
-            ** of the sorted[current_index] element;
-            */
-            blocks = fview_count[0];
-            for (j=0 ; j<fh->f_procs_per_group ; j++) {
-                if (sorted[current_index] < blocks) {
-                    n = j;
-                    break;
-                }
-                else {
-                    blocks += fview_count[j+1];
-                }
+            if (my_aggregator == fh->f_rank) {
+                printf ("****%d: CYCLE %d   Bytes %ld**********\n",
+                        fh->f_rank,
+                        next_cycle,
+                        bytes_to_read_in_cycle);
             }
+#endif
 
-            if (bytes_remaining) {
-                /* Finish up a partially used buffer from the previous  cycle */
-                if (bytes_remaining <= bytes_to_read_in_cycle) {
-                    /* Data fits completely into the block */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_remaining;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
-                            (global_iov_array[sorted[current_index]].iov_len - bytes_remaining);
-
-                        blocklen_per_process[n] = (int *) realloc
-                            ((void *)blocklen_per_process[n], (disp_index[n]+1)*sizeof(int));
-                        displs_per_process[n] = (MPI_Aint *) realloc
-                            ((void *)displs_per_process[n], (disp_index[n]+1)*sizeof(MPI_Aint));
-                        blocklen_per_process[n][disp_index[n]] = 0;
-                        displs_per_process[n][disp_index[n]] = 0;
-                        disp_index[n] += 1;
-                    }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_remaining;
-                    }
-                    current_index ++;
-                    bytes_to_read_in_cycle -= bytes_remaining;
-                    bytes_remaining = 0;
-                    continue;
-                }
-                else {
-                     /* the remaining data from the previous cycle is larger than the
-                        bytes_to_write_in_cycle, so we have to segment again */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_to_read_in_cycle;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
-                            (global_iov_array[sorted[current_index]].iov_len
-                             - bytes_remaining);
+            /*****************************************************************
+             *** 7c. Calculate how much data will be contributed in this cycle
+             ***     by each process
+             *****************************************************************/
+            cur->bytes_received = 0;
+            cur->entries_per_aggregator = 0;
+
+            while (bytes_to_read_in_cycle) {
+                /* This next block identifies which process is the holder
+                ** of the sorted[current_index] element;
+                */
+                blocks = fview_count[0];
+                for (j=0 ; j<fh->f_procs_per_group ; j++) {
+                    if (sorted[current_index] < blocks) {
+                        n = j;
+                        break;
                     }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                    else {
+                        blocks += fview_count[j+1];
                     }
-                    bytes_remaining -= bytes_to_read_in_cycle;
-                    bytes_to_read_in_cycle = 0;
-                    break;
                 }
-            }
-            else {
-                /* No partially used entry available, have to start a new one */
-                if (bytes_to_read_in_cycle <
-                    (MPI_Aint) global_iov_array[sorted[current_index]].iov_len) {
-                    /* This entry has more data than we can sendin one cycle */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_to_read_in_cycle;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base ;
-                    }
 
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                if (bytes_remaining) {
+                    /* Finish up a partially used buffer from the previous  cycle */
+                    if (bytes_remaining <= bytes_to_read_in_cycle) {
+                        /* Data fits completely into the block */
+                        if (my_aggregator == fh->f_rank) {
+                            cur->blocklen_per_process[n][cur->disp_index[n] - 1] = bytes_remaining;
+                            cur->displs_per_process[n][cur->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
+                                (global_iov_array[sorted[current_index]].iov_len - bytes_remaining);
+
+                            cur->blocklen_per_process[n] = (int *) realloc
+                                ((void *)cur->blocklen_per_process[n], (cur->disp_index[n]+1)*sizeof(int));
+                            cur->displs_per_process[n] = (MPI_Aint *) realloc
+                                ((void *)cur->displs_per_process[n], (cur->disp_index[n]+1)*sizeof(MPI_Aint));
+                            cur->blocklen_per_process[n][cur->disp_index[n]] = 0;
+                            cur->displs_per_process[n][cur->disp_index[n]] = 0;
+                            cur->disp_index[n] += 1;
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            cur->bytes_received += bytes_remaining;
+                        }
+                        current_index ++;
+                        bytes_to_read_in_cycle -= bytes_remaining;
+                        bytes_remaining = 0;
+                        continue;
+                    }
+                    else {
+                        /* the remaining data from the previous cycle is larger than the
+                           bytes_to_write_in_cycle, so we have to segment again */
+                        if (my_aggregator == fh->f_rank) {
+                            cur->blocklen_per_process[n][cur->disp_index[n] - 1] = bytes_to_read_in_cycle;
+                            cur->displs_per_process[n][cur->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
+                                (global_iov_array[sorted[current_index]].iov_len
+                                 - bytes_remaining);
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            cur->bytes_received += bytes_to_read_in_cycle;
+                        }
+                        bytes_remaining -= bytes_to_read_in_cycle;
+                        bytes_to_read_in_cycle = 0;
+                        break;
                     }
-                    bytes_remaining = global_iov_array[sorted[current_index]].iov_len -
-                        bytes_to_read_in_cycle;
-                    bytes_to_read_in_cycle = 0;
-                    break;
                 }
                 else {
-                    /* Next data entry is less than bytes_to_write_in_cycle */
-                    if (my_aggregator ==  fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] =
-                            global_iov_array[sorted[current_index]].iov_len;
-                        displs_per_process[n][disp_index[n] - 1] = (ptrdiff_t)
-                            global_iov_array[sorted[current_index]].iov_base;
-                        blocklen_per_process[n] =
-                            (int *) realloc ((void *)blocklen_per_process[n], (disp_index[n]+1)*sizeof(int));
-                        displs_per_process[n] = (MPI_Aint *)realloc
-                            ((void *)displs_per_process[n], (disp_index[n]+1)*sizeof(MPI_Aint));
-                        blocklen_per_process[n][disp_index[n]] = 0;
-                        displs_per_process[n][disp_index[n]] = 0;
-                        disp_index[n] += 1;
+                    /* No partially used entry available, have to start a new one */
+                    if (bytes_to_read_in_cycle <
+                        (MPI_Aint) global_iov_array[sorted[current_index]].iov_len) {
+                        /* This entry has more data than we can sendin one cycle */
+                        if (my_aggregator == fh->f_rank) {
+                            cur->blocklen_per_process[n][cur->disp_index[n] - 1] = bytes_to_read_in_cycle;
+                            cur->displs_per_process[n][cur->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base ;
+                        }
+
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            cur->bytes_received += bytes_to_read_in_cycle;
+                        }
+                        bytes_remaining = global_iov_array[sorted[current_index]].iov_len -
+                            bytes_to_read_in_cycle;
+                        bytes_to_read_in_cycle = 0;
+                        break;
                     }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received +=
+                    else {
+                        /* Next data entry is less than bytes_to_write_in_cycle */
+                        if (my_aggregator ==  fh->f_rank) {
+                            cur->blocklen_per_process[n][cur->disp_index[n] - 1] =
+                                global_iov_array[sorted[current_index]].iov_len;
+                            cur->displs_per_process[n][cur->disp_index[n] - 1] = (ptrdiff_t)
+                                global_iov_array[sorted[current_index]].iov_base;
+                            cur->blocklen_per_process[n] =
+                                (int *) realloc ((void *)cur->blocklen_per_process[n], (cur->disp_index[n]+1)*sizeof(int));
+                            cur->displs_per_process[n] = (MPI_Aint *)realloc
+                                ((void *)cur->displs_per_process[n], (cur->disp_index[n]+1)*sizeof(MPI_Aint));
+                            cur->blocklen_per_process[n][cur->disp_index[n]] = 0;
+                            cur->displs_per_process[n][cur->disp_index[n]] = 0;
+                            cur->disp_index[n] += 1;
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            cur->bytes_received +=
+                                global_iov_array[sorted[current_index]].iov_len;
+                        }
+                        bytes_to_read_in_cycle -=
                             global_iov_array[sorted[current_index]].iov_len;
+                        current_index ++;
+                        continue;
                     }
-                    bytes_to_read_in_cycle -=
-                        global_iov_array[sorted[current_index]].iov_len;
-                    current_index ++;
-                    continue;
                 }
+            } /* end while (bytes_to_read_in_cycle) */
+
+            /*************************************************************************
+             *** 7d. Calculate the displacement on where to put the data and allocate
+             ***     the recieve buffer (global_buf)
+             *************************************************************************/
+            if (my_aggregator != fh->f_rank) {
+                continue;
             }
-        } /* end while (bytes_to_read_in_cycle) */
-
-        /*************************************************************************
-	 *** 7d. Calculate the displacement on where to put the data and allocate
-         ***     the recieve buffer (global_buf)
-	 *************************************************************************/
-        if (my_aggregator == fh->f_rank) {
-            entries_per_aggregator=0;
+
             for (i=0;i<fh->f_procs_per_group; i++){
-                for (j=0;j<disp_index[i];j++){
-                    if (blocklen_per_process[i][j] > 0)
-                        entries_per_aggregator++ ;
+                for (j=0;j<cur->disp_index[i];j++){
+                    if (cur->blocklen_per_process[i][j] > 0)
+                        cur->entries_per_aggregator++ ;
                 }
             }
-            if (entries_per_aggregator > 0){
-                file_offsets_for_agg = (mca_io_ompio_local_io_array *)
-                    malloc(entries_per_aggregator*sizeof(mca_io_ompio_local_io_array));
-                if (NULL == file_offsets_for_agg) {
-                    opal_output (1, "OUT OF MEMORY\n");
-                    ret = OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
-                }
-                sorted_file_offsets = (int *)
-                    malloc (entries_per_aggregator*sizeof(int));
-                if (NULL == sorted_file_offsets){
-                    opal_output (1, "OUT OF MEMORY\n");
-                    ret =  OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
-                }
-                /*Moving file offsets to an IO array!*/
-                temp_index = 0;
-                global_count = 0;
-                for (i=0;i<fh->f_procs_per_group; i++){
-                    for(j=0;j<disp_index[i];j++){
-                        if (blocklen_per_process[i][j] > 0){
-                            file_offsets_for_agg[temp_index].length =
-                                blocklen_per_process[i][j];
-                            global_count += blocklen_per_process[i][j];
-                            file_offsets_for_agg[temp_index].process_id = i;
-                            file_offsets_for_agg[temp_index].offset =
-                                displs_per_process[i][j];
-                            temp_index++;
-                        }
+            if (0 == cur->entries_per_aggregator) {
+                continue;
+            }
+
+            file_offsets_for_agg = (mca_io_ompio_local_io_array *)
+                malloc(cur->entries_per_aggregator*sizeof(mca_io_ompio_local_io_array));
+            if (NULL == file_offsets_for_agg) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+            sorted_file_offsets = (int *)
+                malloc (cur->entries_per_aggregator*sizeof(int));
+            if (NULL == sorted_file_offsets){
+                opal_output (1, "OUT OF MEMORY\n");
+                ret =  OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+            /*Moving file offsets to an IO array!*/
+            temp_index = 0;
+            global_count = 0;
+            for (i=0;i<fh->f_procs_per_group; i++){
+                for(j=0;j<cur->disp_index[i];j++){
+                    if (cur->blocklen_per_process[i][j] > 0){
+                        file_offsets_for_agg[temp_index].length =
+                            cur->blocklen_per_process[i][j];
+                        global_count += cur->blocklen_per_process[i][j];
+                        file_offsets_for_agg[temp_index].process_id = i;
+                        file_offsets_for_agg[temp_index].offset =
+                            cur->displs_per_process[i][j];
+                        temp_index++;
                     }
                 }
             }
-            else{
-                continue;
-            }
 
-             /* Sort the displacements for each aggregator */
+            /* Sort the displacements for each aggregator */
             read_heap_sort (file_offsets_for_agg,
-                            entries_per_aggregator,
+                            cur->entries_per_aggregator,
                             sorted_file_offsets);
 
             memory_displacements = (MPI_Aint *) malloc
-                (entries_per_aggregator * sizeof(MPI_Aint));
+                (cur->entries_per_aggregator * sizeof(MPI_Aint));
+            if (NULL == memory_displacements) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
             memory_displacements[sorted_file_offsets[0]] = 0;
-            for (i=1; i<entries_per_aggregator; i++){
+            for (i=1; i<cur->entries_per_aggregator; i++){
                 memory_displacements[sorted_file_offsets[i]] =
                     memory_displacements[sorted_file_offsets[i-1]] +
                     file_offsets_for_agg[sorted_file_offsets[i-1]].length;
             }
 
-             /**********************************************************
-	     *** 7e. Create the io array, and pass it to fbtl
-	     *********************************************************/
+            /**********************************************************
+             *** 7e. Create the io array, and pass it to fbtl
+             *********************************************************/
             fh->f_io_array = (mca_common_ompio_io_array_t *) malloc
-                (entries_per_aggregator * sizeof (mca_common_ompio_io_array_t));
+                (cur->entries_per_aggregator * sizeof (mca_common_ompio_io_array_t));
             if (NULL == fh->f_io_array) {
                 opal_output(1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
@@ -655,9 +718,9 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
             fh->f_io_array[0].length =
                 file_offsets_for_agg[sorted_file_offsets[0]].length;
             fh->f_io_array[0].memory_address =
-                global_buf+memory_displacements[sorted_file_offsets[0]];
+                cur->global_buf+memory_displacements[sorted_file_offsets[0]];
             fh->f_num_of_io_entries++;
-            for (i=1;i<entries_per_aggregator;i++){
+            for (i=1;i<cur->entries_per_aggregator;i++){
                 if (file_offsets_for_agg[sorted_file_offsets[i-1]].offset +
                     file_offsets_for_agg[sorted_file_offsets[i-1]].length ==
                     file_offsets_for_agg[sorted_file_offsets[i]].offset){
@@ -670,81 +733,97 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                     fh->f_io_array[fh->f_num_of_io_entries].length =
                         file_offsets_for_agg[sorted_file_offsets[i]].length;
                     fh->f_io_array[fh->f_num_of_io_entries].memory_address =
-                        global_buf+memory_displacements[sorted_file_offsets[i]];
+                        cur->global_buf+memory_displacements[sorted_file_offsets[i]];
                     fh->f_num_of_io_entries++;
                 }
             }
 
-
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             start_read_time = MPI_Wtime();
 #endif
-
-            if (fh->f_num_of_io_entries) {
-                if ( 0 >  fh->f_fbtl->fbtl_preadv (fh)) {
-                    opal_output (1, "READ FAILED\n");
-                    ret = OMPI_ERROR;
-                    goto exit;
-                }
+            ret = read_init (fh, read_synch_type, &cur->read_req);
+            if (OMPI_SUCCESS != ret){
+                goto exit;
             }
-
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             end_read_time = MPI_Wtime();
             read_time += end_read_time - start_read_time;
 #endif
-            /**********************************************************
-             ******************** DONE READING ************************
-             *********************************************************/
 
+            /* The sends of this cycle use the location of the data in global_buf */
             temp_disp_index = (int *)calloc (1, fh->f_procs_per_group * sizeof (int));
             if (NULL == temp_disp_index) {
                 opal_output (1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
                 goto exit;
             }
-            for (i=0; i<entries_per_aggregator; i++){
+            for (i=0; i<cur->entries_per_aggregator; i++){
                 temp_index =
                     file_offsets_for_agg[sorted_file_offsets[i]].process_id;
-                displs_per_process[temp_index][temp_disp_index[temp_index]] =
+                cur->displs_per_process[temp_index][temp_disp_index[temp_index]] =
                     memory_displacements[sorted_file_offsets[i]];
-                if (temp_disp_index[temp_index] < disp_index[temp_index]){
+                if (temp_disp_index[temp_index] < cur->disp_index[temp_index]){
                     temp_disp_index[temp_index] += 1;
                 }
                 else{
                     printf("temp_disp_index[%d]: %d is greater than disp_index[%d]: %d\n",
                            temp_index, temp_disp_index[temp_index],
-                           temp_index, disp_index[temp_index]);
+                           temp_index, cur->disp_index[temp_index]);
                 }
             }
             if (NULL != temp_disp_index){
                 free(temp_disp_index);
                 temp_disp_index = NULL;
             }
+        } /* end for ( ; next_cycle < cycles ...) */
+
+        cur = &cycle_data[index % num_buffers];
+
+        /**********************************************************
+         *** 7f. Wait for the data of this cycle and send it to
+         ***     the processes of the group
+         *********************************************************/
+        if (my_aggregator == fh->f_rank && cur->entries_per_aggregator > 0) {
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            start_read_time = MPI_Wtime();
+#endif
+            ret = ompi_request_wait (&cur->read_req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != ret){
+                opal_output (1, "READ FAILED\n");
+                goto exit;
+            }
+#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            end_read_time = MPI_Wtime();
+            read_time += end_read_time - start_read_time;
+#endif
+            /**********************************************************
+             ******************** DONE READING ************************
+             *********************************************************/
 
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             start_rcomm_time = MPI_Wtime();
 #endif
             for (i=0;i<fh->f_procs_per_group;i++){
                 size_t datatype_size;
-                send_req[i] = MPI_REQUEST_NULL;
-                if ( 0 < disp_index[i] ) {
-                    ompi_datatype_create_hindexed(disp_index[i],
-                                                  blocklen_per_process[i],
-                                                  displs_per_process[i],
+                cur->send_req[i] = MPI_REQUEST_NULL;
+                if ( 0 < cur->disp_index[i] ) {
+                    ompi_datatype_create_hindexed(cur->disp_index[i],
+                                                  cur->blocklen_per_process[i],
+                                                  cur->displs_per_process[i],
                                                   MPI_BYTE,
-                                                  &sendtype[i]);
-                    ompi_datatype_commit(&sendtype[i]);
-                    opal_datatype_type_size(&sendtype[i]->super, &datatype_size);
+                                                  &cur->sendtype[i]);
+                    ompi_datatype_commit(&cur->sendtype[i]);
+                    opal_datatype_type_size(&cur->sendtype[i]->super, &datatype_size);
 
                     if(datatype_size) {
-                        ret = MCA_PML_CALL (isend(global_buf,
+                        ret = MCA_PML_CALL (isend(cur->global_buf,
                                                   1,
-                                                  sendtype[i],
+                                                  cur->sendtype[i],
                                                   fh->f_procs_in_group[i],
                                                   FCOLL_VULCAN_SHUFFLE_TAG,
                                                   MCA_PML_BASE_SEND_STANDARD,
                                                   fh->f_comm,
-                                                  &send_req[i]));
+                                                  &cur->send_req[i]));
                         if(OMPI_SUCCESS != ret){
                             goto exit;
                         }
@@ -758,10 +837,10 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
         }
 
         /**********************************************************
-         *** 7f.  Scatter the Data from the readers
+         *** 7g.  Scatter the Data from the readers
          *********************************************************/
-        if(bytes_received) {
-            size_t remaining            = bytes_received;
+        if(cur->bytes_received) {
+            size_t remaining            = cur->bytes_received;
             int block_index             = -1;
             int blocklength_size        = INIT_LEN;
 
@@ -815,6 +894,11 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
                                           &newType);
             ompi_datatype_commit(&newType);
 
+            free (blocklength_proc);
+            blocklength_proc = NULL;
+            free (displs_proc);
+            displs_proc = NULL;
+
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             start_rcomm_time = MPI_Wtime();
 #endif
@@ -835,9 +919,9 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
             }
         }
 
-        if (my_aggregator == fh->f_rank){
+        if (my_aggregator == fh->f_rank && cur->entries_per_aggregator > 0){
             ret = ompi_request_wait_all (fh->f_procs_per_group,
-                                         send_req,
+                                         cur->send_req,
                                          MPI_STATUS_IGNORE);
             if (OMPI_SUCCESS != ret){
                 goto exit;
@@ -850,7 +934,7 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
         }
 
 #if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-        if(bytes_received) {
+        if(cur->bytes_received) {
             end_rcomm_time = MPI_Wtime();
             rcomm_time += end_rcomm_time - start_rcomm_time;
         }
@@ -875,10 +959,6 @@ mca_fcoll_vulcan_file_read_all (ompio_file_t *fh,
 #endif
 
 exit:
-    if (NULL != global_buf) {
-        free (global_buf);
-        global_buf = NULL;
-    }
     if (NULL != sorted) {
         free (sorted);
         sorted = NULL;
@@ -915,62 +995,115 @@ exit:
         displs_proc = NULL;
     }
 
-    if (my_aggregator == fh->f_rank) {
+    if (NULL != sorted_file_offsets){
+        free(sorted_file_offsets);
+        sorted_file_offsets = NULL;
+    }
+    if (NULL != file_offsets_for_agg){
+        free(file_offsets_for_agg);
+        file_offsets_for_agg = NULL;
+    }
+    if (NULL != memory_displacements){
+        free(memory_displacements);
+        memory_displacements= NULL;
+    }
 
-        if (NULL != sorted_file_offsets){
-            free(sorted_file_offsets);
-            sorted_file_offsets = NULL;
-        }
-        if (NULL != file_offsets_for_agg){
-            free(file_offsets_for_agg);
-            file_offsets_for_agg = NULL;
-        }
-        if (NULL != memory_displacements){
-            free(memory_displacements);
-            memory_displacements= NULL;
-        }
-        if (NULL != sendtype){
-            for (i = 0; i < fh->f_procs_per_group; i++) {
-                if ( MPI_DATATYPE_NULL != sendtype[i] ) {
-                    ompi_datatype_destroy(&sendtype[i]);
+    if (NULL != cycle_data) {
+        for (b=0; b<num_buffers; b++) {
+            cur = &cycle_data[b];
+
+            /* Outstanding reads of an aborted pipeline still target global_buf */
+            if ( MPI_REQUEST_NULL != cur->read_req ) {
+                ompi_request_wait (&cur->read_req, MPI_STATUS_IGNORE);
+            }
+            if (NULL != cur->global_buf) {
+                free (cur->global_buf);
+            }
+            if (NULL != cur->sendtype){
+                for (i = 0; i < fh->f_procs_per_group; i++) {
+                    if ( MPI_DATATYPE_NULL != cur->sendtype[i] ) {
+                        ompi_datatype_destroy(&cur->sendtype[i]);
+                    }
                 }
+                free(cur->sendtype);
             }
-            free(sendtype);
-            sendtype=NULL;
-        }
-
-        if (NULL != disp_index){
-            free(disp_index);
-            disp_index = NULL;
-        }
-
-        if ( NULL != blocklen_per_process){
-            for(l=0;l<fh->f_procs_per_group;l++){
-                if (NULL != blocklen_per_process[l]){
-                    free(blocklen_per_process[l]);
-                    blocklen_per_process[l] = NULL;
+            if (NULL != cur->disp_index){
+                free(cur->disp_index);
+            }
+            if ( NULL != cur->blocklen_per_process){
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    if (NULL != cur->blocklen_per_process[l]){
+                        free(cur->blocklen_per_process[l]);
+                    }
                 }
+                free(cur->blocklen_per_process);
+            }
+            if (NULL != cur->displs_per_process){
+                for (l=0; l<fh->f_procs_per_group; l++){
+                    if (NULL != cur->displs_per_process[l]){
+                        free(cur->displs_per_process[l]);
+                    }
+                }
+                free(cur->displs_per_process);
+            }
+            if ( NULL != cur->send_req ) {
+                free ( cur->send_req );
             }
-
-            free(blocklen_per_process);
-            blocklen_per_process = NULL;
         }
+        free (cycle_data);
+        cycle_data = NULL;
+    }
+    return ret;
+}
 
-        if (NULL != displs_per_process){
-            for (l=0; i<fh->f_procs_per_group; l++){
-                if (NULL != displs_per_process[l]){
-                    free(displs_per_process[l]);
-                    displs_per_process[l] = NULL;
-                }
+
+static int read_init (ompio_file_t *fh,
+                      int read_synchType,
+                      ompi_request_t **request)
+{
+    int ret = OMPI_SUCCESS;
+    ssize_t ret_temp = 0;
+    mca_ompio_request_t *ompio_req = NULL;
+
+    mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_READ );
+
+    if (fh->f_num_of_io_entries) {
+        if (1 == read_synchType) {
+            ret = fh->f_fbtl->fbtl_ipreadv(fh, (ompi_request_t *) ompio_req);
+            if(0 > ret) {
+                opal_output (1, "vulcan_read_all: fbtl_ipreadv failed\n");
+                ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+                ompio_req->req_ompi.req_status._ucount = 0;
+                ompi_request_complete (&ompio_req->req_ompi, false);
             }
-            free(displs_per_process);
-            displs_per_process = NULL;
         }
-        if ( NULL != send_req ) {
-            free ( send_req );
-            send_req = NULL;
+        else {
+            fh->f_flags |= OMPIO_COLLECTIVE_OP;
+            ret_temp = fh->f_fbtl->fbtl_preadv(fh);
+            fh->f_flags &= ~OMPIO_COLLECTIVE_OP;
+            if(0 > ret_temp) {
+                opal_output (1, "vulcan_read_all: fbtl_preadv failed\n");
+                ret = ret_temp;
+                ret_temp = 0;
+            }
+
+            ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+            ompio_req->req_ompi.req_status._ucount = ret_temp;
+            ompi_request_complete (&ompio_req->req_ompi, false);
         }
     }
+    else {
+        ompio_req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
+        ompio_req->req_ompi.req_status._ucount = 0;
+        ompi_request_complete (&ompio_req->req_ompi, false);
+    }
+
+    *request = (ompi_request_t *) ompio_req;
+
+    free(fh->f_io_array);
+    fh->f_io_array=NULL;
+    fh->f_num_of_io_entries=0;
+
     return ret;
 }
 
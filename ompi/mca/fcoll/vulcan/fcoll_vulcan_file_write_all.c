@@ -1383,6 +1383,13 @@ static int mca_fcoll_vulcan_minmax ( ompio_file_t *fh, struct iovec *iov, int io
       stripe_size++;
     }
 
+    /* Align file domains to the file system stripes, such that no stripe is
+       shared by two aggregators. */
+    if ( TOPOLOGY_AWARE == fh->f_get_mca_parameter_value ("grouping_option", strlen("grouping_option")) &&
+         fh->f_stripe_size > 0 && (stripe_size % (long)fh->f_stripe_size) ) {
+        stripe_size += (long)fh->f_stripe_size - (stripe_size % (long)fh->f_stripe_size);
+    }
+
     *new_stripe_size  = stripe_size;
     //    if ( fh->f_rank == 0 ) 
     //    printf(" partition size is %ld\n", stripe_size);
@@ -45,6 +45,7 @@ int mca_io_ompio_max_aggregators_ratio=8;
 int mca_io_ompio_aggregators_cutoff_threshold=3;
 int mca_io_ompio_overwrite_amode = 1;
 int mca_io_ompio_verbose_info_parsing = 0;
+int mca_io_ompio_write_behind_size = 0;
 
 int mca_io_ompio_grouping_option=5;
 
@@ -202,7 +203,8 @@ static int register_component(void)
                                            "Option for grouping of processes in the aggregator selection "
                                            "1: Data volume based grouping 2: maximizing group size uniformity 3: maximimze "
                                            "data contiguity 4: hybrid optimization  5: simple (default) "
-                                           "6: skip refinement step 7: simple+: grouping based on default file view",
+                                           "6: skip refinement step 7: simple+: grouping based on default file view "
+                                           "8: simple with aggregators spread across nodes and aligned to the file striping",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY,
@@ -255,6 +257,20 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_io_ompio_verbose_info_parsing);
 
+    mca_io_ompio_write_behind_size = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "write_behind_size",
+                                           "Size in bytes of the per-file buffer used to coalesce small "
+                                           "independent writes. Cached data is written once the buffer is full, "
+                                           "and on sync, close and any operation that needs to see the data. "
+                                           "Errors writing cached data are reported by the operation "
+                                           "triggering the flush. Not used in atomic mode. "
+                                           "0: disabled (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_write_behind_size);
+
     return OMPI_SUCCESS;
 }
 
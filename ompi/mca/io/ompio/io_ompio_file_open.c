@@ -40,6 +40,7 @@
 #include <math.h>
 #include "io_ompio.h"
 #include "ompi/mca/common/ompio/common_ompio_request.h"
+#include "ompi/mca/common/ompio/common_ompio_wbcache.h"
 #include "ompi/mca/topo/topo.h"
 
 int mca_io_ompio_file_open (ompi_communicator_t *comm,
@@ -132,8 +133,8 @@ int mca_io_ompio_file_preallocate (ompi_file_t *fh,
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return OMPI_ERROR;
     }
-    ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh,
-                                                 &current_size);
+    ret = mca_common_ompio_file_get_size (&data->ompio_fh,
+                                          &current_size);
     if ( OMPI_SUCCESS != ret ) {
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return OMPI_ERROR;
@@ -211,6 +212,9 @@ int mca_io_ompio_file_preallocate (ompi_file_t *fh,
 
 exit:     
     free ( buf );
+    if ( OMPI_SUCCESS == ret ) {
+        ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    }
     fh->f_comm->c_coll->coll_bcast ( &ret, 1, MPI_INT, OMPIO_ROOT, fh->f_comm,
                                    fh->f_comm->c_coll->coll_bcast_module);
     
@@ -251,6 +255,12 @@ int mca_io_ompio_file_set_size (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
+
     ret = data->ompio_fh.f_fs->fs_file_set_size (&data->ompio_fh, size);
     if ( OMPI_SUCCESS != ret ) {
         opal_output(1, ",mca_io_ompio_file_set_size: error in fs->set_size\n");
@@ -335,6 +345,13 @@ int mca_io_ompio_file_set_atomicity (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    /* Cached data was written under the old consistency semantics */
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
+
     bool result;
     if ( flag ) {
         result = data->ompio_fh.f_fbtl->fbtl_check_atomicity(&data->ompio_fh);
@@ -384,6 +401,12 @@ int mca_io_ompio_file_sync (ompi_file_t *fh)
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return MPI_ERR_ACCESS;
     }        
+    ret = mca_common_ompio_wbcache_flush (&data->ompio_fh);
+    if ( MPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
+
     // Make sure all processes reach this point before syncing the file.
     ret = data->ompio_fh.f_comm->c_coll->coll_barrier (data->ompio_fh.f_comm,
                                                        data->ompio_fh.f_comm->c_coll->coll_barrier_module);
@@ -467,8 +490,8 @@ int mca_io_ompio_file_seek (ompi_file_t *fh,
         }
         break;
     case MPI_SEEK_END:
-        ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh,
-                                                     &temp_offset2);
+        ret = mca_common_ompio_file_get_size (&data->ompio_fh,
+                                              &temp_offset2);
         mca_io_ompio_file_get_eof_offset (&data->ompio_fh,
                                           temp_offset2, &temp_offset);
         offset += temp_offset;
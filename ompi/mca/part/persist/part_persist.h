@@ -60,7 +60,8 @@ struct ompi_part_persist_t {
     int                    free_list_num;
     int                    free_list_max;
     int                    free_list_inc;
-    opal_list_t           *progress_list;
+    size_t                 min_transfer_size; /**< partitions are aggregated into transfers of at least this many bytes */
+    opal_list_t           *progress_list; /**< requests being initialized, active, or waiting to be freed */
 
     int32_t next_send_tag;                /**< This is a counter for send tags for the actual data transfer. */
     int32_t next_recv_tag; 
@@ -93,14 +94,21 @@ mca_part_persist_free_req(struct mca_part_persist_request_t* req)
 {
     int err = OMPI_SUCCESS;
     size_t i;
-    opal_list_remove_item(ompi_part_persist.progress_list, (opal_list_item_t*)req->progress_elem);
+    if(req->progress_listed) {
+        opal_list_remove_item(ompi_part_persist.progress_list, (opal_list_item_t*)req->progress_elem);
+        req->progress_listed = false;
+    }
     OBJ_RELEASE(req->progress_elem);
 
-    for(i = 0; i < req->real_parts; i++) {
-        ompi_request_free(&(req->persist_reqs[i]));
+    if(NULL != req->persist_reqs) {
+        for(i = 0; i < req->real_parts; i++) {
+            ompi_request_free(&(req->persist_reqs[i]));
+        }
     }
     free(req->persist_reqs);
-    free(req->flags);
+    free((void*)req->flags);
+    free((void*)req->ready);
+    free((void*)req->dirty);
 
     if( MCA_PART_PERSIST_REQUEST_PRECV == req->req_type ) {
         MCA_PART_PERSIST_PRECV_REQUEST_RETURN(req);
@@ -111,6 +119,129 @@ mca_part_persist_free_req(struct mca_part_persist_request_t* req)
 }
 
 
+/**
+ * Completion callback of the pml requests of the internal partitions. It only counts
+ * completions, so that the progress engine does not need to test every internal partition.
+ */
+static inline int
+mca_part_persist_transfer_complete(ompi_request_t* request)
+{
+    mca_part_persist_request_t* req = (mca_part_persist_request_t*) request->req_complete_cb_data;
+
+    (void) OPAL_THREAD_ADD_FETCH_SIZE_T(&req->done_count, 1);
+    return OMPI_SUCCESS;
+}
+
+/**
+ * Starts the transfers of the internal partitions first to last with a single start call.
+ */
+static inline int
+mca_part_persist_start_transfers(struct mca_part_persist_request_t* req, size_t first, size_t last)
+{
+    size_t i;
+
+    /* The callback has to be in place before the transfer can complete. */
+    for(i = first; i <= last; i++) {
+        req->persist_reqs[i]->req_complete_cb_data = req;
+        req->persist_reqs[i]->req_complete_cb = mca_part_persist_transfer_complete;
+    }
+    return req->persist_reqs[first]->req_start(last - first + 1, &(req->persist_reqs[first]));
+}
+
+/**
+ * Returns true if the user partitions first to last are all marked in the ready bitmap.
+ */
+static inline bool
+mca_part_persist_all_ready(struct mca_part_persist_request_t* req, size_t first, size_t last)
+{
+    size_t w;
+
+    for(w = first >> 6; w <= last >> 6; w++) {
+        uint64_t mask = ~(uint64_t) 0;
+
+        if(w == first >> 6) mask &= ~(uint64_t) 0 << (first & 63);
+        if(w == last >> 6) mask &= ~(uint64_t) 0 >> (63 - (last & 63));
+        if(mask != ((uint64_t) req->ready[w] & mask)) return false;
+    }
+    return true;
+}
+
+/**
+ * Marks the user partitions first to last in the ready bitmap and flags the words that
+ * changed in the dirty bitmap. Only uses atomic or operations, so it never blocks.
+ */
+static inline void
+mca_part_persist_mark_ready(struct mca_part_persist_request_t* req, size_t first, size_t last)
+{
+    size_t w;
+
+    for(w = first >> 6; w <= last >> 6; w++) {
+        uint64_t mask = ~(uint64_t) 0;
+
+        if(w == first >> 6) mask &= ~(uint64_t) 0 << (first & 63);
+        if(w == last >> 6) mask &= ~(uint64_t) 0 >> (63 - (last & 63));
+        (void) opal_thread_fetch_or_64(req->ready + w, (int64_t) mask);
+        (void) opal_thread_fetch_or_64(req->dirty + (w >> 6), (int64_t) ((uint64_t) 1 << (w & 63)));
+    }
+    /* ready and dirty are set before this, see mca_part_persist_start_ready */
+    opal_atomic_wmb();
+    req->ready_pending = 1;
+}
+
+/**
+ * Starts the internal partitions whose user partitions all became ready since the last
+ * call. Contiguous internal partitions are started with a single call. Only one thread
+ * may run this for a given request at a time: the progress engine, which holds
+ * ompi_part_persist.lock, or MPI_Pready when the process is not using threads.
+ */
+static inline int
+mca_part_persist_start_ready(struct mca_part_persist_request_t* req)
+{
+    int err = OMPI_SUCCESS;
+    size_t s, num_dirty, run = SIZE_MAX, prev = SIZE_MAX;
+
+    if(0 == req->ready_pending) return OMPI_SUCCESS;
+    /* Clear the pending flag before the dirty bits, a concurrent MPI_Pready sets it again */
+    (void) OPAL_ATOMIC_SWAP_32(&req->ready_pending, 0);
+
+    num_dirty = (((req->req_parts + 63) / 64) + 63) / 64;
+    for(s = 0; s < num_dirty && OMPI_SUCCESS == err; s++) {
+        uint64_t words;
+
+        if(0 == req->dirty[s]) continue;
+        words = (uint64_t) opal_thread_fetch_and_64(req->dirty + s, 0);
+        for(size_t w = s * 64; 0 != words && OMPI_SUCCESS == err; ++w, words >>= 1) {
+            size_t i, last_part;
+
+            if(0 == (words & 1)) continue;
+            last_part = w * 64 + 63;
+            if(last_part >= req->req_parts) last_part = req->req_parts - 1;
+
+            /* internal partitions that overlap this word of the ready bitmap */
+            for(i = (w * 64) / req->agg_parts; i <= last_part / req->agg_parts; i++) {
+                size_t first = i * req->agg_parts;
+                size_t last = first + req->agg_parts - 1;
+
+                if(last >= req->req_parts) last = req->req_parts - 1;
+                if(MCA_PART_PERSIST_FLAG_IDLE != req->flags[i] || !mca_part_persist_all_ready(req, first, last)) {
+                    continue;
+                }
+                req->flags[i] = MCA_PART_PERSIST_FLAG_STARTED;
+                if(SIZE_MAX != run && i != prev + 1) {
+                    err = mca_part_persist_start_transfers(req, run, prev);
+                    run = SIZE_MAX;
+                }
+                if(SIZE_MAX == run) run = i;
+                prev = i;
+            }
+        }
+    }
+    if(OMPI_SUCCESS == err && SIZE_MAX != run) {
+        err = mca_part_persist_start_transfers(req, run, prev);
+    }
+    return err;
+}
+
 __opal_attribute_always_inline__ static inline void mca_part_persist_init_lists(void)
 {
     opal_free_list_init (&mca_part_base_precv_requests,
@@ -158,7 +289,7 @@ mca_part_persist_complete(struct mca_part_persist_request_t* request)
 __opal_attribute_always_inline__ static inline int
 mca_part_persist_progress(void)
 {
-    mca_part_persist_list_t *current;
+    mca_part_persist_list_t *current, *next;
     int err;
     size_t i;
 
@@ -171,8 +302,6 @@ mca_part_persist_progress(void)
     }
 
     OPAL_THREAD_LOCK(&ompi_part_persist.lock);
- 
-    mca_part_persist_request_t* to_delete = NULL;
 
     /* Don't do anything till a function in the module is called. */
     if(-1 == ompi_part_persist.init_world)
@@ -218,7 +347,8 @@ mca_part_persist_progress(void)
         return OMPI_SUCCESS;
     }
 
-    OPAL_LIST_FOREACH(current, ompi_part_persist.progress_list, mca_part_persist_list_t) {
+    /* Only requests that are being initialized, are active, or wait to be freed are in the list. */
+    OPAL_LIST_FOREACH_SAFE(current, next, ompi_part_persist.progress_list, mca_part_persist_list_t) {
         mca_part_persist_request_t *req = (mca_part_persist_request_t *) current->item;
 
         /* Check to see if request is initilaized */
@@ -234,25 +364,25 @@ mca_part_persist_progress(void)
 
             if(done) {
                 size_t dt_size_;
-                int32_t dt_size;
 
-                req->initialized = true;
-                
                 if(MCA_PART_PERSIST_REQUEST_PSEND == req->req_type) {
                     /* parse message */
                     req->world_peer  = req->setup_info[1].world_rank; 
 
                     err = opal_datatype_type_size(&(req->req_datatype->super), &dt_size_);
                     if(OMPI_SUCCESS != err) return OMPI_ERROR;
-                    dt_size = (dt_size_ > (size_t) INT_MAX) ? MPI_UNDEFINED : (int) dt_size_;
-                    int32_t bytes = req->real_count * dt_size;
+                    size_t bytes = req->real_count * dt_size_;
 
                     /* Set up persistant sends */
                     req->persist_reqs = (ompi_request_t**) malloc(sizeof(ompi_request_t*)*(req->real_parts));
                     for(i = 0; i < req->real_parts; i++) {
                          void *buf = ((void*) (((char*)req->req_addr) + (bytes * i)));
-                         err = MCA_PML_CALL(isend_init(buf, req->real_count, req->req_datatype, req->world_peer, req->my_send_tag+i, MCA_PML_BASE_SEND_STANDARD, ompi_part_persist.part_comm, &(req->persist_reqs[i])));
+                         size_t count = (i == req->real_parts - 1) ? req->last_count : req->real_count;
+                         err = MCA_PML_CALL(isend_init(buf, count, req->req_datatype, req->world_peer, req->my_send_tag+i, MCA_PML_BASE_SEND_STANDARD, ompi_part_persist.part_comm, &(req->persist_reqs[i])));
                     }    
+
+                    opal_atomic_wmb();
+                    req->initialized = true;
                 } else {
                     /* parse message */
                     req->world_peer   = req->setup_info[1].world_rank; 
@@ -260,20 +390,26 @@ mca_part_persist_progress(void)
                     req->my_recv_tag  = req->setup_info[1].setup_tag;
                     req->real_parts   = req->setup_info[1].num_parts;
                     req->real_count   = req->setup_info[1].count;
+                    /* The sender may have aggregated partitions, the last transfer holds the remainder. */
+                    req->last_count   = req->req_parts * req->req_count - (req->real_parts - 1) * req->real_count;
 
                     err = opal_datatype_type_size(&(req->req_datatype->super), &dt_size_);
                     if(OMPI_SUCCESS != err) return OMPI_ERROR;
-                    dt_size = (dt_size_ > (size_t) INT_MAX) ? MPI_UNDEFINED : (int) dt_size_;
-                    int32_t bytes = req->real_count * dt_size;
+                    size_t bytes = req->real_count * dt_size_;
 
                     /* Set up persistant sends */
                     req->persist_reqs = (ompi_request_t**) malloc(sizeof(ompi_request_t*)*(req->real_parts));
-                    req->flags = (int*) calloc(req->real_parts,sizeof(int));
                     for(i = 0; i < req->real_parts; i++) {
                          void *buf = ((void*) (((char*)req->req_addr) + (bytes * i)));
-                         err = MCA_PML_CALL(irecv_init(buf, req->real_count, req->req_datatype, req->world_peer, req->my_send_tag+i, ompi_part_persist.part_comm, &(req->persist_reqs[i])));
+                         size_t count = (i == req->real_parts - 1) ? req->last_count : req->real_count;
+                         err = MCA_PML_CALL(irecv_init(buf, count, req->req_datatype, req->world_peer, req->my_send_tag+i, ompi_part_persist.part_comm, &(req->persist_reqs[i])));
+                    }
+                    if(0 < req->real_parts) {
+                        err = mca_part_persist_start_transfers(req, 0, req->real_parts - 1);
                     }
-                    err = req->persist_reqs[0]->req_start(req->real_parts, (&(req->persist_reqs[0])));                     
+
+                    opal_atomic_wmb();
+                    req->initialized = true;
 
                     /* Send back a message */
                     req->setup_info[0].world_rank = ompi_part_persist.my_world_rank;
@@ -282,44 +418,43 @@ mca_part_persist_progress(void)
                 } 
             }
         } else {
-            if(false == req->req_part_complete && REQUEST_COMPLETED != req->req_ompi.req_complete && OMPI_REQUEST_ACTIVE == req->req_ompi.req_state) {
-               for(i = 0; i < req->real_parts; i++) {
-
-                    /* Check to see if partition is queued for being started. Only applicable to sends. */ 
-                    if(-2 ==  req->flags[i]) {
-                        err = req->persist_reqs[i]->req_start(1, (&(req->persist_reqs[i])));
-                        req->flags[i] = 0;
-                    }
+            /* Turn the partitions marked by MPI_Pready into transfers. This also starts the
+             * partitions that became ready before the request was initialized. */
+            if(MCA_PART_PERSIST_REQUEST_PSEND == req->req_type && false == req->req_part_complete) {
+                err = mca_part_persist_start_ready(req);
+            }
 
-                    if(0 == req->flags[i])
-                    {
-                        ompi_request_test(&(req->persist_reqs[i]), &(req->flags[i]), MPI_STATUS_IGNORE);
-                        if(0 != req->flags[i]) req->done_count++;
-                    }
+            /* Completions are counted by mca_part_persist_transfer_complete, the transfers are
+             * only looked at once all of them reported. The callback runs just before the pml
+             * request is marked complete, so wait for that too. */
+            if(false == req->req_part_complete && REQUEST_COMPLETED != req->req_ompi.req_complete && OMPI_REQUEST_ACTIVE == req->req_ompi.req_state
+               && req->done_count == req->real_parts) {
+                for(i = 0; i < req->real_parts; i++) {
+                    if(!REQUEST_COMPLETE(req->persist_reqs[i])) break;
                 }
-
-                /* Check for completion and complete the requests */
-                if(req->done_count == req->real_parts)
-                {
+                if(i == req->real_parts) {
+                    for(i = 0; i < req->real_parts; i++) {
+                        req->persist_reqs[i]->req_state = OMPI_REQUEST_INACTIVE;
+                    }
                     req->first_send = false;
                     mca_part_persist_complete(req);
-                } 
+                }
             }
 
-            if(true == req->req_free_called && true == req->req_part_complete && REQUEST_COMPLETED == req->req_ompi.req_complete &&  OMPI_REQUEST_INACTIVE == req->req_ompi.req_state) {
-                to_delete = req;
+            if(true == req->req_part_complete && REQUEST_COMPLETED == req->req_ompi.req_complete &&  OMPI_REQUEST_INACTIVE == req->req_ompi.req_state) {
+                if(true == req->req_free_called) {
+                    err = mca_part_persist_free_req(req);
+                } else {
+                    /* Nothing to do until the request is started again. */
+                    opal_list_remove_item(ompi_part_persist.progress_list, (opal_list_item_t*)current);
+                    req->progress_listed = false;
+                }
             }
         }
 
     }
     OPAL_THREAD_UNLOCK(&ompi_part_persist.lock);
     block_entry = opal_atomic_add_fetch_32(&(ompi_part_persist.block_entry), -1);
-    if(to_delete) {
-        err =  mca_part_persist_free_req(to_delete);
-        if (OMPI_SUCCESS != err) {
-            return OMPI_ERROR;
-        }
-    }
 
     return OMPI_SUCCESS;
 }
@@ -362,6 +497,10 @@ mca_part_persist_precv_init(void *buf,
     req->first_send  = true; 
     req->flag_post_setup_recv = false;
     req->flags = NULL;
+    req->ready = NULL;
+    req->dirty = NULL;
+    req->persist_reqs = NULL;
+    req->done_count = 0;
     /* Non-blocking recive on setup info */
     err	= MCA_PML_CALL(irecv(&req->setup_info[1], sizeof(struct ompi_mca_persist_setup_t), MPI_BYTE, src, tag, comm, &req->setup_req[1])); 
     if(OMPI_SUCCESS != err) return OMPI_ERROR;
@@ -385,6 +524,7 @@ mca_part_persist_precv_init(void *buf,
     req->progress_elem = new_progress_elem; 
     OPAL_THREAD_LOCK(&ompi_part_persist.lock);
     opal_list_append(ompi_part_persist.progress_list, (opal_list_item_t*)new_progress_elem);
+    req->progress_listed = true;
     OPAL_THREAD_UNLOCK(&ompi_part_persist.lock);
 
     /* set return values */
@@ -425,7 +565,8 @@ mca_part_persist_psend_init(const void* buf,
     /* Set lazy initialization variables */
     req->initialized = false;
     req->first_send  = true; 
-    
+    req->persist_reqs = NULL;
+    req->done_count = 0;
 
     /* Determine total bytes to send. */
     err = opal_datatype_type_size(&(req->req_datatype->super), &dt_size_);
@@ -437,17 +578,29 @@ mca_part_persist_psend_init(const void* buf,
 
     /* non-blocking send set-up data */
     req->setup_info[0].world_rank = ompi_comm_rank(&ompi_mpi_comm_world.comm);
-    req->setup_info[0].start_tag = ompi_part_persist.next_send_tag; ompi_part_persist.next_send_tag += parts; 
+    /* Aggregate contiguous partitions smaller than the minimum transfer size. The grouping
+     * is fixed here, because the receiver pre-posts one receive per internal partition. */
+    req->agg_parts = 1;
+    if(0 < count * dt_size_ && count * dt_size_ < ompi_part_persist.min_transfer_size) {
+        req->agg_parts = (ompi_part_persist.min_transfer_size + count * dt_size_ - 1) / (count * dt_size_);
+        if(req->agg_parts > parts && 0 < parts) req->agg_parts = parts;
+    }
+    req->real_parts = (parts + req->agg_parts - 1) / req->agg_parts;
+    req->real_count = req->agg_parts * count;
+    req->last_count = parts * count - (req->real_parts - 1) * req->real_count;
+
+    req->setup_info[0].start_tag = ompi_part_persist.next_send_tag; ompi_part_persist.next_send_tag += req->real_parts; 
     req->my_send_tag = req->setup_info[0].start_tag;
     req->setup_info[0].setup_tag = ompi_part_persist.next_recv_tag; ompi_part_persist.next_recv_tag++;
     req->my_recv_tag = req->setup_info[0].setup_tag;
-    req->setup_info[0].num_parts = parts;
-    req->real_parts = parts;
-    req->setup_info[0].count = count;
-    req->real_count = count;
-
+    req->setup_info[0].num_parts = req->real_parts;
+    req->setup_info[0].count = req->real_count;
 
-    req->flags = (int*) calloc(req->real_parts, sizeof(int));
+    req->flags = (opal_atomic_int32_t*) calloc(req->real_parts, sizeof(opal_atomic_int32_t));
+    req->ready = (opal_atomic_int64_t*) calloc((parts + 63) / 64, sizeof(opal_atomic_int64_t));
+    req->dirty = (opal_atomic_int64_t*) calloc((((parts + 63) / 64) + 63) / 64, sizeof(opal_atomic_int64_t));
+    req->ready_pending = 0;
+    if(OPAL_UNLIKELY(0 < parts && (NULL == req->flags || NULL == req->ready || NULL == req->dirty))) return OMPI_ERR_OUT_OF_RESOURCE;
 
     err = MCA_PML_CALL(isend(&(req->setup_info[0]), sizeof(struct ompi_mca_persist_setup_t), MPI_BYTE, dst, tag, MCA_PML_BASE_SEND_STANDARD, comm, &req->setup_req[0]));
     if(OMPI_SUCCESS != err) return OMPI_ERROR;
@@ -473,6 +626,7 @@ mca_part_persist_psend_init(const void* buf,
     req->progress_elem = new_progress_elem;
     OPAL_THREAD_LOCK(&ompi_part_persist.lock);
     opal_list_append(ompi_part_persist.progress_list, (opal_list_item_t*)new_progress_elem);
+    req->progress_listed = true;
     OPAL_THREAD_UNLOCK(&ompi_part_persist.lock);
 
     /* Set return values */
@@ -485,31 +639,25 @@ mca_part_persist_start(size_t count, ompi_request_t** requests)
 {
     int err = OMPI_SUCCESS;
     size_t _count = count;
-    size_t i;
+    size_t i, j;
 
     for(i = 0; i < _count && OMPI_SUCCESS == err; i++) {
         mca_part_persist_request_t *req = (mca_part_persist_request_t *)(requests[i]);
-        /* First use is a special case, to support lazy initialization */
-        if(false == req->first_send)
-        {
-            if(MCA_PART_PERSIST_REQUEST_PSEND == req->req_type) {
-                req->done_count = 0;
-                memset((void*)req->flags,0,sizeof(int32_t)*req->real_parts);
-            } else {
-                req->done_count = 0;
-                err = req->persist_reqs[0]->req_start(req->real_parts, req->persist_reqs);
-                memset((void*)req->flags,0,sizeof(int32_t)*req->real_parts);
-            } 
-        } else {
-            if(MCA_PART_PERSIST_REQUEST_PSEND == req->req_type) {
-                req->done_count = 0;
-                for(i = 0; i < req->real_parts && OMPI_SUCCESS == err; i++) {
-                    req->flags[i] = -1;
-                }
-            } else {
-                req->done_count = 0;
-            } 
-        } 
+        if(MCA_PART_PERSIST_REQUEST_PSEND == req->req_type) {
+            req->done_count = 0;
+            req->ready_pending = 0;
+            memset((void*)req->ready, 0, sizeof(opal_atomic_int64_t) * ((req->req_parts + 63) / 64));
+            memset((void*)req->dirty, 0, sizeof(opal_atomic_int64_t) * ((((req->req_parts + 63) / 64) + 63) / 64));
+            for(j = 0; j < req->real_parts; j++) {
+                req->flags[j] = MCA_PART_PERSIST_FLAG_IDLE;
+            }
+        } else if(false == req->first_send) {
+            /* First use is a special case, the receives are started during lazy initialization */
+            req->done_count = 0;
+            if(0 < req->real_parts) {
+                err = mca_part_persist_start_transfers(req, 0, req->real_parts - 1);
+            }
+        }
         req->req_ompi.req_state = OMPI_REQUEST_ACTIVE;    
         req->req_ompi.req_status.MPI_TAG = MPI_ANY_TAG;
         req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
@@ -517,36 +665,43 @@ mca_part_persist_start(size_t count, ompi_request_t** requests)
         req->req_part_complete = false;
         req->req_ompi.req_complete = false;
         OPAL_ATOMIC_SWAP_PTR(&req->req_ompi.req_complete, REQUEST_PENDING);   
+
+        /* Completed requests leave the progress list, put it back. */
+        OPAL_THREAD_LOCK(&ompi_part_persist.lock);
+        if(false == req->progress_listed) {
+            opal_list_append(ompi_part_persist.progress_list, (opal_list_item_t*)req->progress_elem);
+            req->progress_listed = true;
+        }
+        OPAL_THREAD_UNLOCK(&ompi_part_persist.lock);
     }
 
     return err;
 }
 
+/**
+ * mca_part_persist_pready only marks the partitions in the ready bitmap, so that many
+ * threads can call it at once without taking a lock. The progress engine starts the
+ * transfers. A process that does not use threads starts them right away.
+ */
 __opal_attribute_always_inline__ static inline int
 mca_part_persist_pready(size_t min_part,
                     size_t max_part,
                     ompi_request_t* request)
 {
-    int err = OMPI_SUCCESS;
-    size_t i;
-
     mca_part_persist_request_t *req = (mca_part_persist_request_t *)(request);
-    if(true == req->initialized)
-    {
-        err = req->persist_reqs[min_part]->req_start(max_part-min_part+1, (&(req->persist_reqs[min_part])));
-        for(i = min_part; i <= max_part && OMPI_SUCCESS == err; i++) {
-            req->flags[i] = 0; /* Mark partion as ready for testing */
-        }
-    }
-    else
-    {
-        for(i = min_part; i <= max_part && OMPI_SUCCESS == err; i++) {
-            req->flags[i] = -2; /* Mark partition as queued */
-        }
+
+    mca_part_persist_mark_ready(req, min_part, max_part);
+
+    if(!opal_using_threads() && true == req->initialized) {
+        return mca_part_persist_start_ready(req);
     }
-    return err;
+    return OMPI_SUCCESS;
 }
 
+/**
+ * mca_part_persist_parrived maps the user partitions to the internal partitions that hold
+ * them, which may have been aggregated by the sender, and checks those for completion.
+ */
 __opal_attribute_always_inline__ static inline int
 mca_part_persist_parrived(size_t min_part,
                       size_t max_part,
@@ -554,22 +709,26 @@ mca_part_persist_parrived(size_t min_part,
                       ompi_request_t* request)
 {
     int err = OMPI_SUCCESS;
-    size_t i;
+    size_t i, first, last;
     int _flag = false;
     mca_part_persist_request_t *req = (mca_part_persist_request_t *)request;
 
-    if(0 != req->flags) {
-        _flag = 1;
-        if(req->req_parts == req->real_parts) {
-            for(i = min_part; i <= max_part; i++) {
-                _flag = _flag && req->flags[i];            
-            }
+    if(true == req->initialized) {
+        opal_atomic_rmb();
+        if(0 < req->real_count) {
+            first = (min_part * req->req_count) / req->real_count;
+            last = ((max_part + 1) * req->req_count - 1) / req->real_count;
         } else {
-            float convert = ((float)req->real_parts) / ((float)req->req_parts);
-            size_t _min = floor(convert * min_part);
-            size_t _max = ceil(convert * max_part);
-            for(i = _min; i <= _max; i++) {
-                _flag = _flag && req->flags[i];
+            first = min_part;
+            last = max_part;
+        }
+        if(last >= req->real_parts) last = req->real_parts - 1;
+
+        _flag = 1;
+        for(i = first; i <= last; i++) {
+            if(!REQUEST_COMPLETE(req->persist_reqs[i])) {
+                _flag = 0;
+                break;
             }
         }
     } 
@@ -580,18 +739,26 @@ mca_part_persist_parrived(size_t min_part,
 
 /**
  * mca_part_persist_free marks an entry as free called and sets the request to 
- * MPI_REQUEST_NULL. Note: requests get freed in the progress engine. 
+ * MPI_REQUEST_NULL. Note: requests that are still in use get freed in the progress engine. 
  */
 __opal_attribute_always_inline__ static inline int
 mca_part_persist_free(ompi_request_t** request)
 {
+    int err = OMPI_SUCCESS;
     mca_part_persist_request_t* req = *(mca_part_persist_request_t**)request;
 
     if(true == req->req_free_called) return OMPI_ERROR;
+
+    OPAL_THREAD_LOCK(&ompi_part_persist.lock);
     req->req_free_called = true;
+    /* Requests outside the progress list are initialized and inactive */
+    if(false == req->progress_listed) {
+        err = mca_part_persist_free_req(req);
+    }
+    OPAL_THREAD_UNLOCK(&ompi_part_persist.lock);
 
     *request = MPI_REQUEST_NULL;
-    return OMPI_SUCCESS;
+    return err;
 }
 
 END_C_DECLS
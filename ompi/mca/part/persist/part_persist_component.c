@@ -84,6 +84,14 @@ mca_part_persist_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_part_persist.free_list_inc);
 
+    ompi_part_persist.min_transfer_size = 8192;
+    (void) mca_base_component_var_register(&mca_part_persist_component.partm_version, "min_transfer_size",
+                                           "Contiguous partitions smaller than this many bytes are aggregated "
+                                           "into transfers of at least this size (0 disables aggregation)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_part_persist.min_transfer_size);
 
     return OPAL_SUCCESS;
 }
@@ -35,6 +35,12 @@ typedef enum {
 
 struct mca_part_persist_list_t;
 
+/**
+ * State of an internal partition on the send side.
+ */
+#define MCA_PART_PERSIST_FLAG_IDLE    -1  /**< not all of its user partitions are ready */
+#define MCA_PART_PERSIST_FLAG_STARTED  0  /**< transfer started */
+
 struct ompi_mca_persist_setup_t {
    int world_rank;
    int start_tag;
@@ -72,6 +78,8 @@ struct mca_part_persist_request_t {
     size_t real_parts;                   /**< internal number of partitions */
     size_t real_count;
     size_t part_size; 
+    size_t agg_parts;                    /**< user partitions aggregated in one internal partition (send side) */
+    size_t last_count;                   /**< count of the last internal partition, which may be short */
 
     ompi_request_t** persist_reqs;            /**< requests for persistant sends/recvs */
     ompi_request_t* setup_req [2];                /**< Request structure for setup messages */
@@ -88,13 +96,17 @@ struct mca_part_persist_request_t {
     int32_t initialized;                  /**< flag for initialized state */
     int32_t first_send;                   /**< flag for whether the first send has happend */
     int32_t flag_post_setup_recv;  
-    size_t done_count;             /**< counter for the number of partitions marked ready */
+    opal_atomic_size_t done_count; /**< counter for the number of internal partitions completed */
 
-    int32_t *flags;               /**< array of flags to determine whether a partition has arrived */
+    opal_atomic_int32_t *flags;   /**< state of each internal partition (MCA_PART_PERSIST_FLAG_*) */
+    opal_atomic_int64_t *ready;   /**< bitmap of the user partitions marked ready (send side) */
+    opal_atomic_int64_t *dirty;   /**< one bit per word of ready that changed since it was last scanned */
+    opal_atomic_int32_t ready_pending; /**< flag for partitions marked ready but not scanned yet */
 
     struct ompi_mca_persist_setup_t setup_info[2]; /**< Setup info to send durring initialization. */
   
     struct mca_part_persist_list_t* progress_elem; /**< pointer to progress list element for removal durring free. */ 
+    int32_t progress_listed;              /**< flag for whether progress_elem is in the progress list */
 
 };
 typedef struct mca_part_persist_request_t mca_part_persist_request_t;
@@ -963,6 +963,8 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
 
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_MSG_MATCH_POSTED_REQ,
                                     &(match->req_recv.req_base), PERUSE_RECV);
+            OPAL_TRACE(OPAL_TRACE_PML_RECV_MATCH, hdr->hdr_src, hdr->hdr_tag,
+                       ompi_comm_get_cid(comm_ptr), 0);
             SPC_TIMER_STOP(OMPI_SPC_MATCH_TIME, &timer);
             return match;
         }
@@ -1283,6 +1283,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     req->req_ack_sent = false;
 
     MCA_PML_BASE_RECV_START(&req->req_recv);
+    OPAL_TRACE(OPAL_TRACE_PML_RECV_POST, req->req_recv.req_base.req_peer,
+               req->req_recv.req_base.req_tag, ompi_comm_get_cid(comm),
+               req->req_recv.req_bytes_packed);
 
     OB1_MATCHING_LOCK(&ob1_comm->matching_lock);
     /**
@@ -1370,6 +1373,8 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
                                     &(req->req_recv.req_base), PERUSE_RECV);
 
             hdr = (mca_pml_ob1_hdr_t*)frag->segments->seg_addr.pval;
+            OPAL_TRACE(OPAL_TRACE_PML_RECV_MATCH, hdr->hdr_match.hdr_src,
+                       hdr->hdr_match.hdr_tag, ompi_comm_get_cid(comm), 0);
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_REMOVE_FROM_UNEX_Q,
                                    req->req_recv.req_base.req_comm,
                                    hdr->hdr_match.hdr_src,
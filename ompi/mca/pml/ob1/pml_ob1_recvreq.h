@@ -35,6 +35,7 @@
 #include "ompi/proc/proc.h"
 #include "ompi/mca/pml/ob1/pml_ob1_comm.h"
 #include "opal/mca/mpool/base/base.h"
+#include "opal/runtime/opal_trace.h"
 #include "ompi/mca/pml/base/pml_base_recvreq.h"
 
 BEGIN_C_DECLS
@@ -126,6 +127,11 @@ do {                                                                \
     do {                                                                              \
         PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_COMPLETE,                            \
                                  &(recvreq->req_recv.req_base), PERUSE_RECV );        \
+        OPAL_TRACE(OPAL_TRACE_PML_RECV_COMPLETE,                                      \
+                   (recvreq)->req_recv.req_base.req_ompi.req_status.MPI_SOURCE,       \
+                   (recvreq)->req_recv.req_base.req_ompi.req_status.MPI_TAG,          \
+                   ompi_comm_get_cid((recvreq)->req_recv.req_base.req_comm),          \
+                   (recvreq)->req_recv.req_base.req_ompi.req_status._ucount);         \
         ompi_request_complete( &(recvreq->req_recv.req_base.req_ompi), true );        \
     } while (0)
 
@@ -27,6 +27,7 @@
 
 #include "opal/datatype/opal_convertor.h"
 #include "opal/mca/mpool/base/base.h"
+#include "opal/runtime/opal_trace.h"
 #include "ompi/mca/pml/base/pml_base_sendreq.h"
 #include "pml_ob1_comm.h"
 #include "pml_ob1_hdr.h"
@@ -208,6 +209,10 @@ do {
         (sendreq)->req_send.req_bytes_packed;                                        \
    PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_COMPLETE,                                \
                             &(sendreq->req_send.req_base), PERUSE_SEND);             \
+   OPAL_TRACE(OPAL_TRACE_PML_SEND_COMPLETE, (sendreq)->req_send.req_base.req_peer,  \
+              (sendreq)->req_send.req_base.req_tag,                                  \
+              ompi_comm_get_cid((sendreq)->req_send.req_base.req_comm),              \
+              (sendreq)->req_send.req_bytes_packed);                                 \
                                                                                      \
    ompi_request_complete( &((sendreq)->req_send.req_base.req_ompi), (with_signal) ); \
 } while(0)
@@ -467,6 +472,10 @@ mca_pml_ob1_send_request_start_seq (mca_pml_ob1_send_request_t* sendreq, mca_bml
     sendreq->req_send.req_base.req_sequence = seqn;
 
     MCA_PML_BASE_SEND_START( &sendreq->req_send );
+    OPAL_TRACE(OPAL_TRACE_PML_SEND_START, sendreq->req_send.req_base.req_peer,
+               sendreq->req_send.req_base.req_tag,
+               ompi_comm_get_cid(sendreq->req_send.req_base.req_comm),
+               sendreq->req_send.req_bytes_packed);
 
     for(size_t i = 0; i < mca_bml_base_btl_array_get_size(&endpoint->btl_eager); i++) {
         mca_bml_base_btl_t* bml_btl;
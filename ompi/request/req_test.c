@@ -318,6 +318,15 @@ int ompi_request_default_test_some(
     ompi_request_t **rptr;
     ompi_request_t *request;
 
+    if (OMPI_REQUEST_CQ_USABLE(count)
+        && OMPI_SUCCESS == ompi_request_cq_some(count, requests, false, outcount, indices)) {
+        if (MPI_UNDEFINED == *outcount || 0 == *outcount) {
+            return OMPI_SUCCESS;
+        }
+        num_requests_done = *outcount;
+        goto complete_requests;
+    }
+
     opal_atomic_mb();
     rptr = requests;
     for (i = 0; i < count; i++, rptr++) {
@@ -357,6 +366,7 @@ int ompi_request_default_test_some(
         return OMPI_SUCCESS;
     }
 
+  complete_requests:
     /* fill out completion status and free request if required */
     for( i = 0; i < num_requests_done; i++) {
         request = requests[indices[i]];
@@ -102,8 +102,6 @@ recheck:
 
     num_requests_null_inactive = 0;
     for (i = 0; i < count; i++) {
-        void *_tmp_ptr = REQUEST_PENDING;
-
         request = requests[i];
 
         /* Check for null or completed persistent request. For
@@ -114,7 +112,7 @@ recheck:
             continue;
         }
 
-        if( !OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&request->req_complete, &_tmp_ptr, &sync) ) {
+        if( !ompi_request_attach_sync(request, &sync) ) {
             if(OPAL_LIKELY( REQUEST_COMPLETE(request) )) {
                 completed = i;
                 *index = i;
@@ -234,8 +232,6 @@ recheck:
     WAIT_SYNC_INIT(&sync, count);
     rptr = requests;
     for (i = 0; i < count; i++) {
-        void *_tmp_ptr = REQUEST_PENDING;
-
         request = *rptr++;
 
         if( request->req_state == OMPI_REQUEST_INACTIVE ) {
@@ -243,7 +239,7 @@ recheck:
             continue;
         }
 
-        if (REQUEST_COMPLETE(request) || !OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&request->req_complete, &_tmp_ptr, &sync)) {
+        if (REQUEST_COMPLETE(request) || !ompi_request_attach_sync(request, &sync)) {
             if( OPAL_LIKELY( REQUEST_COMPLETE(request) ) ) {
                 if( OPAL_UNLIKELY( MPI_SUCCESS != request->req_status.MPI_ERROR ) ) {
                     failed++;
@@ -461,6 +457,15 @@ int ompi_request_default_wait_some(size_t count,
         return OMPI_SUCCESS;
     }
 
+    if (OMPI_REQUEST_CQ_USABLE(count)
+        && OMPI_SUCCESS == ompi_request_cq_some(count, requests, true, outcount, indices)) {
+        if (MPI_UNDEFINED == *outcount) {
+            return OMPI_SUCCESS;
+        }
+        num_requests_done = *outcount;
+        goto complete_requests;
+    }
+
   recheck:
     WAIT_SYNC_INIT(&sync, 1);
 
@@ -471,8 +476,6 @@ int ompi_request_default_wait_some(size_t count,
     num_requests_done = 0;
     num_active_reqs = 0;
     for (size_t i = 0; i < count; i++, rptr++) {
-        void *_tmp_ptr = REQUEST_PENDING;
-
         request = *rptr;
         /*
          * Check for null or completed persistent request.
@@ -482,7 +485,7 @@ int ompi_request_default_wait_some(size_t count,
             num_requests_null_inactive++;
             continue;
         }
-        indices[num_active_reqs] = OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&request->req_complete, &_tmp_ptr, &sync);
+        indices[num_active_reqs] = ompi_request_attach_sync(request, &sync);
         if( !indices[num_active_reqs] ) {
             /* If the request is completed go ahead and mark it as such */
             if( REQUEST_COMPLETE(request) ) {
@@ -574,6 +577,8 @@ int ompi_request_default_wait_some(size_t count,
 
     *outcount = num_requests_done;
 
+  complete_requests:
+
     for (size_t i = 0; i < num_requests_done; i++) {
         request = requests[indices[i]];
 #if OPAL_ENABLE_FT_MPI
@@ -63,6 +63,7 @@ static void ompi_request_construct(ompi_request_t* req)
     req->req_complete_cb_data = NULL;
     req->req_f_to_c_index = MPI_UNDEFINED;
     req->req_mpi_object.comm = (struct ompi_communicator_t*) NULL;
+    req->req_cq_index     = 0;
 }
 
 static void ompi_request_destruct(ompi_request_t* req)
@@ -184,6 +185,7 @@ int ompi_request_finalize(void)
     OMPI_REQUEST_FINI( &ompi_request_empty );
     OBJ_DESTRUCT( &ompi_request_empty );
     OBJ_DESTRUCT( &ompi_request_f_to_c_table );
+    ompi_request_cq_finalize();
     return OMPI_SUCCESS;
 }
 
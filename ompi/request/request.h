@@ -38,6 +38,7 @@
 #include "opal/mca/threads/condition.h"
 #include "opal/mca/threads/wait_sync.h"
 #include "ompi/constants.h"
+#include "ompi/request/request_cq.h"
 #include "ompi/runtime/params.h"
 
 BEGIN_C_DECLS
@@ -137,6 +138,7 @@ struct ompi_request_t {
     ompi_request_complete_fn_t req_complete_cb; /**< Called when the request is MPI completed */
     void *req_complete_cb_data;
     ompi_mpi_object_t req_mpi_object;           /**< Pointer to MPI object that created this request */
+    int32_t req_cq_index;                       /**< Slot of the request in the array of its completion queue */
 };
 
 /**
@@ -442,6 +444,32 @@ static inline bool ompi_request_tag_is_collective(int tag) {
 }
 #endif /* OPAL_ENABLE_FT_MPI */
 
+/**
+ * Attach a synchronization object to a pending request, so it is updated
+ * when the request completes. A request left attached to a completion queue
+ * by MPI_Waitsome or MPI_Testsome is detached from the queue first, and the
+ * queue is told to look at it again.
+ *
+ * @return true if the synchronization object was attached, false if the
+ *         request completed (or has another waiter).
+ */
+static inline bool ompi_request_attach_sync(ompi_request_t *req, ompi_wait_sync_t *sync)
+{
+    for (;;) {
+        void *_tmp_ptr = REQUEST_PENDING;
+
+        if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&req->req_complete, &_tmp_ptr, sync)) {
+            return true;
+        }
+        if (!REQUEST_CQ_ATTACHED(_tmp_ptr)) {
+            return false;
+        }
+        if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&req->req_complete, &_tmp_ptr, REQUEST_PENDING)) {
+            ompi_request_cq_notify(_tmp_ptr, req->req_cq_index);
+        }
+    }
+}
+
 /**
  * Wait a particular request for completion
  */
@@ -450,7 +478,6 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
 {
     if (opal_using_threads ()) {
         if(!REQUEST_COMPLETE(req)) {
-            void *_tmp_ptr;
             ompi_wait_sync_t sync;
 
 
@@ -460,11 +487,9 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
                 return;
             }
 #endif /* OPAL_ENABLE_FT_MPI */
-            _tmp_ptr = REQUEST_PENDING;
-
             WAIT_SYNC_INIT(&sync, 1);
 
-            if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&req->req_complete, &_tmp_ptr, &sync)) {
+            if (ompi_request_attach_sync(req, &sync)) {
                 SYNC_WAIT(&sync);
             } else {
                 /* completed before we had a chance to swap in the sync object */
@@ -474,7 +499,7 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
 #if OPAL_ENABLE_FT_MPI
             if (OPAL_UNLIKELY(OMPI_SUCCESS != sync.status)) {
                 OPAL_OUTPUT_VERBOSE((50, ompi_ftmpi_output_handle, "Status %d reported for sync %p rearming req %p", sync.status, (void*)&sync, (void*)req));
-                _tmp_ptr = &sync;
+                void *_tmp_ptr = &sync;
                 if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&req->req_complete, &_tmp_ptr, REQUEST_PENDING)) {
                     opal_output_verbose(10, ompi_ftmpi_output_handle, "Status %d reported for sync %p rearmed req %p", sync.status, (void*)&sync, (void*)req);
                     WAIT_SYNC_RELEASE(&sync);
@@ -487,8 +512,9 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
      }
      opal_atomic_rmb();
     } else {
+        uint64_t idle_since = 0;
         while(!REQUEST_COMPLETE(req)) {
-            opal_progress();
+            opal_progress_wait(&idle_since);
 #if OPAL_ENABLE_FT_MPI
             /* Check to make sure that process failure did not break the
              * request. */
@@ -532,7 +558,9 @@ static inline int ompi_request_complete(ompi_request_t* request, bool with_signa
                 ompi_wait_sync_t *tmp_sync = (ompi_wait_sync_t *) OPAL_ATOMIC_SWAP_PTR(&request->req_complete,
                                                                                        REQUEST_COMPLETED);
                 /* In the case where another thread concurrently changed the request to REQUEST_PENDING */
-                if( REQUEST_PENDING != tmp_sync )
+                if( REQUEST_CQ_ATTACHED(tmp_sync) )
+                    ompi_request_cq_notify(tmp_sync, request->req_cq_index);
+                else if( REQUEST_PENDING != tmp_sync )
                     wait_sync_update(tmp_sync, 1, request->req_status.MPI_ERROR);
             }
         } else
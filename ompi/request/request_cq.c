@@ -0,0 +1,341 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/runtime/opal_progress.h"
+#include "ompi/constants.h"
+#include "ompi/request/request.h"
+#include "ompi/request/request_cq.h"
+
+/* number of request arrays bound to a completion queue at the same time */
+#define OMPI_REQUEST_CQ_CACHE_SIZE 4
+
+/* results of ompi_request_cq_attach() */
+#define OMPI_REQUEST_CQ_ATTACHED  0
+#define OMPI_REQUEST_CQ_COMPLETED 1
+#define OMPI_REQUEST_CQ_FOREIGN   2
+
+static ompi_request_cq_t *ompi_request_cq_cache[OMPI_REQUEST_CQ_CACHE_SIZE] = {NULL};
+
+/* Queues replaced by a larger one. Requests attached to them may still
+ * notify them, so they are only released in ompi_request_cq_finalize(). */
+static ompi_request_cq_t *ompi_request_cq_retired = NULL;
+
+static void ompi_request_cq_free(ompi_request_cq_t *cq)
+{
+    free(cq->attached);
+    free((void *) cq->ready);
+    free((void *) cq->summary);
+    free(cq);
+}
+
+/* The new queue is returned in use. */
+static ompi_request_cq_t *ompi_request_cq_create(size_t count)
+{
+    size_t num_ready = (count + 63) / 64;
+    ompi_request_cq_t *cq;
+
+    cq = (ompi_request_cq_t *) calloc(1, sizeof(*cq));
+    if (NULL == cq) {
+        return NULL;
+    }
+
+    cq->num_summary = (num_ready + 63) / 64;
+    cq->attached = (ompi_request_t **) calloc(count, sizeof(ompi_request_t *));
+    cq->ready = (opal_atomic_int64_t *) calloc(num_ready, sizeof(opal_atomic_int64_t));
+    cq->summary = (opal_atomic_int64_t *) calloc(cq->num_summary, sizeof(opal_atomic_int64_t));
+    if (NULL == cq->attached || NULL == cq->ready || NULL == cq->summary) {
+        ompi_request_cq_free(cq);
+        return NULL;
+    }
+    cq->capacity = count;
+    cq->in_use = 1;
+
+    return cq;
+}
+
+static void ompi_request_cq_retire(ompi_request_cq_t *cq)
+{
+    ompi_request_cq_t *head = ompi_request_cq_retired;
+
+    do {
+        cq->next = head;
+    } while (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&ompi_request_cq_retired, &head, cq));
+}
+
+/* Requests attached for the previous binding stay attached. When they
+ * complete they only set hints for slots of the new binding. */
+static void ompi_request_cq_bind(ompi_request_cq_t *cq, ompi_request_t **requests, size_t count)
+{
+    memset(cq->attached, 0, count * sizeof(ompi_request_t *));
+    cq->num_attached = 0;
+    cq->requests = requests;
+    cq->count = count;
+}
+
+static ompi_request_cq_t *ompi_request_cq_acquire(ompi_request_t **requests, size_t count)
+{
+    ompi_request_cq_t *cq;
+    int32_t idle;
+
+    /* the queue already bound to this array */
+    for (int k = 0; k < OMPI_REQUEST_CQ_CACHE_SIZE; ++k) {
+        cq = ompi_request_cq_cache[k];
+        if (NULL == cq || requests != cq->requests || count != cq->count) {
+            continue;
+        }
+        idle = 0;
+        if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&cq->in_use, &idle, 1)) {
+            if (requests == cq->requests && count == cq->count) {
+                return cq;
+            }
+            opal_atomic_wmb();
+            cq->in_use = 0;
+        }
+    }
+
+    /* bind an idle queue to the array, or create one */
+    for (int k = 0; k < OMPI_REQUEST_CQ_CACHE_SIZE; ++k) {
+        cq = ompi_request_cq_cache[k];
+        if (NULL == cq) {
+            ompi_request_cq_t *expected = NULL;
+
+            cq = ompi_request_cq_create(count);
+            if (NULL == cq) {
+                return NULL;
+            }
+            if (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&ompi_request_cq_cache[k], &expected,
+                                                         cq)) {
+                ompi_request_cq_free(cq);
+                continue;
+            }
+            ompi_request_cq_bind(cq, requests, count);
+            return cq;
+        }
+
+        idle = 0;
+        if (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&cq->in_use, &idle, 1)) {
+            continue;
+        }
+        if (cq->capacity < count) {
+            /* the old queue stays in use forever, so nobody else touches
+             * this cache entry while we replace it */
+            ompi_request_cq_t *larger = ompi_request_cq_create(count);
+            if (NULL == larger) {
+                opal_atomic_wmb();
+                cq->in_use = 0;
+                return NULL;
+            }
+            opal_atomic_wmb();
+            ompi_request_cq_cache[k] = larger;
+            ompi_request_cq_retire(cq);
+            cq = larger;
+        }
+        ompi_request_cq_bind(cq, requests, count);
+        return cq;
+    }
+
+    return NULL;
+}
+
+static void ompi_request_cq_release(ompi_request_cq_t *cq)
+{
+    opal_atomic_wmb();
+    cq->in_use = 0;
+}
+
+static bool ompi_request_cq_empty(ompi_request_cq_t *cq)
+{
+    for (size_t s = 0; s < cq->num_summary; ++s) {
+        if (0 != cq->summary[s]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Forget the attachment of every slot recorded in the queue, so the
+ * requests in these slots are examined again. */
+static void ompi_request_cq_drain(ompi_request_cq_t *cq)
+{
+    for (size_t s = 0; s < cq->num_summary; ++s) {
+        uint64_t words;
+
+        if (0 == cq->summary[s]) {
+            continue;
+        }
+        words = (uint64_t) opal_thread_fetch_and_64(cq->summary + s, 0);
+        for (size_t w = s * 64; 0 != words; ++w, words >>= 1) {
+            uint64_t bits;
+
+            if (0 == (words & 1)) {
+                continue;
+            }
+            bits = (uint64_t) opal_thread_fetch_and_64(cq->ready + w, 0);
+            for (size_t i = w * 64; 0 != bits; ++i, bits >>= 1) {
+                if ((bits & 1) && i < cq->count && NULL != cq->attached[i]) {
+                    cq->attached[i] = NULL;
+                    --cq->num_attached;
+                }
+            }
+        }
+    }
+}
+
+static int ompi_request_cq_attach(ompi_request_cq_t *cq, ompi_request_t *request, int32_t index)
+{
+    void *tag = (void *) ((uintptr_t) cq | REQUEST_CQ_TAG);
+
+    for (;;) {
+        void *_tmp_ptr = (void *) request->req_complete;
+
+        if (REQUEST_PENDING == _tmp_ptr) {
+            /* only read by ompi_request_complete() once the tag is set */
+            request->req_cq_index = index;
+            if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&request->req_complete, &_tmp_ptr, tag)) {
+                return OMPI_REQUEST_CQ_ATTACHED;
+            }
+            continue;
+        }
+        if (REQUEST_COMPLETED == _tmp_ptr) {
+            return OMPI_REQUEST_CQ_COMPLETED;
+        }
+        if (!REQUEST_CQ_ATTACHED(_tmp_ptr)) {
+            /* somebody else is waiting on this request */
+            return OMPI_REQUEST_CQ_FOREIGN;
+        }
+        if (tag == _tmp_ptr && index == request->req_cq_index) {
+            return OMPI_REQUEST_CQ_ATTACHED;
+        }
+        /* attached to another queue, or to another slot of this one */
+        if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR(&request->req_complete, &_tmp_ptr,
+                                                    REQUEST_PENDING)) {
+            ompi_request_cq_notify(_tmp_ptr, request->req_cq_index);
+        }
+    }
+}
+
+static void ompi_request_cq_wait(ompi_request_cq_t *cq)
+{
+    int32_t armed = 1;
+
+    WAIT_SYNC_INIT(&cq->sync, 1);
+
+    /* pairs with the check of armed in ompi_request_cq_notify() */
+    (void) OPAL_ATOMIC_SWAP_32(&cq->armed, 1);
+    if (ompi_request_cq_empty(cq)) {
+        (void) SYNC_WAIT(&cq->sync);
+    }
+
+    if (OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&cq->armed, &armed, 0)) {
+        /* nobody is going to signal the sync */
+        WAIT_SYNC_SIGNALLED(&cq->sync);
+    }
+    WAIT_SYNC_RELEASE(&cq->sync);
+}
+
+int ompi_request_cq_some(size_t count, ompi_request_t **requests, bool blocking, int *outcount,
+                         int *indices)
+{
+    ompi_request_cq_t *cq;
+
+    cq = ompi_request_cq_acquire(requests, count);
+    if (NULL == cq) {
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+
+    for (;;) {
+        size_t num_requests_done = 0, num_foreign = 0;
+
+        ompi_request_cq_drain(cq);
+
+        /* Only slots whose handle differs from the request attached to the
+         * queue need to be looked at: completed or detached requests were
+         * forgotten by the drain, and the user may have replaced handles
+         * since the previous call. */
+        for (size_t i = 0; i < count; ++i) {
+            ompi_request_t *request = requests[i];
+
+            if (OPAL_LIKELY(request == cq->attached[i])) {
+                continue;
+            }
+            if (NULL != cq->attached[i]) {
+                /* the handle was replaced, the old request will at most
+                 * leave a hint when it completes */
+                cq->attached[i] = NULL;
+                --cq->num_attached;
+            }
+            if (&ompi_request_null.request == request
+                || OMPI_REQUEST_INACTIVE == request->req_state) {
+                continue;
+            }
+
+            switch (ompi_request_cq_attach(cq, request, (int32_t) i)) {
+            case OMPI_REQUEST_CQ_ATTACHED:
+                cq->attached[i] = request;
+                ++cq->num_attached;
+                break;
+            case OMPI_REQUEST_CQ_COMPLETED:
+                indices[num_requests_done++] = (int) i;
+                break;
+            default:
+                ++num_foreign;
+                break;
+            }
+        }
+
+        if (0 < num_requests_done) {
+            *outcount = (int) num_requests_done;
+            break;
+        }
+        if (0 == cq->num_attached && 0 == num_foreign) {
+            *outcount = MPI_UNDEFINED;
+            break;
+        }
+        if (!blocking) {
+            *outcount = 0;
+#if OPAL_ENABLE_PROGRESS_THREADS == 0
+            opal_progress();
+#endif
+            break;
+        }
+        if (0 < num_foreign) {
+            /* nobody would wake us up for these */
+            opal_progress();
+            continue;
+        }
+        ompi_request_cq_wait(cq);
+    }
+
+    opal_atomic_rmb();
+    ompi_request_cq_release(cq);
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_request_cq_finalize(void)
+{
+    ompi_request_cq_t *cq;
+
+    for (int k = 0; k < OMPI_REQUEST_CQ_CACHE_SIZE; ++k) {
+        if (NULL != ompi_request_cq_cache[k]) {
+            ompi_request_cq_free(ompi_request_cq_cache[k]);
+            ompi_request_cq_cache[k] = NULL;
+        }
+    }
+
+    while (NULL != (cq = ompi_request_cq_retired)) {
+        ompi_request_cq_retired = cq->next;
+        ompi_request_cq_free(cq);
+    }
+}
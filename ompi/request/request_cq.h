@@ -0,0 +1,141 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Completion queues for MPI_Waitsome and MPI_Testsome on large request
+ * arrays.
+ *
+ * The default implementations attach a stack allocated ompi_wait_sync_t to
+ * every pending request on entry and detach it from every request on exit,
+ * so each call costs O(n) atomic operations and O(n) request dereferences
+ * even when a single request completed. A completion queue is bound to a
+ * request array instead and outlives the call: pending requests stay
+ * attached to it between calls, and a request completing while attached
+ * records its index in the queue. The next call only looks at the recorded
+ * indices and at the slots of the array whose handle changed since the
+ * previous call.
+ *
+ * Requests attached to a completion queue carry a tagged queue pointer in
+ * req_complete. Anybody else that wants to attach a synchronization object
+ * to such a request detaches it from the queue first and records its index
+ * (see ompi_request_attach_sync()), so the queue never misses an event.
+ * Queues are never freed before MPI_Finalize, which makes late
+ * notifications from requests that were attached to a previous binding
+ * harmless: the recorded indices are only hints and every hinted slot is
+ * examined again.
+ */
+
+#ifndef OMPI_REQUEST_CQ_H
+#define OMPI_REQUEST_CQ_H
+
+#include "ompi_config.h"
+
+#include "opal/mca/threads/wait_sync.h"
+#include "opal/sys/atomic.h"
+#include "ompi/runtime/params.h"
+
+BEGIN_C_DECLS
+
+struct ompi_request_t;
+
+/**
+ * Bit set in req_complete when the request is attached to a completion
+ * queue rather than to an ompi_wait_sync_t. REQUEST_COMPLETED uses bit 0.
+ */
+#define REQUEST_CQ_TAG ((uintptr_t) 2)
+
+#define REQUEST_CQ_ATTACHED(ptr) (0 != (REQUEST_CQ_TAG & (uintptr_t) (ptr)))
+
+struct ompi_request_cq_t {
+    /** used to block in MPI_Waitsome */
+    ompi_wait_sync_t sync;
+    /** a waiter is blocked on sync and must be signalled */
+    opal_atomic_int32_t armed;
+    /** the queue is used by a call in progress */
+    opal_atomic_int32_t in_use;
+    /** request array the queue is bound to */
+    struct ompi_request_t **requests;
+    size_t count;
+    /** maximum array size the queue can be bound to */
+    size_t capacity;
+    /** number of slots with a request attached to the queue */
+    size_t num_attached;
+    /** request attached to the queue for each slot (or NULL) */
+    struct ompi_request_t **attached;
+    /** one bit per slot whose attachment ended */
+    opal_atomic_int64_t *ready;
+    /** one bit per non-empty word of ready */
+    opal_atomic_int64_t *summary;
+    size_t num_summary;
+    /** next retired queue */
+    struct ompi_request_cq_t *next;
+};
+typedef struct ompi_request_cq_t ompi_request_cq_t;
+
+/**
+ * Whether an array of count requests is handled with a completion queue.
+ * Process failures are only noticed by scanning the whole array, so
+ * completion queues are not used when fault tolerance is enabled.
+ */
+#if OPAL_ENABLE_FT_MPI
+#    define OMPI_REQUEST_CQ_USABLE(count)                                             \
+        (0 < ompi_request_cq_threshold && (size_t) ompi_request_cq_threshold <= (count) \
+         && !ompi_ftmpi_enabled)
+#else
+#    define OMPI_REQUEST_CQ_USABLE(count) \
+        (0 < ompi_request_cq_threshold && (size_t) ompi_request_cq_threshold <= (count))
+#endif
+
+/**
+ * Record that the request in slot index is no longer attached to the
+ * completion queue and wake up the thread waiting on the queue if any.
+ *
+ * @param tagged (IN)  req_complete value of the request (tagged queue)
+ * @param index (IN)   slot of the request in the bound array
+ */
+static inline void ompi_request_cq_notify(void *tagged, int32_t index)
+{
+    ompi_request_cq_t *cq = (ompi_request_cq_t *) ((uintptr_t) tagged & ~REQUEST_CQ_TAG);
+    int32_t armed = 1;
+
+    (void) opal_thread_fetch_or_64(cq->ready + (index >> 6),
+                                   (int64_t) ((uint64_t) 1 << (index & 63)));
+    (void) opal_thread_fetch_or_64(cq->summary + (index >> 12),
+                                   (int64_t) ((uint64_t) 1 << ((index >> 6) & 63)));
+
+    if (cq->armed && OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&cq->armed, &armed, 0)) {
+        wait_sync_update(&cq->sync, 1, OPAL_SUCCESS);
+    }
+}
+
+/**
+ * Look for completed requests in an array using a completion queue.
+ *
+ * @param count (IN)      Number of requests
+ * @param requests (IN)   Array of requests
+ * @param blocking (IN)   Wait until at least one request completed
+ * @param outcount (OUT)  Number of completed requests, or MPI_UNDEFINED if
+ *                        there is no active request in the array
+ * @param indices (OUT)   Indices of the completed requests
+ *
+ * @return OMPI_SUCCESS, or OMPI_ERR_TEMP_OUT_OF_RESOURCE if no completion
+ *         queue is available and the caller has to scan the array itself.
+ */
+int ompi_request_cq_some(size_t count, struct ompi_request_t **requests, bool blocking,
+                         int *outcount, int *indices);
+
+/**
+ * Release all completion queues; invoked during MPI_FINALIZE.
+ */
+void ompi_request_cq_finalize(void);
+
+END_C_DECLS
+
+#endif /* OMPI_REQUEST_CQ_H */
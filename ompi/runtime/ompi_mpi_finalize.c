@@ -50,6 +50,7 @@
 #include "opal/util/event.h"
 #include "opal/util/output.h"
 #include "opal/runtime/opal_progress.h"
+#include "opal/runtime/opal_trace.h"
 #include "opal/mca/base/base.h"
 #include "opal/sys/atomic.h"
 #include "opal/runtime/opal.h"
@@ -359,6 +360,9 @@ int ompi_mpi_finalize(void)
         goto done;
     }
 
+    /* all the communication is done: write the event trace */
+    opal_trace_finalize();
+
     /* free requests */
     if (OMPI_SUCCESS != (ret = ompi_request_finalize())) {
         goto done;
@@ -47,6 +47,7 @@
 #include "mpi.h"
 #include "opal/class/opal_list.h"
 #include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/hwloc/base/base.h"
 #include "opal/runtime/opal_progress.h"
 #include "opal/mca/threads/threads.h"
@@ -57,6 +58,7 @@
 #include "opal/util/stacktrace.h"
 #include "opal/util/show_help.h"
 #include "opal/runtime/opal.h"
+#include "opal/runtime/opal_init_timing.h"
 #include "opal/util/event.h"
 #include "opal/mca/allocator/base/base.h"
 #include "opal/mca/rcache/base/base.h"
@@ -376,6 +378,30 @@ static int ompi_register_mca_variables(void)
     return OMPI_SUCCESS;
 }
 
+/*
+ * Expose the startup phases recorded so far as read-only MPI_T variables
+ * named mpi_init_time_<phase>, in seconds. They are not in the timer
+ * class: a read of a timer returns the time accumulated since its handle
+ * was allocated, which is 0 once MPI_Init returned. Phases recorded after
+ * MPI_Init (e.g. frameworks opened lazily) are not exposed.
+ */
+static void ompi_mpi_init_register_timing_pvars(void)
+{
+    int count = opal_init_timing_count();
+
+    for (int i = 0; i < count; ++i) {
+        const opal_init_timing_phase_t *phase = opal_init_timing_get(i);
+
+        (void) mca_base_pvar_register("ompi", "mpi", "init_time", phase->name,
+                                      "Wall clock time in seconds spent in this phase "
+                                      "of the library startup",
+                                      OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_GENERIC,
+                                      MCA_BASE_VAR_TYPE_DOUBLE, NULL, MPI_T_BIND_NO_OBJECT,
+                                      MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                      NULL, NULL, NULL, (void *) &phase->seconds);
+    }
+}
+
 static void fence_release(pmix_status_t status, void *cbdata)
 {
     volatile bool *active = (volatile bool*)cbdata;
@@ -409,6 +435,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
     pmix_status_t codes[2] = { PMIX_ERR_PROC_ABORTED, PMIX_ERR_LOST_CONNECTION };
     pmix_status_t rc;
     OMPI_TIMING_INIT(64);
+    double init_start = opal_init_timing_now(), phase_clock = init_start;
     opal_pmix_lock_t mylock;
     opal_process_name_t pname;
 
@@ -468,6 +495,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
     OMPI_TIMING_IMPORT_OPAL("opal_init_util");
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_opal_init_util");
 
     /* If thread support was enabled, then setup OPAL to allow for them. This must be done
      * early to prevent a race condition that can occur with orte_init(). */
@@ -563,6 +591,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
 
 
     OMPI_TIMING_NEXT("initialization");
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_setup");
 
     /* Setup RTE */
     if (OMPI_SUCCESS != (ret = ompi_rte_init(&argc, &argv))) {
@@ -570,6 +599,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
     OMPI_TIMING_NEXT("rte_init");
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_rte_init");
     OMPI_TIMING_IMPORT_OPAL("orte_ess_base_app_setup");
     OMPI_TIMING_IMPORT_OPAL("rte_init");
 
@@ -653,6 +683,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "ompi_op_init() failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_procs_datatypes_ops");
 
     /* Open up MPI-related MCA components */
 
@@ -676,6 +707,8 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "mca_bml_base_init() failed";
         goto error;
     }
+    /* opens and selects the btls */
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_bml_init");
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_pml_base_framework, 0))) {
         error = "mca_pml_base_open() failed";
         goto error;
@@ -694,6 +727,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "ompi_part_base_open() failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_framework_open");
 
     /* In order to reduce the common case for MPI apps (where they
        don't use MPI-2 IO or MPI-1 topology functions), the io and
@@ -709,6 +743,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "mca_pml_base_select() failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_pml_select");
 
     OMPI_TIMING_IMPORT_OPAL("orte_init");
     OMPI_TIMING_NEXT("rte_init-commit");
@@ -785,6 +820,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
     }
 
     OMPI_TIMING_NEXT("modex");
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_modex");
 
     /* select buffered send allocator component to be used */
     if( OMPI_SUCCESS !=
@@ -891,6 +927,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "ompi_proc_complete_init failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_objects");
 
     /* start PML/BTL's */
     ret = MCA_PML_CALL(enable(true));
@@ -929,6 +966,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "PML add procs failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_add_procs");
 
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_world.comm));
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_self.comm));
@@ -996,6 +1034,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
     /* check for timing request - get stop time and report elapsed
        time if so, then start the clock again */
     OMPI_TIMING_NEXT("barrier");
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_barrier");
 
 #if OPAL_ENABLE_PROGRESS_THREADS == 0
     /* Start setting up the event engine for MPI operations.  Don't
@@ -1016,6 +1055,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "ompi_mpi_do_preconnect_all() failed";
         goto error;
     }
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_preconnect");
 
     /* Setup the dynamic process management (DPM) subsystem */
     if (OMPI_SUCCESS != (ret = ompi_dpm_init())) {
@@ -1124,6 +1164,10 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
     OMPI_TIMING_OUT;
     OMPI_TIMING_FINALIZE;
 
+    OPAL_INIT_TIMING_LAP(phase_clock, "mpi_init_comm_select");
+    opal_init_timing_record("mpi_init", opal_init_timing_now() - init_start);
+    ompi_mpi_init_register_timing_pvars();
+
     ompi_hook_base_mpi_init_bottom(argc, argv, requested, provided);
 
     return MPI_SUCCESS;
@@ -80,6 +80,8 @@ bool ompi_async_mpi_finalize = false;
 
 #define OMPI_ADD_PROCS_CUTOFF_DEFAULT 0
 uint32_t ompi_add_procs_cutoff = OMPI_ADD_PROCS_CUTOFF_DEFAULT;
+#define OMPI_REQUEST_CQ_THRESHOLD_DEFAULT 1024
+int ompi_request_cq_threshold = OMPI_REQUEST_CQ_THRESHOLD_DEFAULT;
 bool ompi_mpi_dynamics_enabled = true;
 
 bool ompi_mpi_compat_mpi3 = false;
@@ -321,6 +323,17 @@ int ompi_mpi_register_params(void)
                                   0, 0, OPAL_INFO_LVL_3, MCA_BASE_VAR_SCOPE_LOCAL,
                                   &ompi_add_procs_cutoff);
 
+    ompi_request_cq_threshold = OMPI_REQUEST_CQ_THRESHOLD_DEFAULT;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "request_cq_threshold",
+                                 "Minimum number of requests for which MPI_Waitsome and "
+                                 "MPI_Testsome keep the pending requests attached to a "
+                                 "completion queue between calls instead of scanning the "
+                                 "whole array on every call (0 = never)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_request_cq_threshold);
+
     ompi_mpi_dynamics_enabled = true;
     (void) mca_base_var_register("ompi", "mpi", NULL, "dynamics_enabled",
                                  "Is the MPI dynamic process functionality enabled (e.g., MPI_COMM_SPAWN)?  Default is yes, but certain transports and/or environments may disable it.",
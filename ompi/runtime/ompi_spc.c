@@ -33,6 +33,8 @@
 #include "opal/util/argv.h"
 #include "opal/util/show_help.h"
 #include "opal/util/output.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/runtime/opal.h"
 
 #if SPC_ENABLE == 1
 
@@ -168,9 +170,66 @@ static const ompi_spc_event_t ompi_spc_events_desc[OMPI_SPC_NUM_COUNTERS] = {
                                              "contained at once since the last reset of this counter. Note: This counter is reset each time it is read.", true, false)
 };
 
+/* Counters that are the value of a high watermark counter. They are compared
+ * against the watermark on every update so they cannot be split across threads.
+ */
+static const int ompi_spc_shared_counters[] = {
+    OMPI_SPC_UNEXPECTED_IN_QUEUE,
+    OMPI_SPC_OOS_IN_QUEUE
+};
+
 /* An array of event structures to store the event data (value, attachments, flags) */
 ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS];
 
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local ompi_spc_thread_counters_t *ompi_spc_thread_counters = NULL;
+
+/* All the per-thread blocks. Blocks are only ever added to the list and are
+ * kept until the process exits, as the threads own a pointer to them.
+ */
+static ompi_spc_thread_counters_t *ompi_spc_thread_counters_list = NULL;
+static opal_mutex_t ompi_spc_thread_counters_lock = OPAL_MUTEX_STATIC_INIT;
+
+ompi_spc_thread_counters_t *ompi_spc_thread_counters_create(void)
+{
+    /* the cache line size of the machine, as found by hwloc */
+    size_t line = (size_t) opal_cache_line_size;
+    size_t size = (sizeof(ompi_spc_thread_counters_t) + line - 1) & ~(line - 1);
+    ompi_spc_thread_counters_t *counters;
+
+    if( 0 != posix_memalign((void **) &counters, line, size) ) {
+        return NULL;
+    }
+    memset(counters, 0, size);
+
+    opal_mutex_lock(&ompi_spc_thread_counters_lock);
+    counters->next = ompi_spc_thread_counters_list;
+    /* readers walk the list without the lock */
+    opal_atomic_wmb();
+    ompi_spc_thread_counters_list = counters;
+    opal_mutex_unlock(&ompi_spc_thread_counters_lock);
+
+    ompi_spc_thread_counters = counters;
+    return counters;
+}
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
+/* Returns the current value of a counter, summed over all threads. */
+static long long ompi_spc_value(int index)
+{
+    long long value = (long long)ompi_spc_events[index].value;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    ompi_spc_thread_counters_t *counters = ompi_spc_thread_counters_list;
+    opal_atomic_rmb();
+    for( ; NULL != counters; counters = counters->next ) {
+        value += counters->values[index];
+    }
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
+    return value;
+}
+
 /* ##############################################################
  * ################# Begin MPI_T Functions ######################
  * ##############################################################
@@ -228,7 +287,7 @@ static int ompi_spc_get_count(const struct mca_base_pvar_t *pvar, void *value, v
     /* Convert from MPI_T pvar index to SPC index */
     int index = (int)(uintptr_t)pvar->ctx;
     /* Set the counter value to the current SPC value */
-    counter_value = (long long)ompi_spc_events[index].value;
+    counter_value = ompi_spc_value(index);
     /* If this is a timer-based counter, convert from cycles to microseconds */
     if( ompi_spc_events[index].is_timer_event ) {
         counter_value /= sys_clock_freq_mhz;
@@ -256,7 +315,21 @@ static void ompi_spc_events_init(void)
         ompi_spc_events[i].num_attached = 0;
         ompi_spc_events[i].is_high_watermark = ompi_spc_events_desc[i].is_high_watermark;
         ompi_spc_events[i].is_timer_event = ompi_spc_events_desc[i].is_timer_event;
+        /* The watermarks are compared and reset in place */
+        ompi_spc_events[i].is_shared = ompi_spc_events_desc[i].is_high_watermark;
+    }
+    for(i = 0; i < (int)(sizeof(ompi_spc_shared_counters) / sizeof(ompi_spc_shared_counters[0])); i++) {
+        ompi_spc_events[ompi_spc_shared_counters[i]].is_shared = true;
+    }
+
+#if OPAL_HAVE_THREAD_LOCAL
+    opal_mutex_lock(&ompi_spc_thread_counters_lock);
+    for(ompi_spc_thread_counters_t *counters = ompi_spc_thread_counters_list;
+        NULL != counters; counters = counters->next) {
+        memset(counters->values, 0, sizeof(counters->values));
     }
+    opal_mutex_unlock(&ompi_spc_thread_counters_lock);
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
 
     if (ompi_mpi_spc_dump_enabled) {
         ompi_comm_dup(&ompi_mpi_comm_world.comm, &ompi_spc_comm);
@@ -336,13 +409,6 @@ static void ompi_spc_dump(void)
     int rank = ompi_comm_rank(ompi_spc_comm);
     world_size = ompi_comm_size(ompi_spc_comm);
 
-    /* Convert from cycles to usecs before sending */
-    for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        if( ompi_spc_events[i].is_timer_event ) {
-            ompi_spc_events[i].value = ompi_spc_cycles_to_usecs_internal(ompi_spc_events[i].value);
-        }
-    }
-
     /* Aggregate all of the information on rank 0 using MPI_Gather on MPI_COMM_WORLD */
     send_buffer = (long long*)malloc(OMPI_SPC_NUM_COUNTERS * sizeof(long long));
     if (NULL == send_buffer) {
@@ -351,7 +417,11 @@ static void ompi_spc_dump(void)
         return;
     }
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        send_buffer[i] = (long long)ompi_spc_events[i].value;
+        send_buffer[i] = ompi_spc_value(i);
+        /* Convert from cycles to usecs before sending */
+        if( ompi_spc_events[i].is_timer_event ) {
+            send_buffer[i] = ompi_spc_cycles_to_usecs_internal(send_buffer[i]);
+        }
     }
     if( 0 == rank ) {
         recv_buffer = (long long*)malloc(world_size * OMPI_SPC_NUM_COUNTERS * sizeof(long long));
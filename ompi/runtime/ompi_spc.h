@@ -40,6 +40,9 @@
  *     SPC_TIMER_START and SPC_TIMER_STOP macros to record
  *     the time in cycles to then be converted to microseconds later
  *     in the ompi_spc_get_count function when requested by MPI_T
+ * 5.) If this counter is the value of a high watermark counter (see
+ *     SPC_UPDATE_WATERMARK), add it to the ompi_spc_shared_counters
+ *     array in ompi_spc.c so that it is not split across threads.
  */
 
 /* This enumeration serves as event ids for the various events */
@@ -160,14 +163,26 @@ typedef enum ompi_spc_counters {
  */
 typedef long long ompi_spc_value_t;
 
-/* A structure for storing the event data */
+/* A structure for storing the event data. Unless the counter is shared,
+ * value only holds the updates made without a per-thread block.
+ */
 typedef struct ompi_spc_s{
     opal_atomic_int64_t value;
     opal_atomic_int32_t num_attached;
     bool is_high_watermark;
     bool is_timer_event;
+    bool is_shared;
 } ompi_spc_t;
 
+/* Counters updated by a single thread. Each block is cache line aligned
+ * and padded so that threads never write to the same line. The blocks are
+ * summed up when a counter is read.
+ */
+typedef struct ompi_spc_thread_counters_s {
+    int64_t values[OMPI_SPC_NUM_COUNTERS];
+    struct ompi_spc_thread_counters_s *next;
+} ompi_spc_thread_counters_t;
+
 /* Definitions for using the SPC utility functions throughout the codebase.
  * If SPC_ENABLE is not 1, the macros become no-ops.
  */
@@ -184,6 +199,13 @@ void ompi_spc_cycles_to_usecs(opal_timer_t *cycles);
 OPAL_DECLSPEC extern
 ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS] __opal_attribute_aligned__(sizeof(ompi_spc_t));
 
+#if OPAL_HAVE_THREAD_LOCAL
+/* The counter block of the calling thread, allocated on first use */
+OPAL_DECLSPEC extern opal_thread_local ompi_spc_thread_counters_t *ompi_spc_thread_counters;
+
+OPAL_DECLSPEC ompi_spc_thread_counters_t *ompi_spc_thread_counters_create(void);
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+
 #define SPC_INIT()  \
     ompi_spc_init()
 
@@ -209,13 +231,34 @@ ompi_spc_t ompi_spc_events[OMPI_SPC_NUM_COUNTERS] __opal_attribute_aligned__(siz
     ompi_spc_update_watermark(watermark_enum, value_enum)
 
 
-/* Records an update to a counter using an atomic add operation. */
+/* Adds value to a counter. Shared counters, and all counters when there is
+ * no thread local storage, are updated with an atomic add operation.
+ */
+static inline
+void ompi_spc_add(unsigned int event_id, ompi_spc_value_t value)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    if( OPAL_LIKELY(!ompi_spc_events[event_id].is_shared) ) {
+        ompi_spc_thread_counters_t *counters = ompi_spc_thread_counters;
+        if( OPAL_UNLIKELY(NULL == counters) ) {
+            counters = ompi_spc_thread_counters_create();
+        }
+        if( OPAL_LIKELY(NULL != counters) ) {
+            counters->values[event_id] += value;
+            return;
+        }
+    }
+#endif  /* OPAL_HAVE_THREAD_LOCAL */
+    OPAL_THREAD_ADD_FETCH64(&(ompi_spc_events[event_id].value), value);
+}
+
+/* Records an update to a counter. */
 static inline
 void ompi_spc_record(unsigned int event_id, ompi_spc_value_t value)
 {
     /* Denoted unlikely because counters will often be turned off. */
     if( ompi_spc_events[event_id].num_attached > 0 ) {
-        OPAL_THREAD_ADD_FETCH64(&(ompi_spc_events[event_id].value), value);
+        ompi_spc_add(event_id, value);
     }
 }
 
@@ -241,7 +284,7 @@ void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_e
     if( watermark_event->num_attached &&
         value_event->num_attached ) {
         int64_t watermark = watermark_event->value;
-        int64_t value = watermark_event->value;
+        int64_t value = value_event->value;
         /* Try to atomically replace the watermark while the value is larger
          * (i.e, while no thread has replaced it with a larger value, including this thread) */
         while (value > watermark &&
@@ -276,7 +319,7 @@ void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles)
 {
     if( ompi_spc_events[event_id].num_attached > 0 && *cycles > 0 ) {
         *cycles = opal_timer_base_get_cycles() - *cycles;
-        OPAL_THREAD_ADD_FETCH64(&ompi_spc_events[event_id].value, *cycles);
+        ompi_spc_add(event_id, *cycles);
     }
 }
 
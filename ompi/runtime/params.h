@@ -145,6 +145,12 @@ OMPI_DECLSPEC extern bool ompi_use_sparse_group_storage;
  */
 OMPI_DECLSPEC extern uint32_t ompi_add_procs_cutoff;
 
+/**
+ * Minimum size of a request array for which MPI_Waitsome and
+ * MPI_Testsome use a completion queue (0 disables completion queues)
+ */
+OMPI_DECLSPEC extern int ompi_request_cq_threshold;
+
 /**
  * Whether anything in the code base has disabled MPI dynamic process
  * functionality or not
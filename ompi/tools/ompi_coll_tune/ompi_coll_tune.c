@@ -0,0 +1,800 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Generate the dynamic rules files of coll/tuned and coll/han for the
+ * local machine.
+ *
+ * For each collective, communicator size and message size, every
+ * algorithm of coll/tuned is timed: the algorithm is forced through its
+ * coll_tuned_<coll>_algorithm control variable, which coll/tuned reads
+ * when a communicator is created, and the communicator is duplicated with
+ * the ompi_comm_coll_preference info key so that coll/tuned provides its
+ * collectives. The fastest algorithm is then timed against the other
+ * collective components han can delegate to. The results are written in
+ * the formats read by coll_tuned_dynamic_file.c and
+ * coll_han_dynamic_file.c.
+ *
+ * Each measurement is the median over several rounds of the slowest
+ * process's average time per call, with the candidates interleaved in
+ * every round so that drift affects them all alike. Candidates slower
+ * than the best one by the pruning factor after the first rounds are not
+ * measured further, and an algorithm pruned at several consecutive
+ * message sizes of a communicator size is considered dominated and not
+ * measured for the larger ones.
+ *
+ * Run it on one node, with the process count of the largest
+ * communicator to tune:
+ *
+ *   mpirun -n 64 --mca coll_tuned_use_dynamic_rules 1 ompi_coll_tune
+ *   mpirun ... --mca coll_tuned_use_dynamic_rules 1 \
+ *              --mca coll_tuned_dynamic_rules_filename $PWD/ompi_coll_rules.tuned ...
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+#define NAME_LEN       128
+#define MAX_CANDIDATES 32
+#define MAX_ROUNDS     64
+#define MAX_SIZES      48
+#define MAX_ITERS      10000
+/* rounds measured before slow candidates are pruned */
+#define PRUNE_ROUNDS   3
+/* largest buffer allocated for the collectives whose buffers scale with
+ * the communicator size */
+#define MAX_BUFFER     (64 * 1024 * 1024)
+
+/* collective identifiers of ompi/mca/coll/base/coll_base_functions.h, as
+ * written in the coll/tuned rules file */
+enum {
+    ALLGATHER = 0,
+    ALLREDUCE = 2,
+    ALLTOALL = 3,
+    BARRIER = 6,
+    BCAST = 7,
+    GATHER = 9,
+    REDUCE = 11,
+    REDUCESCATTERBLOCK = 13,
+    SCATTER = 15
+};
+
+typedef struct {
+    const char *name;
+    int id;
+    /* fanout control variable used when the algorithm is forced */
+    const char *fanout;
+    /* coll/tuned looks up the rules with the message size times the
+     * communicator size */
+    int scaled;
+    int reduction;
+    /* components han may use for this collective, NULL when han has no
+     * dynamic rules for it */
+    const char *han_components;
+} coll_desc_t;
+
+static const coll_desc_t colls[] = {
+    {"allgather", ALLGATHER, "tree", 1, 0, "tuned,basic"},
+    {"allreduce", ALLREDUCE, "tree", 0, 1, "tuned,basic,sm"},
+    {"alltoall", ALLTOALL, "tree", 1, 0, NULL},
+    {"barrier", BARRIER, "tree", 0, 0, "tuned,basic,sm"},
+    {"bcast", BCAST, "chain", 0, 0, "tuned,basic,sm,adapt"},
+    {"gather", GATHER, "tree", 1, 0, "tuned,basic"},
+    {"reduce", REDUCE, "chain", 0, 1, "tuned,basic,sm,adapt"},
+    {"reduce_scatter_block", REDUCESCATTERBLOCK, "chain", 1, 1, NULL},
+    {"scatter", SCATTER, "chain", 1, 0, "tuned,basic"},
+};
+#define NUM_COLLS ((int) (sizeof(colls) / sizeof(colls[0])))
+
+typedef struct {
+    char label[NAME_LEN];
+    int value; /* algorithm number, or index in the han component list */
+    MPI_Comm comm;
+    int active;
+    int failed;    /* could not run, not tried again */
+    int dominated; /* consecutive message sizes at which it was pruned */
+    double times[MAX_ROUNDS];
+    double median;
+} candidate_t;
+
+typedef struct {
+    int alg;
+    int component;
+} result_t;
+
+static struct {
+    int rounds;
+    double target;
+    double prune;
+    int dominate;
+    size_t max_block;
+    const char *prefix;
+    int verbose;
+} options = {7, 5e-3, 1.5, 3, 1 << 20, "ompi_coll_rules", 0};
+
+static int world_rank, world_size;
+static char *sbuf, *rbuf;
+static size_t buffer_size;
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ompi_coll_tune [-c coll,...] [-m max_size] [-r rounds] [-t ms] [-p factor]\n"
+            "                      [-d count] [-o prefix] [-v]\n"
+            "  -c  collectives to tune (default: all)\n"
+            "  -m  largest message size per process in bytes (default: %zu)\n"
+            "  -r  rounds per measurement, the median is kept (default: %d)\n"
+            "  -t  time of one round in milliseconds (default: %g)\n"
+            "  -p  prune candidates slower than the best by this factor (default: %g)\n"
+            "  -d  drop algorithms pruned at this many consecutive sizes, 0 never (default: %d)\n"
+            "  -o  prefix of the rules files (default: %s)\n"
+            "  -v  print the time of every candidate\n",
+            options.max_block, options.rounds, options.target * 1e3, options.prune,
+            options.dominate, options.prefix);
+}
+
+static int cvar_handle(const char *name, MPI_T_cvar_handle *handle)
+{
+    int index, count;
+
+    if (MPI_SUCCESS != MPI_T_cvar_get_index(name, &index)) {
+        return -1;
+    }
+    if (MPI_SUCCESS != MPI_T_cvar_handle_alloc(index, NULL, handle, &count)) {
+        return -1;
+    }
+    return index;
+}
+
+static int cvar_read_int(const char *name, int *value)
+{
+    MPI_T_cvar_handle handle;
+    int rc;
+
+    if (0 > cvar_handle(name, &handle)) {
+        return MPI_ERR_OTHER;
+    }
+    rc = MPI_T_cvar_read(handle, value);
+    MPI_T_cvar_handle_free(&handle);
+    return rc;
+}
+
+static int cvar_write_int(const char *name, int value)
+{
+    MPI_T_cvar_handle handle;
+    int rc;
+
+    if (0 > cvar_handle(name, &handle)) {
+        return MPI_ERR_OTHER;
+    }
+    rc = MPI_T_cvar_write(handle, &value);
+    MPI_T_cvar_handle_free(&handle);
+    return rc;
+}
+
+/* The algorithms of a collective, from the enumerator of its control
+ * variable. Algorithm 0 lets coll/tuned decide and is not listed. */
+static int list_algorithms(const coll_desc_t *coll, candidate_t *cands)
+{
+    char name[NAME_LEN], desc[256];
+    int name_len = sizeof(name), desc_len = sizeof(desc);
+    int verbosity, bind, scope, index, num, count = 0;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm", coll->name);
+    if (MPI_SUCCESS != MPI_T_cvar_get_index(name, &index)
+        || MPI_SUCCESS != MPI_T_cvar_get_info(index, name, &name_len, &verbosity, &datatype,
+                                              &enumtype, desc, &desc_len, &bind, &scope)
+        || MPI_T_ENUM_NULL == enumtype) {
+        return 0;
+    }
+    name_len = sizeof(name);
+    MPI_T_enum_get_info(enumtype, &num, name, &name_len);
+    for (int i = 0; i < num && count < MAX_CANDIDATES; ++i) {
+        int value;
+
+        name_len = sizeof(name);
+        if (MPI_SUCCESS != MPI_T_enum_get_item(enumtype, i, &value, name, &name_len)
+            || 0 == value) {
+            continue;
+        }
+        memset(cands + count, 0, sizeof(*cands));
+        snprintf(cands[count].label, NAME_LEN, "%s", name);
+        cands[count].value = value;
+        cands[count].comm = MPI_COMM_NULL;
+        ++count;
+    }
+
+    return count;
+}
+
+static MPI_Comm dup_with_preference(MPI_Comm comm, const char *preference)
+{
+    MPI_Comm newcomm = MPI_COMM_NULL;
+    MPI_Info info;
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "ompi_comm_coll_preference", preference);
+    if (MPI_SUCCESS != MPI_Comm_dup_with_info(comm, info, &newcomm)) {
+        newcomm = MPI_COMM_NULL;
+    }
+    MPI_Info_free(&info);
+
+    return newcomm;
+}
+
+static int run_coll(const coll_desc_t *coll, MPI_Comm comm, size_t block)
+{
+    MPI_Datatype type = coll->reduction ? MPI_INT : MPI_BYTE;
+    int count = (int) (coll->reduction ? block / sizeof(int) : block);
+
+    switch (coll->id) {
+    case ALLGATHER:
+        return MPI_Allgather(sbuf, count, type, rbuf, count, type, comm);
+    case ALLREDUCE:
+        return MPI_Allreduce(sbuf, rbuf, count, type, MPI_SUM, comm);
+    case ALLTOALL:
+        return MPI_Alltoall(sbuf, count, type, rbuf, count, type, comm);
+    case BARRIER:
+        return MPI_Barrier(comm);
+    case BCAST:
+        return MPI_Bcast(sbuf, count, type, 0, comm);
+    case GATHER:
+        return MPI_Gather(sbuf, count, type, rbuf, count, type, 0, comm);
+    case REDUCE:
+        return MPI_Reduce(sbuf, rbuf, count, type, MPI_SUM, 0, comm);
+    case REDUCESCATTERBLOCK:
+        return MPI_Reduce_scatter_block(sbuf, rbuf, count, type, MPI_SUM, comm);
+    case SCATTER:
+        return MPI_Scatter(sbuf, count, type, rbuf, count, type, 0, comm);
+    }
+    return MPI_ERR_OTHER;
+}
+
+/* Time per call of the slowest process, HUGE_VAL if any process failed */
+static double time_round(const coll_desc_t *coll, MPI_Comm comm, size_t block, int iters)
+{
+    double t;
+    int rc = MPI_SUCCESS;
+
+    MPI_Barrier(comm);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters && MPI_SUCCESS == rc; ++i) {
+        rc = run_coll(coll, comm, block);
+    }
+    t = MPI_SUCCESS == rc ? (MPI_Wtime() - t) / iters : HUGE_VAL;
+    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    return t;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static double median(const double *values, int n, double *mad)
+{
+    double sorted[MAX_ROUNDS], med;
+
+    memcpy(sorted, values, (size_t) n * sizeof(double));
+    qsort(sorted, (size_t) n, sizeof(double), compare_double);
+    med = (n & 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    if (NULL != mad) {
+        for (int i = 0; i < n; ++i) {
+            sorted[i] = fabs(values[i] - med);
+        }
+        qsort(sorted, (size_t) n, sizeof(double), compare_double);
+        *mad = (n & 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    }
+    return med;
+}
+
+/*
+ * Measure the candidates that are not dominated and return the index of
+ * the fastest one, or -1 if none could run. All the decisions are taken on
+ * reduced values, so all the processes of the communicator agree on them.
+ */
+static int measure(const coll_desc_t *coll, candidate_t *cands, int n, size_t block)
+{
+    int iters[MAX_CANDIDATES], best = -1, measured = 0;
+    double best_median = HUGE_VAL;
+
+    for (int c = 0; c < n; ++c) {
+        cands[c].median = 0.0;
+        cands[c].active = MPI_COMM_NULL != cands[c].comm && !cands[c].failed
+                          && (0 == options.dominate || cands[c].dominated < options.dominate);
+        if (!cands[c].active) {
+            continue;
+        }
+        /* the first call warms up the algorithm, the second one sizes the rounds */
+        double t = time_round(coll, cands[c].comm, block, 1);
+        if (HUGE_VAL != t) {
+            t = time_round(coll, cands[c].comm, block, 1);
+        }
+        if (HUGE_VAL == t) {
+            cands[c].active = 0;
+            cands[c].failed = 1;
+            continue;
+        }
+        iters[c] = t >= options.target ? 1 : (int) (options.target / (t > 0.0 ? t : 1e-9));
+        iters[c] = iters[c] > MAX_ITERS ? MAX_ITERS : iters[c];
+    }
+
+    for (int round = 0; round < options.rounds; ++round) {
+        /* rotate the order so that no candidate always runs first */
+        for (int k = 0; k < n; ++k) {
+            int c = (k + round) % n;
+            if (cands[c].active) {
+                cands[c].times[round] = time_round(coll, cands[c].comm, block, iters[c]);
+            }
+        }
+        if (PRUNE_ROUNDS - 1 != round || options.rounds <= PRUNE_ROUNDS) {
+            continue;
+        }
+        for (int c = 0; c < n; ++c) {
+            if (cands[c].active) {
+                double m = median(cands[c].times, round + 1, NULL);
+                best_median = m < best_median ? m : best_median;
+            }
+        }
+        for (int c = 0; c < n; ++c) {
+            if (!cands[c].active) {
+                continue;
+            }
+            double fastest = median(cands[c].times, round + 1, NULL);
+            for (int r = 0; r <= round; ++r) {
+                fastest = cands[c].times[r] < fastest ? cands[c].times[r] : fastest;
+            }
+            if (fastest > options.prune * best_median) {
+                cands[c].active = 0;
+                cands[c].median = median(cands[c].times, round + 1, NULL);
+                ++cands[c].dominated;
+            }
+        }
+    }
+
+    best_median = HUGE_VAL;
+    for (int c = 0; c < n; ++c) {
+        if (!cands[c].active) {
+            continue;
+        }
+        ++measured;
+        cands[c].dominated = 0;
+        cands[c].median = median(cands[c].times, options.rounds, NULL);
+        if (cands[c].median < best_median) {
+            best_median = cands[c].median;
+            best = c;
+        }
+    }
+
+    if (0 == world_rank && options.verbose) {
+        for (int c = 0; c < n; ++c) {
+            if (cands[c].median > 0.0) {
+                printf("    %-28s %12.2f us%s\n", cands[c].label, cands[c].median * 1e6,
+                       cands[c].active ? "" : " (pruned)");
+            }
+        }
+    }
+    if (0 == world_rank && best >= 0) {
+        double mad;
+        median(cands[best].times, options.rounds, &mad);
+        printf("    -> %-25s %12.2f us +- %.1f%% (%d of %d candidates fully measured)\n",
+               cands[best].label, best_median * 1e6, 100.0 * mad / best_median, measured, n);
+    }
+
+    return best;
+}
+
+static void free_candidates(candidate_t *cands, int n)
+{
+    for (int c = 0; c < n; ++c) {
+        if (MPI_COMM_NULL != cands[c].comm) {
+            MPI_Comm_free(&cands[c].comm);
+        }
+    }
+}
+
+static int tune_comm_size(const coll_desc_t *coll, MPI_Comm comm, const size_t *blocks,
+                          int nblocks, result_t *results)
+{
+    candidate_t algs[MAX_CANDIDATES], comps[MAX_CANDIDATES];
+    char name[NAME_LEN], *han_list = NULL;
+    int size, nalgs, ncomps = 0, saved = 0;
+
+    MPI_Comm_size(comm, &size);
+    nalgs = list_algorithms(coll, algs);
+
+    /* one communicator per algorithm, coll/tuned reads the forced
+     * algorithm when it is created */
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm", coll->name);
+    cvar_read_int(name, &saved);
+    for (int a = 0; a < nalgs; ++a) {
+        if (MPI_SUCCESS == cvar_write_int(name, algs[a].value)) {
+            algs[a].comm = dup_with_preference(comm, "tuned");
+        }
+    }
+    cvar_write_int(name, saved);
+
+    if (NULL != coll->han_components) {
+        char *tok, *save = NULL;
+
+        han_list = strdup(coll->han_components);
+        for (tok = strtok_r(han_list, ",", &save); NULL != tok && ncomps < MAX_CANDIDATES;
+             tok = strtok_r(NULL, ",", &save)) {
+            char preference[NAME_LEN];
+
+            memset(comps + ncomps, 0, sizeof(*comps));
+            snprintf(comps[ncomps].label, NAME_LEN, "%s", tok);
+            comps[ncomps].value = ncomps;
+            comps[ncomps].comm = MPI_COMM_NULL;
+            if (0 != strcmp(tok, "tuned")) {
+                /* basic provides what the component does not implement */
+                snprintf(preference, sizeof(preference), "%s%s,^han,tuned", tok,
+                         0 == strcmp(tok, "basic") ? "" : ",basic");
+                comps[ncomps].comm = dup_with_preference(comm, preference);
+            }
+            ++ncomps;
+        }
+    }
+
+    for (int b = 0; b < nblocks; ++b) {
+        int best;
+
+        results[b].alg = results[b].component = -1;
+        if (coll->scaled && blocks[b] * (size_t) size > buffer_size) {
+            continue;
+        }
+        if (0 == world_rank) {
+            printf("  %s, %d processes, %zu bytes\n", coll->name, size, blocks[b]);
+        }
+        best = measure(coll, algs, nalgs, blocks[b]);
+        if (best < 0) {
+            continue;
+        }
+        results[b].alg = algs[best].value;
+
+        if (0 == ncomps) {
+            continue;
+        }
+        /* coll/tuned takes part with its fastest algorithm, which is what
+         * it will use once the rules are installed */
+        for (int c = 0; c < ncomps; ++c) {
+            if (0 == strcmp(comps[c].label, "tuned")) {
+                comps[c].comm = algs[best].comm;
+                comps[c].failed = comps[c].dominated = 0;
+            }
+        }
+        best = measure(coll, comps, ncomps, blocks[b]);
+        results[b].component = best;
+        for (int c = 0; c < ncomps; ++c) {
+            if (0 == strcmp(comps[c].label, "tuned")) {
+                comps[c].comm = MPI_COMM_NULL;
+            }
+        }
+    }
+
+    free_candidates(algs, nalgs);
+    free_candidates(comps, ncomps);
+    free(han_list);
+
+    return MPI_SUCCESS;
+}
+
+static const char *han_component(const coll_desc_t *coll, int index)
+{
+    static char name[NAME_LEN];
+    const char *list = coll->han_components;
+
+    for (int i = 0; i < index; ++i) {
+        list = strchr(list, ',') + 1;
+    }
+    snprintf(name, sizeof(name), "%.*s", (int) strcspn(list, ","), list);
+    return name;
+}
+
+static void write_tuned_rules(FILE *f, const int *tuned, const int *csizes, int ncsizes,
+                              const size_t *blocks, int nblocks, const result_t *results)
+{
+    int ncolls = 0;
+
+    for (int i = 0; i < NUM_COLLS; ++i) {
+        ncolls += tuned[i];
+    }
+    fprintf(f, "# coll/tuned rules generated by ompi_coll_tune\n");
+    fprintf(f, "%d # number of collectives\n", ncolls);
+    for (int i = 0; i < NUM_COLLS; ++i) {
+        const coll_desc_t *coll = colls + i;
+        char name[NAME_LEN];
+        int faninout = 0, segsize = 0, ncomms = 0;
+
+        if (!tuned[i]) {
+            continue;
+        }
+        /* the rules reproduce the fanout and segment size used when the
+         * algorithms were forced */
+        snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_%s_fanout", coll->name,
+                 coll->fanout);
+        cvar_read_int(name, &faninout);
+        snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_segmentsize", coll->name);
+        cvar_read_int(name, &segsize);
+
+        for (int s = 0; s < ncsizes; ++s) {
+            const result_t *r = results + ((size_t) i * ncsizes + s) * nblocks;
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].alg > 0) {
+                    ++ncomms;
+                    break;
+                }
+            }
+        }
+
+        fprintf(f, "%d # collective %s\n", coll->id, coll->name);
+        fprintf(f, "%d # number of communicator sizes\n", ncomms);
+        for (int s = 0; s < ncsizes; ++s) {
+            const result_t *r = results + ((size_t) i * ncsizes + s) * nblocks;
+            int nrules = 0, last = -1;
+
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].alg > 0 && r[b].alg != last) {
+                    ++nrules;
+                    last = r[b].alg;
+                }
+            }
+            if (0 == nrules) {
+                continue;
+            }
+            fprintf(f, "%d # communicator size\n", csizes[s]);
+            fprintf(f, "%d # number of message sizes\n", nrules);
+            last = -1;
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].alg <= 0 || r[b].alg == last) {
+                    continue;
+                }
+                size_t msg_size = -1 == last ? 0
+                                             : blocks[b] * (coll->scaled ? (size_t) csizes[s] : 1);
+                fprintf(f, "%zu %d %d %d # message size, algorithm, faninout, segment size\n",
+                        msg_size, r[b].alg, faninout, segsize);
+                last = r[b].alg;
+            }
+        }
+    }
+}
+
+static void write_han_rules(FILE *f, const int *tuned, const int *csizes, int ncsizes,
+                            const size_t *blocks, int nblocks, const result_t *results)
+{
+    int ncolls = 0;
+
+    for (int i = 0; i < NUM_COLLS; ++i) {
+        ncolls += tuned[i] && NULL != colls[i].han_components;
+    }
+    fprintf(f, "# coll/han rules generated by ompi_coll_tune\n");
+    fprintf(f, "%d # number of collectives\n", ncolls);
+    for (int i = 0; i < NUM_COLLS; ++i) {
+        const coll_desc_t *coll = colls + i;
+        int nconfs = 0, written = 0;
+
+        if (!tuned[i] || NULL == coll->han_components) {
+            continue;
+        }
+        for (int s = 0; s < ncsizes; ++s) {
+            const result_t *r = results + ((size_t) i * ncsizes + s) * nblocks;
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].component >= 0) {
+                    ++nconfs;
+                    break;
+                }
+            }
+        }
+
+        fprintf(f, "%s\n", coll->name);
+        fprintf(f, "1 # number of topological levels\n");
+        fprintf(f, "0 # intra_node\n");
+        fprintf(f, "%d # number of configurations\n", nconfs);
+        for (int s = 0; s < ncsizes; ++s) {
+            const result_t *r = results + ((size_t) i * ncsizes + s) * nblocks;
+            int nrules = 0, last = -1;
+
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].component >= 0 && r[b].component != last) {
+                    ++nrules;
+                    last = r[b].component;
+                }
+            }
+            if (0 == nrules) {
+                continue;
+            }
+            /* han requires the first configuration of a level to start at 1.
+             * the smallest measured size then covers everything below it */
+            fprintf(f, "%d # processes per node\n", 0 == written++ ? 1 : csizes[s]);
+            fprintf(f, "%d # number of message sizes\n", nrules);
+            last = -1;
+            for (int b = 0; b < nblocks; ++b) {
+                if (r[b].component < 0 || r[b].component == last) {
+                    continue;
+                }
+                fprintf(f, "%zu %s\n", -1 == last ? (size_t) 0 : blocks[b],
+                        han_component(coll, r[b].component));
+                last = r[b].component;
+            }
+        }
+    }
+}
+
+static int write_rules(const char *suffix, const int *tuned, const int *csizes, int ncsizes,
+                       const size_t *blocks, int nblocks, const result_t *results)
+{
+    char fname[1024];
+    FILE *f;
+
+    snprintf(fname, sizeof(fname), "%s.%s", options.prefix, suffix);
+    if (NULL == (f = fopen(fname, "w"))) {
+        fprintf(stderr, "ompi_coll_tune: can not write %s\n", fname);
+        return 1;
+    }
+    if (0 == strcmp(suffix, "tuned")) {
+        write_tuned_rules(f, tuned, csizes, ncsizes, blocks, nblocks, results);
+    } else {
+        write_han_rules(f, tuned, csizes, ncsizes, blocks, nblocks, results);
+    }
+    fclose(f);
+    printf("wrote %s\n", fname);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int tuned[NUM_COLLS], csizes[MAX_SIZES], ncsizes = 0, nblocks, provided, opt;
+    int dynamic = 0, local_size, rc = 0;
+    size_t blocks[MAX_SIZES];
+    const char *only = NULL;
+    result_t *results;
+    MPI_Comm local;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    while (-1 != (opt = getopt(argc, argv, "c:m:r:t:p:d:o:vh"))) {
+        switch (opt) {
+        case 'c': only = optarg; break;
+        case 'm': options.max_block = strtoul(optarg, NULL, 0); break;
+        case 'r': options.rounds = atoi(optarg); break;
+        case 't': options.target = atof(optarg) * 1e-3; break;
+        case 'p': options.prune = atof(optarg); break;
+        case 'd': options.dominate = atoi(optarg); break;
+        case 'o': options.prefix = optarg; break;
+        case 'v': options.verbose = 1; break;
+        default:
+            if (0 == world_rank) {
+                usage();
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if (options.rounds < 1 || options.rounds > MAX_ROUNDS || options.prune < 1.0
+        || options.target <= 0.0 || options.max_block < sizeof(int)) {
+        if (0 == world_rank) {
+            usage();
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (MPI_SUCCESS != MPI_T_init_thread(MPI_THREAD_SINGLE, &provided)) {
+        fprintf(stderr, "ompi_coll_tune: MPI_T_init_thread failed\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    /* without it coll/tuned ignores the forced algorithms */
+    if (MPI_SUCCESS != cvar_read_int("coll_tuned_use_dynamic_rules", &dynamic) || !dynamic) {
+        if (0 == world_rank) {
+            fprintf(stderr, "ompi_coll_tune: run with --mca coll_tuned_use_dynamic_rules 1\n");
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &local);
+    MPI_Comm_size(local, &local_size);
+    MPI_Comm_free(&local);
+    if (0 == world_rank && local_size != world_size) {
+        fprintf(stderr, "ompi_coll_tune: warning: the processes span several nodes, the han "
+                        "rules are written for the intra-node level\n");
+    }
+
+    for (int size = 2; size < world_size && ncsizes < MAX_SIZES - 1; size *= 2) {
+        csizes[ncsizes++] = size;
+    }
+    csizes[ncsizes++] = world_size;
+    for (nblocks = 0; nblocks < MAX_SIZES; ++nblocks) {
+        blocks[nblocks] = (size_t) sizeof(int) << (2 * nblocks);
+        if (blocks[nblocks] > options.max_block) {
+            break;
+        }
+    }
+
+    buffer_size = options.max_block * (size_t) world_size;
+    if (buffer_size > MAX_BUFFER) {
+        buffer_size = options.max_block > MAX_BUFFER ? options.max_block : MAX_BUFFER;
+    }
+    sbuf = calloc(1, buffer_size);
+    rbuf = calloc(1, buffer_size);
+    results = calloc((size_t) NUM_COLLS * ncsizes * nblocks, sizeof(*results));
+    if (NULL == sbuf || NULL == rbuf || NULL == results) {
+        fprintf(stderr, "ompi_coll_tune: out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    for (int i = 0; i < NUM_COLLS; ++i) {
+        const coll_desc_t *coll = colls + i;
+        size_t len = strlen(coll->name);
+        const char *p = only;
+
+        tuned[i] = NULL == only;
+        while (NULL != p && !tuned[i]) {
+            tuned[i] = 0 == strncmp(p, coll->name, len) && (',' == p[len] || '\0' == p[len]);
+            p = strchr(p, ',');
+            p = NULL != p ? p + 1 : NULL;
+        }
+        if (!tuned[i]) {
+            continue;
+        }
+
+        for (int s = 0; s < ncsizes; ++s) {
+            result_t *r = results + ((size_t) i * ncsizes + s) * nblocks;
+            MPI_Comm comm;
+
+            MPI_Comm_split(MPI_COMM_WORLD, world_rank < csizes[s] ? 0 : MPI_UNDEFINED,
+                           world_rank, &comm);
+            if (MPI_COMM_NULL != comm) {
+                MPI_Comm_set_errhandler(comm, MPI_ERRORS_RETURN);
+                tune_comm_size(coll, comm, blocks, BARRIER == coll->id ? 1 : nblocks, r);
+                MPI_Comm_free(&comm);
+            }
+            if (BARRIER == coll->id) {
+                for (int b = 1; b < nblocks; ++b) {
+                    r[b].alg = r[b].component = -1;
+                }
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+
+    if (0 == world_rank) {
+        rc = write_rules("tuned", tuned, csizes, ncsizes, blocks, nblocks, results);
+        rc |= write_rules("han", tuned, csizes, ncsizes, blocks, nblocks, results);
+        if (0 == rc) {
+            printf("use them with\n"
+                   "  --mca coll_tuned_use_dynamic_rules 1 "
+                   "--mca coll_tuned_dynamic_rules_filename %s.tuned\n"
+                   "  --mca coll_han_use_dynamic_file_rules 1 "
+                   "--mca coll_han_dynamic_rules_filename %s.han\n",
+                   options.prefix, options.prefix);
+        }
+    }
+
+    free(results);
+    free(sbuf);
+    free(rbuf);
+
+    MPI_T_finalize();
+    MPI_Finalize();
+    return rc;
+}
@@ -0,0 +1,170 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Report where MPI_Init spends its time.
+ *
+ * Every process reads the mpi_init_time_* MPI_T performance variables,
+ * which hold the time spent in each phase of its own startup, and the
+ * minimum, average and maximum over all processes are printed by rank 0
+ * together with the slowest rank. Run it with the same launcher, process
+ * count and MCA parameters as the application of interest:
+ *
+ *   mpirun -n 512 --mca btl self,sm,tcp ompi_init_timing
+ *
+ * The report takes three reductions, whatever the number of phases.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+#define PREFIX "mpi_init_time_"
+#define NAME_LEN 128
+
+/* Names of the phases of this process, in registration order */
+static int collect_phases(char **names_out)
+{
+    char *names = NULL;
+    int num, count = 0;
+
+    MPI_T_pvar_get_num(&num);
+    for (int i = 0; i < num; ++i) {
+        char name[NAME_LEN], desc[256];
+        int name_len = sizeof(name), desc_len = sizeof(desc);
+        int verbosity, var_class, bind, readonly, continuous, atomic;
+        MPI_Datatype datatype;
+        MPI_T_enum enumtype;
+
+        if (MPI_SUCCESS != MPI_T_pvar_get_info(i, name, &name_len, &verbosity, &var_class,
+                                               &datatype, &enumtype, desc, &desc_len, &bind,
+                                               &readonly, &continuous, &atomic)) {
+            continue;
+        }
+        if (0 != strncmp(name, PREFIX, strlen(PREFIX)) || MPI_DOUBLE != datatype) {
+            continue;
+        }
+        names = realloc(names, (size_t) (count + 1) * NAME_LEN);
+        if (NULL == names) {
+            fprintf(stderr, "ompi_init_timing: out of memory\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        strncpy(names + (size_t) count * NAME_LEN, name, NAME_LEN);
+        ++count;
+    }
+
+    *names_out = names;
+    return count;
+}
+
+static double read_phase(MPI_T_pvar_session session, const char *name)
+{
+    MPI_T_pvar_handle handle;
+    double value = 0.0;
+    int index, count;
+
+    /* a phase rank 0 went through may not exist here, e.g. a framework
+     * that was only opened on some nodes */
+    if (MPI_SUCCESS != MPI_T_pvar_get_index(name, MPI_T_PVAR_CLASS_GENERIC, &index)) {
+        return 0.0;
+    }
+    if (MPI_SUCCESS != MPI_T_pvar_handle_alloc(session, index, NULL, &handle, &count)) {
+        return 0.0;
+    }
+    if (1 != count || MPI_SUCCESS != MPI_T_pvar_read(session, handle, &value)) {
+        value = 0.0;
+    }
+    MPI_T_pvar_handle_free(session, &handle);
+
+    return value;
+}
+
+int main(int argc, char **argv)
+{
+    struct {
+        double value;
+        int rank;
+    } *local, *min, *max;
+    double *values, *sum;
+    MPI_T_pvar_session session;
+    char *names = NULL;
+    int rank, size, provided, count = 0;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (MPI_SUCCESS != MPI_T_init_thread(MPI_THREAD_SINGLE, &provided)) {
+        fprintf(stderr, "ompi_init_timing: MPI_T_init_thread failed\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    /* all processes report the phases of rank 0, in the same order */
+    if (0 == rank) {
+        count = collect_phases(&names);
+    }
+    MPI_Bcast(&count, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (0 == count) {
+        if (0 == rank) {
+            fprintf(stderr, "ompi_init_timing: no " PREFIX "* variables found\n");
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+    if (0 != rank) {
+        names = malloc((size_t) count * NAME_LEN);
+    }
+    local = malloc((size_t) count * sizeof(*local));
+    min = malloc((size_t) count * sizeof(*min));
+    max = malloc((size_t) count * sizeof(*max));
+    values = malloc((size_t) count * sizeof(*values));
+    sum = malloc((size_t) count * sizeof(*sum));
+    if (NULL == names || NULL == local || NULL == min || NULL == max || NULL == values
+        || NULL == sum) {
+        fprintf(stderr, "ompi_init_timing: out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Bcast(names, count * NAME_LEN, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    MPI_T_pvar_session_create(&session);
+    for (int i = 0; i < count; ++i) {
+        values[i] = read_phase(session, names + (size_t) i * NAME_LEN);
+        local[i].value = values[i];
+        local[i].rank = rank;
+    }
+    MPI_T_pvar_session_free(&session);
+
+    MPI_Reduce(local, min, count, MPI_DOUBLE_INT, MPI_MINLOC, 0, MPI_COMM_WORLD);
+    MPI_Reduce(local, max, count, MPI_DOUBLE_INT, MPI_MAXLOC, 0, MPI_COMM_WORLD);
+    MPI_Reduce(values, sum, count, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (0 == rank) {
+        printf("MPI_Init phases over %d processes, in seconds\n", size);
+        printf("%-48s %12s %12s %12s %10s\n", "phase", "min", "avg", "max", "max rank");
+        for (int i = 0; i < count; ++i) {
+            printf("%-48s %12.6f %12.6f %12.6f %10d\n",
+                   names + (size_t) i * NAME_LEN + strlen(PREFIX), min[i].value,
+                   sum[i] / size, max[i].value, max[i].rank);
+        }
+    }
+
+    free(names);
+    free(local);
+    free(min);
+    free(max);
+    free(values);
+    free(sum);
+
+    MPI_T_finalize();
+    MPI_Finalize();
+    return 0;
+}
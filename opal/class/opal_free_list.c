@@ -29,13 +29,281 @@
 #include "opal/mca/mpool/base/base.h"
 #include "opal/mca/mpool/mpool.h"
 #include "opal/mca/rcache/rcache.h"
+#include "opal/runtime/opal_params.h"
 #include "opal/util/output.h"
 #include "opal/util/sys_limits.h"
 
+#include <stdlib.h>
+
 typedef struct opal_free_list_item_t opal_free_list_memory_t;
 
 OBJ_CLASS_INSTANCE(opal_free_list_item_t, opal_list_item_t, NULL, NULL);
 
+/*
+ * Per-thread magazine caches.
+ *
+ * Each thread is mapped to one of OPAL_FREE_LIST_NUM_CACHES cache slots. A
+ * slot holds two magazines (arrays of up to fl_magazine_size items) and only
+ * touches the shared LIFO when both are exhausted (get) or full (return), in
+ * which case a whole magazine is exchanged with the depot
+ * (fl_full_magazines/fl_empty_magazines). More than one thread may map to
+ * the same slot, so slots are protected by a spinlock. A thread that fails to
+ * acquire the spinlock goes straight to the shared LIFO.
+ */
+#define OPAL_FREE_LIST_NUM_CACHES 64
+
+/* compile-time constant for padding the cache slots (see SM_CACHE_LINE_PAD) */
+#define OPAL_FREE_LIST_CACHE_PAD 128
+
+struct opal_free_list_magazine_t {
+    opal_list_item_t super;
+    /** number of valid entries in items */
+    int count;
+    opal_free_list_item_t *items[];
+};
+typedef struct opal_free_list_magazine_t opal_free_list_magazine_t;
+
+/* the pointers come first so the padding does not have to account for an
+ * alignment hole after the lock */
+struct opal_free_list_cache_t {
+    /** magazine items are taken from/returned to */
+    opal_free_list_magazine_t *loaded;
+    /** previously loaded magazine */
+    opal_free_list_magazine_t *previous;
+    opal_atomic_lock_t lock;
+    char padding[OPAL_FREE_LIST_CACHE_PAD - sizeof(opal_atomic_lock_t) - 2 * sizeof(void *)];
+} __opal_attribute_aligned__(OPAL_FREE_LIST_CACHE_PAD);
+typedef struct opal_free_list_cache_t opal_free_list_cache_t;
+
+static opal_atomic_int32_t opal_free_list_next_cache_index = 0;
+#if OPAL_HAVE_THREAD_LOCAL
+static opal_thread_local int opal_free_list_cache_index = -1;
+#endif
+
+static inline opal_free_list_cache_t *opal_free_list_local_cache(opal_free_list_t *fl)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    if (OPAL_UNLIKELY(-1 == opal_free_list_cache_index)) {
+        opal_free_list_cache_index = opal_atomic_fetch_add_32(&opal_free_list_next_cache_index, 1)
+                                     & 0x7fffffff;
+    }
+
+    return fl->fl_caches + (opal_free_list_cache_index % fl->fl_num_caches);
+#else
+    /* caches are never enabled without thread local storage */
+    return fl->fl_caches;
+#endif
+}
+
+static opal_free_list_magazine_t *opal_free_list_magazine_alloc(opal_free_list_t *fl)
+{
+    opal_free_list_magazine_t *mag;
+
+    mag = (opal_free_list_magazine_t *) malloc(sizeof(*mag)
+                                               + fl->fl_magazine_size * sizeof(mag->items[0]));
+    if (OPAL_LIKELY(NULL != mag)) {
+        OBJ_CONSTRUCT(&mag->super, opal_list_item_t);
+        mag->count = 0;
+    }
+
+    return mag;
+}
+
+static void opal_free_list_magazine_release(opal_free_list_magazine_t *mag)
+{
+    OBJ_DESTRUCT(&mag->super);
+    free(mag);
+}
+
+/* move the content of a magazine to the shared LIFO */
+static size_t opal_free_list_magazine_drain(opal_free_list_t *fl, opal_free_list_magazine_t *mag)
+{
+    size_t count = mag->count;
+
+    while (mag->count > 0) {
+        opal_lifo_push_atomic(&fl->super, &mag->items[--mag->count]->super);
+    }
+
+    return count;
+}
+
+static int opal_free_list_caches_init(opal_free_list_t *fl)
+{
+    size_t capacity;
+    int rc;
+
+    /* caches are only useful (and safe to index) with thread local storage */
+    if (!OPAL_HAVE_THREAD_LOCAL || !opal_using_threads() || 0 >= opal_free_list_magazine_size
+        || NULL != fl->fl_caches) {
+        return OPAL_SUCCESS;
+    }
+
+    /* small bounded lists are typically used with opal_free_list_wait and
+     * should not have a large fraction of their items parked in caches */
+    capacity = (size_t) OPAL_FREE_LIST_NUM_CACHES * 2 * opal_free_list_magazine_size;
+    if (0 != fl->fl_max_to_alloc && fl->fl_max_to_alloc < 4 * capacity) {
+        return OPAL_SUCCESS;
+    }
+
+    rc = posix_memalign((void **) &fl->fl_caches, OPAL_FREE_LIST_CACHE_PAD,
+                        OPAL_FREE_LIST_NUM_CACHES * sizeof(opal_free_list_cache_t));
+    if (0 != rc) {
+        fl->fl_caches = NULL;
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (int i = 0; i < OPAL_FREE_LIST_NUM_CACHES; ++i) {
+        opal_atomic_lock_init(&fl->fl_caches[i].lock, OPAL_ATOMIC_LOCK_UNLOCKED);
+        fl->fl_caches[i].loaded = NULL;
+        fl->fl_caches[i].previous = NULL;
+    }
+
+    fl->fl_magazine_size = opal_free_list_magazine_size;
+    fl->fl_num_caches = OPAL_FREE_LIST_NUM_CACHES;
+
+    return OPAL_SUCCESS;
+}
+
+static void opal_free_list_caches_fini(opal_free_list_t *fl)
+{
+    opal_list_item_t *item;
+
+    if (NULL == fl->fl_caches) {
+        return;
+    }
+
+    (void) opal_free_list_reclaim_caches(fl);
+
+    for (int i = 0; i < fl->fl_num_caches; ++i) {
+        if (NULL != fl->fl_caches[i].loaded) {
+            opal_free_list_magazine_release(fl->fl_caches[i].loaded);
+        }
+        if (NULL != fl->fl_caches[i].previous) {
+            opal_free_list_magazine_release(fl->fl_caches[i].previous);
+        }
+    }
+
+    /* all magazines in the depot are empty after opal_free_list_reclaim_caches */
+    while (NULL != (item = opal_lifo_pop(&fl->fl_empty_magazines))) {
+        opal_free_list_magazine_release((opal_free_list_magazine_t *) item);
+    }
+
+    free(fl->fl_caches);
+    fl->fl_caches = NULL;
+    fl->fl_num_caches = 0;
+}
+
+opal_free_list_item_t *opal_free_list_get_cached(opal_free_list_t *fl)
+{
+    opal_free_list_cache_t *cache = opal_free_list_local_cache(fl);
+    opal_free_list_item_t *item = NULL;
+    opal_free_list_magazine_t *mag;
+
+    if (0 == opal_atomic_trylock(&cache->lock)) {
+        if (NULL == cache->loaded || 0 == cache->loaded->count) {
+            if (NULL != cache->previous && 0 < cache->previous->count) {
+                mag = cache->previous;
+                cache->previous = cache->loaded;
+                cache->loaded = mag;
+            } else if (NULL
+                       != (mag = (opal_free_list_magazine_t *) opal_lifo_pop_atomic(
+                               &fl->fl_full_magazines))) {
+                if (NULL != cache->loaded) {
+                    opal_lifo_push_atomic(&fl->fl_empty_magazines, &cache->loaded->super);
+                }
+                cache->loaded = mag;
+            }
+        }
+
+        if (NULL != cache->loaded && 0 < cache->loaded->count) {
+            item = cache->loaded->items[--cache->loaded->count];
+        }
+        opal_atomic_unlock(&cache->lock);
+
+        if (NULL != item) {
+            return item;
+        }
+    }
+
+    item = (opal_free_list_item_t *) opal_lifo_pop_atomic(&fl->super);
+    if (OPAL_UNLIKELY(NULL == item)) {
+        opal_mutex_lock(&fl->fl_lock);
+        opal_free_list_grow_st(fl, fl->fl_num_per_alloc, &item);
+        opal_mutex_unlock(&fl->fl_lock);
+    }
+
+    return item;
+}
+
+bool opal_free_list_return_cached(opal_free_list_t *fl, opal_free_list_item_t *item)
+{
+    opal_free_list_cache_t *cache = opal_free_list_local_cache(fl);
+    opal_free_list_magazine_t *mag;
+
+    if (0 != opal_atomic_trylock(&cache->lock)) {
+        return false;
+    }
+
+    if (NULL == cache->loaded || fl->fl_magazine_size == cache->loaded->count) {
+        if (NULL != cache->previous && fl->fl_magazine_size > cache->previous->count) {
+            mag = cache->previous;
+            cache->previous = cache->loaded;
+            cache->loaded = mag;
+        } else {
+            mag = (opal_free_list_magazine_t *) opal_lifo_pop_atomic(&fl->fl_empty_magazines);
+            if (NULL == mag && NULL == (mag = opal_free_list_magazine_alloc(fl))) {
+                opal_atomic_unlock(&cache->lock);
+                return false;
+            }
+
+            if (NULL != cache->loaded) {
+                /* both magazines are full. hand the older one to the depot */
+                if (NULL != cache->previous) {
+                    opal_lifo_push_atomic(&fl->fl_full_magazines, &cache->previous->super);
+                }
+                cache->previous = cache->loaded;
+            }
+            cache->loaded = mag;
+        }
+    }
+
+    cache->loaded->items[cache->loaded->count++] = item;
+    opal_atomic_unlock(&cache->lock);
+
+    return true;
+}
+
+size_t opal_free_list_reclaim_caches(opal_free_list_t *fl)
+{
+    opal_free_list_magazine_t *mag;
+    size_t count = 0;
+
+    while (NULL
+           != (mag = (opal_free_list_magazine_t *) opal_lifo_pop_atomic(&fl->fl_full_magazines))) {
+        count += opal_free_list_magazine_drain(fl, mag);
+        opal_lifo_push_atomic(&fl->fl_empty_magazines, &mag->super);
+    }
+
+    for (int i = 0; i < fl->fl_num_caches; ++i) {
+        opal_free_list_cache_t *cache = fl->fl_caches + i;
+
+        opal_atomic_lock(&cache->lock);
+        if (NULL != cache->loaded) {
+            count += opal_free_list_magazine_drain(fl, cache->loaded);
+        }
+        if (NULL != cache->previous) {
+            count += opal_free_list_magazine_drain(fl, cache->previous);
+        }
+        opal_atomic_unlock(&cache->lock);
+    }
+
+    if (count > 0 && fl->fl_num_waiting > 0) {
+        opal_condition_broadcast(&fl->fl_condition);
+    }
+
+    return count;
+}
+
 static void opal_free_list_construct(opal_free_list_t *fl)
 {
     OBJ_CONSTRUCT(&fl->fl_lock, opal_mutex_t);
@@ -54,7 +322,12 @@ static void opal_free_list_construct(opal_free_list_t *fl)
     /* default flags */
     fl->fl_rcache_reg_flags = MCA_RCACHE_FLAGS_CACHE_BYPASS | MCA_RCACHE_FLAGS_CUDA_REGISTER_MEM;
     fl->ctx = NULL;
+    fl->fl_caches = NULL;
+    fl->fl_num_caches = 0;
+    fl->fl_magazine_size = 0;
     OBJ_CONSTRUCT(&(fl->fl_allocations), opal_list_t);
+    OBJ_CONSTRUCT(&fl->fl_full_magazines, opal_lifo_t);
+    OBJ_CONSTRUCT(&fl->fl_empty_magazines, opal_lifo_t);
 }
 
 static void opal_free_list_allocation_release(opal_free_list_t *fl, opal_free_list_memory_t *fl_mem)
@@ -87,6 +360,9 @@ static void opal_free_list_destruct(opal_free_list_t *fl)
     }
 #endif
 
+    /* return all cached items to the LIFO so they get destructed below */
+    opal_free_list_caches_fini(fl);
+
     while (NULL != (item = opal_lifo_pop(&(fl->super)))) {
         fl_item = (opal_free_list_item_t *) item;
 
@@ -101,6 +377,8 @@ static void opal_free_list_destruct(opal_free_list_t *fl)
     }
 
     OBJ_DESTRUCT(&fl->fl_allocations);
+    OBJ_DESTRUCT(&fl->fl_full_magazines);
+    OBJ_DESTRUCT(&fl->fl_empty_magazines);
     OBJ_DESTRUCT(&fl->fl_condition);
     OBJ_DESTRUCT(&fl->fl_lock);
 }
@@ -152,6 +430,9 @@ int opal_free_list_init(opal_free_list_t *flist, size_t frag_size, size_t frag_a
     flist->fl_rcache_reg_flags |= rcache_reg_flags;
     flist->ctx = ctx;
 
+    /* the caches are optional. continue without them if they can not be set up */
+    (void) opal_free_list_caches_init(flist);
+
     if (num_elements_to_alloc) {
         return opal_free_list_grow_st(flist, num_elements_to_alloc, NULL);
     }
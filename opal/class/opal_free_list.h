@@ -91,6 +91,16 @@ struct opal_free_list_t {
     opal_free_list_item_init_fn_t item_init;
     /** Initialization function context */
     void *ctx;
+    /** Per-thread magazine caches (NULL if the caches are disabled) */
+    struct opal_free_list_cache_t *fl_caches;
+    /** Number of entries in fl_caches */
+    int fl_num_caches;
+    /** Number of items held by a magazine */
+    int fl_magazine_size;
+    /** Full magazines not loaded in any cache */
+    opal_lifo_t fl_full_magazines;
+    /** Empty magazines not loaded in any cache */
+    opal_lifo_t fl_empty_magazines;
 };
 typedef struct opal_free_list_t opal_free_list_t;
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_free_list_t);
@@ -174,6 +184,42 @@ OPAL_DECLSPEC int opal_free_list_grow_st(opal_free_list_t *flist, size_t num_ele
  */
 OPAL_DECLSPEC int opal_free_list_resize_mt(opal_free_list_t *flist, size_t size);
 
+/**
+ * Obtain an item through the per-thread caches of a free list.
+ *
+ * @param flist    (IN)   Free list with caches enabled.
+ *
+ * Internal function used by opal_free_list_get_mt(). Falls back to the
+ * shared LIFO (growing the free list if necessary) when the cache of the
+ * calling thread is empty or busy.
+ */
+OPAL_DECLSPEC opal_free_list_item_t *opal_free_list_get_cached(opal_free_list_t *flist);
+
+/**
+ * Return an item through the per-thread caches of a free list.
+ *
+ * @param flist    (IN)   Free list with caches enabled.
+ * @param item     (IN)   Item to return.
+ *
+ * @returns true if the item was stored in a cache
+ * @returns false if the caller must return the item to the shared LIFO
+ *
+ * Internal function used by opal_free_list_return_mt().
+ */
+OPAL_DECLSPEC bool opal_free_list_return_cached(opal_free_list_t *flist,
+                                                opal_free_list_item_t *item);
+
+/**
+ * Move all items held by the per-thread caches back to the shared LIFO.
+ *
+ * @param flist    (IN)   Free list with caches enabled.
+ *
+ * @returns the number of items moved
+ *
+ * Internal function used by opal_free_list_wait_mt() before blocking.
+ */
+OPAL_DECLSPEC size_t opal_free_list_reclaim_caches(opal_free_list_t *flist);
+
 /**
  * Attemp to obtain an item from a free list.
  *
@@ -189,7 +235,13 @@ OPAL_DECLSPEC int opal_free_list_resize_mt(opal_free_list_t *flist, size_t size)
  */
 static inline opal_free_list_item_t *opal_free_list_get_mt(opal_free_list_t *flist)
 {
-    opal_free_list_item_t *item = (opal_free_list_item_t *) opal_lifo_pop_atomic(&flist->super);
+    opal_free_list_item_t *item;
+
+    if (NULL != flist->fl_caches) {
+        return opal_free_list_get_cached(flist);
+    }
+
+    item = (opal_free_list_item_t *) opal_lifo_pop_atomic(&flist->super);
 
     if (OPAL_UNLIKELY(NULL == item)) {
         opal_mutex_lock(&flist->fl_lock);
@@ -246,8 +298,16 @@ static inline opal_free_list_item_t *opal_free_list_wait_mt(opal_free_list_t *fl
         if (!opal_mutex_trylock(&fl->fl_lock)) {
             if (fl->fl_max_to_alloc <= fl->fl_num_allocated
                 || OPAL_SUCCESS != opal_free_list_grow_st(fl, fl->fl_num_per_alloc, &item)) {
+                /* items parked in the per-thread caches are not visible in the
+                 * LIFO. pull them back before going to sleep. register as a
+                 * waiter first: a thread caching an item concurrently either
+                 * has it reclaimed here or sees the waiter (see
+                 * opal_free_list_return_mt). */
                 fl->fl_num_waiting++;
-                opal_condition_wait(&fl->fl_condition, &fl->fl_lock);
+                opal_atomic_mb();
+                if (NULL == fl->fl_caches || 0 == opal_free_list_reclaim_caches(fl)) {
+                    opal_condition_wait(&fl->fl_condition, &fl->fl_lock);
+                }
                 fl->fl_num_waiting--;
             } else {
                 if (0 < fl->fl_num_waiting) {
@@ -312,6 +372,21 @@ static inline void opal_free_list_return_mt(opal_free_list_t *flist, opal_free_l
 {
     opal_list_item_t *original;
 
+    /* do not hide items from threads blocked in opal_free_list_wait_mt */
+    if (NULL != flist->fl_caches && 0 == flist->fl_num_waiting
+        && opal_free_list_return_cached(flist, item)) {
+        /* a thread may have started waiting after the check above. if it
+         * reclaimed the caches before the item was parked, hand the item
+         * over now */
+        opal_atomic_mb();
+        if (OPAL_UNLIKELY(0 < flist->fl_num_waiting)) {
+            opal_mutex_lock(&flist->fl_lock);
+            (void) opal_free_list_reclaim_caches(flist);
+            opal_mutex_unlock(&flist->fl_lock);
+        }
+        return;
+    }
+
     original = opal_lifo_push_atomic(&flist->super, &item->super);
     if (&flist->super.opal_lifo_ghost == original) {
         if (flist->fl_num_waiting > 0) {
@@ -115,24 +115,38 @@ OBJ_CLASS_INSTANCE(opal_interval_tree_t, opal_object_t, opal_interval_tree_const
 
 typedef int32_t opal_interval_tree_token_t;
 
+#if OPAL_HAVE_THREAD_LOCAL
+/* reader slot of this thread, the same in every tree. threads that always use
+ * their own slot never write to shared state when they pick one. */
+static opal_thread_local opal_interval_tree_token_t opal_interval_tree_reader_slot = -1;
+static opal_atomic_int32_t opal_interval_tree_next_reader_slot = 0;
+#endif
+
 /**
  * @brief pick and return a reader slot
  */
 static opal_interval_tree_token_t opal_interval_tree_reader_get_token(opal_interval_tree_t *tree)
 {
-    opal_interval_tree_token_t token = -1;
-
-    if (token < 0) {
-        int32_t reader_count = tree->reader_count;
-        /* NTH: could have used an atomic here but all we are after is some distribution of threads
-         * across the reader slots. with high thread counts i see no real performance difference
-         * using atomics. */
-        token = tree->reader_id++ % OPAL_INTERVAL_TREE_MAX_READERS;
-        while (OPAL_UNLIKELY(reader_count <= token)) {
-            if (opal_atomic_compare_exchange_strong_32(&tree->reader_count, &reader_count,
-                                                       token + 1)) {
-                break;
-            }
+    opal_interval_tree_token_t token;
+    int32_t reader_count = tree->reader_count;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    token = opal_interval_tree_reader_slot;
+    if (OPAL_UNLIKELY(token < 0)) {
+        token = opal_interval_tree_reader_slot
+            = opal_atomic_fetch_add_32(&opal_interval_tree_next_reader_slot, 1)
+              % OPAL_INTERVAL_TREE_MAX_READERS;
+    }
+#else
+    /* NTH: could have used an atomic here but all we are after is some distribution of threads
+     * across the reader slots. with high thread counts i see no real performance difference
+     * using atomics. */
+    token = tree->reader_id++ % OPAL_INTERVAL_TREE_MAX_READERS;
+#endif
+    while (OPAL_UNLIKELY(reader_count <= token)) {
+        if (opal_atomic_compare_exchange_strong_32(&tree->reader_count, &reader_count,
+                                                   token + 1)) {
+            break;
         }
     }
 
@@ -34,6 +34,10 @@
 #ifdef HAVE_UNISTD_H
 #    include <unistd.h>
 #endif
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "opal/class/opal_hash_table.h"
 #include "opal/class/opal_list.h"
@@ -176,6 +180,137 @@ static int process_repository_item(const char *filename, void *data)
     return OPAL_SUCCESS;
 }
 
+/*
+ * Read the component index written at install time in a component
+ * directory (see config/opal_make_component_index.sh). It lists the
+ * component files of the directory, one per line, which saves stat'ing
+ * every file of the directory -- a lot of metadata traffic when many
+ * processes start at once from a shared file system. The index is only
+ * trusted if the component files found when reading the directory are
+ * exactly the ones it lists. Their time stamps are not used, package
+ * managers keep the ones of the packaged files.
+ */
+static int component_index_compare(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+static int read_component_index(const char *dir)
+{
+    struct stat index_stat;
+    char *index_path, *data, *line, *next, *end, **names = NULL;
+    size_t count = 0, found = 0;
+    struct dirent *de;
+    DIR *dp;
+    int fd, ret = OPAL_SUCCESS;
+
+    if (0 > opal_asprintf(&index_path, "%s/%s", dir, MCA_BASE_COMPONENT_INDEX_FILE)) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    fd = open(index_path, O_RDONLY);
+    free(index_path);
+    if (0 > fd) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    if (0 != fstat(fd, &index_stat) || 0 == index_stat.st_size) {
+        close(fd);
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    data = mmap(NULL, (size_t) index_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    /* one line per file, there can not be more files than lines */
+    end = data + index_stat.st_size;
+    names = (char **) malloc(((size_t) index_stat.st_size / 2 + 1) * sizeof(names[0]));
+    if (NULL == names) {
+        munmap(data, (size_t) index_stat.st_size);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    for (line = data; line < end; line = next) {
+        char *eol = memchr(line, '\n', (size_t) (end - line));
+        size_t len = (NULL == eol ? end : eol) - line;
+
+        next = (NULL == eol) ? end : eol + 1;
+        if (0 == len || '#' == line[0]) {
+            continue;
+        }
+        if (0 > opal_asprintf(&names[count], "%.*s", (int) len, line)) {
+            ret = OPAL_ERR_OUT_OF_RESOURCE;
+            goto out;
+        }
+        ++count;
+    }
+    munmap(data, (size_t) index_stat.st_size);
+    data = NULL;
+
+    qsort(names, count, sizeof(names[0]), component_index_compare);
+
+    /* compare with the component files of the directory. The names are
+     * enough, the files do not need to be stat'ed */
+    dp = opendir(dir);
+    if (NULL == dp) {
+        ret = OPAL_ERR_NOT_FOUND;
+        goto out;
+    }
+    while (NULL != (de = readdir(dp))) {
+        const char *suffix = strrchr(de->d_name, '.');
+        char *name = de->d_name;
+
+        if (0 != strncmp(name, "mca_", 4)
+            || (NULL != suffix && (0 == strcmp(suffix, ".la") || 0 == strcmp(suffix, ".lo")))) {
+            continue;
+        }
+        if (NULL == bsearch(&name, names, count, sizeof(names[0]), component_index_compare)) {
+            found = count + 1;
+            break;
+        }
+        ++found;
+    }
+    closedir(dp);
+
+    if (found != count) {
+        opal_output_verbose(MCA_BASE_VERBOSE_COMPONENT, 0,
+                            "mca: base: component_repository: index of %s is out of "
+                            "date, listing the directory",
+                            dir);
+        ret = OPAL_ERR_NOT_FOUND;
+        goto out;
+    }
+
+    for (size_t i = 0; i < count && OPAL_SUCCESS == ret; ++i) {
+        char *suffix = strrchr(names[i], '.');
+
+        /* the component is found by its name without the suffix, as the
+         * dl framework reports it when listing the directory */
+        if (NULL != suffix) {
+            *suffix = '\0';
+        }
+        if (0 > opal_asprintf(&index_path, "%s/%s", dir, names[i])) {
+            ret = OPAL_ERR_OUT_OF_RESOURCE;
+            break;
+        }
+        ret = process_repository_item(index_path, NULL);
+        free(index_path);
+    }
+
+out:
+    if (NULL != data) {
+        munmap(data, (size_t) index_stat.st_size);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        free(names[i]);
+    }
+    free(names);
+
+    return ret;
+}
+
 static int file_exists(const char *filename, const char *ext)
 {
     char *final;
@@ -219,6 +354,10 @@ int mca_base_component_repository_add(const char *path)
             dir = mca_base_system_default_path;
         }
 
+        if (mca_base_component_use_index && OPAL_SUCCESS == read_component_index(dir)) {
+            continue;
+        }
+
         if (0 != opal_dl_foreachfile(dir, process_repository_item, NULL)) {
             break;
         }
@@ -43,6 +43,13 @@
 #include "opal/mca/dl/dl.h"
 
 BEGIN_C_DECLS
+
+/**
+ * Name of the component index written at install time in each component
+ * directory. See mca_base_component_repository_add().
+ */
+#define MCA_BASE_COMPONENT_INDEX_FILE "opal-component-index"
+
 struct mca_base_component_repository_item_t {
     opal_list_item_t super;
 
@@ -87,6 +94,10 @@ OPAL_DECLSPEC int mca_base_component_repository_init(void);
  * @brief add search path for dynamically loaded components
  *
  * @param[in] path        delimited list of search paths to add
+ *
+ * If a directory holds an up to date MCA_BASE_COMPONENT_INDEX_FILE and
+ * mca_base_component_use_index is set, the components are taken from the
+ * index instead of checking every file of the directory.
  */
 OPAL_DECLSPEC int mca_base_component_repository_add(const char *path);
 
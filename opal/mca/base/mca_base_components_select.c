@@ -28,11 +28,13 @@
 #include "opal/mca/base/mca_base_component_repository.h"
 #include "opal/mca/mca.h"
 #include "opal/runtime/opal.h"
+#include "opal/runtime/opal_init_timing.h"
 #include "opal/util/output.h"
 
-int mca_base_select(const char *type_name, int output_id, opal_list_t *components_available,
-                    mca_base_module_t **best_module, mca_base_component_t **best_component,
-                    int *priority_out)
+static int mca_base_select_components(const char *type_name, int output_id,
+                                      opal_list_t *components_available,
+                                      mca_base_module_t **best_module,
+                                      mca_base_component_t **best_component, int *priority_out)
 {
     mca_base_component_list_item_t *cli = NULL;
     mca_base_component_t *component = NULL;
@@ -139,3 +141,21 @@ int mca_base_select(const char *type_name, int output_id, opal_list_t *component
 
     return OPAL_SUCCESS;
 }
+
+int mca_base_select(const char *type_name, int output_id, opal_list_t *components_available,
+                    mca_base_module_t **best_module, mca_base_component_t **best_component,
+                    int *priority_out)
+{
+    double start = opal_init_timing_now();
+    char phase[OPAL_INIT_TIMING_NAME_LEN];
+    int ret;
+
+    ret = mca_base_select_components(type_name, output_id, components_available, best_module,
+                                     best_component, priority_out);
+
+    /* querying includes the setup done by the components, e.g. probing devices */
+    snprintf(phase, sizeof(phase), "select_%s", type_name);
+    opal_init_timing_record(phase, opal_init_timing_now() - start);
+
+    return ret;
+}
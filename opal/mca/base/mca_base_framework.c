@@ -17,6 +17,7 @@
 #include "opal/include/opal_config.h"
 
 #include "opal/include/opal/constants.h"
+#include "opal/runtime/opal_init_timing.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 
@@ -159,6 +160,8 @@ int mca_base_framework_register_list(mca_base_framework_t **frameworks,
 
 int mca_base_framework_open(struct mca_base_framework_t *framework, mca_base_open_flag_t flags)
 {
+    double start = opal_init_timing_now();
+    char phase[OPAL_INIT_TIMING_NAME_LEN];
     int ret;
 
     assert(NULL != framework);
@@ -201,6 +204,11 @@ int mca_base_framework_open(struct mca_base_framework_t *framework, mca_base_ope
         framework->framework_flags |= MCA_BASE_FRAMEWORK_FLAG_OPEN;
     }
 
+    /* registering and opening include finding and loading the components */
+    snprintf(phase, sizeof(phase), "open_%s_%s", framework->framework_project,
+             framework->framework_name);
+    opal_init_timing_record(phase, opal_init_timing_now() - start);
+
     return ret;
 }
 
@@ -55,6 +55,7 @@ char *mca_base_user_default_path = NULL;
 bool mca_base_component_show_load_errors = (bool) OPAL_SHOW_LOAD_ERRORS_DEFAULT;
 bool mca_base_component_track_load_errors = false;
 bool mca_base_component_disable_dlopen = false;
+bool mca_base_component_use_index = true;
 
 static char *mca_base_verbose = NULL;
 
@@ -129,6 +130,14 @@ int mca_base_open(void)
     (void) mca_base_var_register_synonym(var_id, "opal", "mca", NULL, "component_disable_dlopen",
                                          MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
 
+    mca_base_component_use_index = true;
+    (void) mca_base_var_register("opal", "mca", "base", "component_use_index",
+                                 "Whether to find the components of a component directory "
+                                 "from the index written at install time, when it is up to "
+                                 "date, rather than by checking every file of the directory",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &mca_base_component_use_index);
+
     /* What verbosity level do we want for the default 0 stream? */
     char *str = getenv("OPAL_OUTPUT_INTERNAL_TO_STDOUT");
     if (NULL != str && str[0] == '1') {
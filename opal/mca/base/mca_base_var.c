@@ -85,6 +85,19 @@ static int mca_base_var_count = 0;
 
 static opal_hash_table_t mca_base_var_index_hash;
 
+/* Values read from the files, indexed by variable name, so that looking
+ * up the value of a variable does not scan the files' value lists */
+static opal_hash_table_t mca_base_var_file_index;
+static opal_hash_table_t mca_base_envar_file_index;
+static opal_hash_table_t mca_base_var_override_index;
+
+/* The MCA variables of the environment, indexed by name without the
+ * prefix. Rebuilt in one pass over the environment whenever it changes,
+ * which is detected with a signature of the environ array. */
+static opal_hash_table_t mca_base_var_env_index;
+static uintptr_t mca_base_var_env_signature = 0;
+static bool mca_base_var_env_indexed = false;
+
 #define OPAL_MCA_VAR_MBV_ENUMERATOR_FREE(mbv_enumerator)         \
     {                                                            \
         if (mbv_enumerator && !mbv_enumerator->enum_is_static) { \
@@ -117,7 +130,8 @@ static const char *info_lvl_strings[] = {"user/basic",  "user/detail",  "user/al
  * local functions
  */
 static int fixup_files(char **file_list, char *path, bool rel_path_search, char sep);
-static int read_files(char *file_list, opal_list_t *file_values, char sep);
+static int read_files(char *file_list, opal_list_t *file_values, opal_hash_table_t *file_index,
+                      char sep);
 static int var_set_initial(mca_base_var_t *var, mca_base_var_t *original);
 static int var_get(int vari, mca_base_var_t **var_out, bool original);
 static int var_value_string(mca_base_var_t *var, char **value_string);
@@ -247,12 +261,31 @@ int mca_base_var_init(void)
         OBJ_CONSTRUCT(&mca_base_envar_file_values, opal_list_t);
         OBJ_CONSTRUCT(&mca_base_var_override_values, opal_list_t);
         OBJ_CONSTRUCT(&mca_base_var_index_hash, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_var_file_index, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_envar_file_index, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_var_override_index, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_var_env_index, opal_hash_table_t);
 
         ret = opal_hash_table_init(&mca_base_var_index_hash, 1024);
         if (OPAL_SUCCESS != ret) {
             return ret;
         }
 
+        ret = opal_hash_table_init(&mca_base_var_file_index, 64);
+        if (OPAL_SUCCESS == ret) {
+            ret = opal_hash_table_init(&mca_base_envar_file_index, 64);
+        }
+        if (OPAL_SUCCESS == ret) {
+            ret = opal_hash_table_init(&mca_base_var_override_index, 64);
+        }
+        if (OPAL_SUCCESS == ret) {
+            ret = opal_hash_table_init(&mca_base_var_env_index, 64);
+        }
+        if (OPAL_SUCCESS != ret) {
+            return ret;
+        }
+        mca_base_var_env_indexed = false;
+
         ret = mca_base_var_group_init();
         if (OPAL_SUCCESS != ret) {
             return ret;
@@ -387,7 +420,7 @@ int mca_base_var_load_extra_files(char *files, bool rel_path_search)
     char *tmp1 = strdup(files);
     resolve_relative_paths(&tmp1, mca_base_param_file_path, rel_path_search, &mca_base_var_files,
                            OPAL_ENV_SEP);
-    read_files(tmp1, &mca_base_var_file_values, ',');
+    read_files(tmp1, &mca_base_var_file_values, &mca_base_var_file_index, ',');
     free(tmp1);
     return OPAL_SUCCESS;
 }
@@ -531,16 +564,18 @@ int mca_base_var_cache_files(bool rel_path_search)
         resolve_relative_paths(&mca_base_var_file_prefix, mca_base_param_file_path, rel_path_search,
                                &mca_base_var_files, OPAL_ENV_SEP);
     }
-    read_files(mca_base_var_files, &mca_base_var_file_values, ',');
+    read_files(mca_base_var_files, &mca_base_var_file_values, &mca_base_var_file_index, ',');
 
     if (NULL != mca_base_envar_file_prefix) {
         resolve_relative_paths(&mca_base_envar_file_prefix, mca_base_param_file_path,
                                rel_path_search, &mca_base_envar_files, ',');
     }
-    read_files(mca_base_envar_files, &mca_base_envar_file_values, ',');
+    read_files(mca_base_envar_files, &mca_base_envar_file_values, &mca_base_envar_file_index,
+               ',');
 
     if (0 == access(mca_base_var_override_file, F_OK)) {
-        read_files(mca_base_var_override_file, &mca_base_var_override_values, OPAL_ENV_SEP);
+        read_files(mca_base_var_override_file, &mca_base_var_override_values,
+                   &mca_base_var_override_index, OPAL_ENV_SEP);
     }
 
     return OPAL_SUCCESS;
@@ -1152,6 +1187,11 @@ static void mca_base_var_finalize(void)
         (void) mca_base_pvar_finalize();
 
         OBJ_DESTRUCT(&mca_base_var_index_hash);
+        OBJ_DESTRUCT(&mca_base_var_file_index);
+        OBJ_DESTRUCT(&mca_base_envar_file_index);
+        OBJ_DESTRUCT(&mca_base_var_override_index);
+        OBJ_DESTRUCT(&mca_base_var_env_index);
+        mca_base_var_env_indexed = false;
 
         free(mca_base_envar_files);
         mca_base_envar_files = NULL;
@@ -1236,8 +1276,10 @@ static int fixup_files(char **file_list, char *path, bool rel_path_search, char
     return exit_status;
 }
 
-static int read_files(char *file_list, opal_list_t *file_values, char sep)
+static int read_files(char *file_list, opal_list_t *file_values, opal_hash_table_t *file_index,
+                      char sep)
 {
+    mca_base_var_file_value_t *fv;
     char **tmp = opal_argv_split(file_list, sep);
     int i, count;
 
@@ -1260,6 +1302,13 @@ static int read_files(char *file_list, opal_list_t *file_values, char sep)
 
     mca_base_internal_env_store();
 
+    /* variable names are unique within a list of file values. build the
+     * index last so it covers the entries added by the internal env store */
+    opal_hash_table_remove_all(file_index);
+    OPAL_LIST_FOREACH (fv, file_values, mca_base_var_file_value_t) {
+        opal_hash_table_set_value_ptr(file_index, fv->mbvfv_var, strlen(fv->mbvfv_var), fv);
+    }
+
     return OPAL_SUCCESS;
 }
 
@@ -1605,31 +1654,77 @@ int mca_base_var_register_synonym(int synonym_for, const char *project_name,
                              synonym_for, NULL);
 }
 
-static int var_get_env(mca_base_var_t *var, const char *name, char **source, char **value)
+static uintptr_t env_signature(void)
 {
-    const char source_prefix[] = "SOURCE_";
-    const int max_len = strlen(mca_prefix) + strlen(source_prefix) + strlen(name) + 1;
-    char *envvar = alloca(max_len);
-    if (NULL == envvar) {
-        return OPAL_ERR_OUT_OF_RESOURCE;
+    uintptr_t signature = (uintptr_t) environ;
+
+    /* setenv() and putenv() store new strings and unsetenv() moves the
+     * entries, so comparing the pointers is enough */
+    for (char **env = environ; NULL != env && NULL != *env; ++env) {
+        signature = signature * 31 + (uintptr_t) *env;
     }
 
-    int ret;
-    ret = snprintf(envvar, max_len, "%s%s", mca_prefix, name);
-    if (0 > ret) {
-        return OPAL_ERROR;
+    return signature;
+}
+
+/*
+ * Make sure the index of the MCA variables of the environment is up to
+ * date. Looking the variables up in the index instead of calling getenv()
+ * for each name of each registered variable saves a scan of the whole
+ * environment per lookup.
+ */
+static void env_index_update(void)
+{
+    size_t prefix_len = strlen(mca_prefix);
+    uintptr_t signature = env_signature();
+    void *tmp;
+
+    if (mca_base_var_env_indexed && signature == mca_base_var_env_signature) {
+        return;
+    }
+
+    opal_hash_table_remove_all(&mca_base_var_env_index);
+    for (char **env = environ; NULL != env && NULL != *env; ++env) {
+        char *name = *env + prefix_len, *value;
+
+        if (0 != strncmp(*env, mca_prefix, prefix_len) || NULL == (value = strchr(name, '='))) {
+            continue;
+        }
+
+        /* like getenv(), the first definition of a name wins */
+        if (OPAL_SUCCESS
+            != opal_hash_table_get_value_ptr(&mca_base_var_env_index, name, value - name, &tmp)) {
+            opal_hash_table_set_value_ptr(&mca_base_var_env_index, name, value - name, value + 1);
+        }
     }
-    *value = getenv(envvar);
-    if (NULL == *value) {
-        *source = NULL;
+
+    mca_base_var_env_signature = signature;
+    mca_base_var_env_indexed = true;
+}
+
+static int var_get_env(mca_base_var_t *var, const char *name, char **source, char **value)
+{
+    const char source_prefix[] = "SOURCE_";
+    const int max_len = strlen(source_prefix) + strlen(name) + 1;
+    char *envvar;
+    void *tmp;
+
+    if (OPAL_SUCCESS
+        != opal_hash_table_get_value_ptr(&mca_base_var_env_index, name, strlen(name), &tmp)) {
+        *value = *source = NULL;
         return OPAL_ERR_NOT_FOUND;
     }
+    *value = (char *) tmp;
 
-    ret = snprintf(envvar, max_len, "%s%s%s", mca_prefix, source_prefix, name);
-    if (0 > ret) {
+    envvar = alloca(max_len);
+    if (0 > snprintf(envvar, max_len, "%s%s", source_prefix, name)) {
         return OPAL_ERROR;
     }
-    *source = getenv(envvar);
+    if (OPAL_SUCCESS
+        != opal_hash_table_get_value_ptr(&mca_base_var_env_index, envvar, strlen(envvar), &tmp)) {
+        tmp = NULL;
+    }
+    *source = (char *) tmp;
 
     return OPAL_SUCCESS;
 }
@@ -1646,6 +1741,8 @@ static int var_set_from_env(mca_base_var_t *var, mca_base_var_t *original)
     char *source_env, *value_env;
     int ret;
 
+    env_index_update();
+
     ret = var_get_env(var, var_long_name, &source_env, &value_env);
     if (OPAL_SUCCESS != ret) {
         ret = var_get_env(var, var_full_name, &source_env, &value_env);
@@ -1722,8 +1819,32 @@ static int var_set_from_env(mca_base_var_t *var, mca_base_var_t *original)
 /*
  * Lookup a param in the files
  */
+static mca_base_var_file_value_t *find_file_value(opal_list_t *file_values,
+                                                  opal_hash_table_t *file_index,
+                                                  const char *full_name, const char *long_name)
+{
+    mca_base_var_file_value_t *fv, *full_fv = NULL, *long_fv = NULL;
+
+    (void) opal_hash_table_get_value_ptr(file_index, full_name, strlen(full_name),
+                                         (void **) &full_fv);
+    (void) opal_hash_table_get_value_ptr(file_index, long_name, strlen(long_name),
+                                         (void **) &long_fv);
+    if (NULL == full_fv || NULL == long_fv || full_fv == long_fv) {
+        return (NULL != full_fv) ? full_fv : long_fv;
+    }
+
+    /* both names are set: the first one in the files wins */
+    OPAL_LIST_FOREACH (fv, file_values, mca_base_var_file_value_t) {
+        if (fv == full_fv || fv == long_fv) {
+            return fv;
+        }
+    }
+
+    return NULL;
+}
+
 static int var_set_from_file(mca_base_var_t *var, mca_base_var_t *original,
-                             opal_list_t *file_values)
+                             opal_list_t *file_values, opal_hash_table_t *file_index)
 {
     const char *var_full_name = var->mbv_full_name;
     const char *var_long_name = var->mbv_long_name;
@@ -1731,60 +1852,54 @@ static int var_set_from_file(mca_base_var_t *var, mca_base_var_t *original,
     bool is_synonym = VAR_IS_SYNONYM(var[0]);
     mca_base_var_file_value_t *fv;
 
-    /* Scan through the list of values read in from files and try to
-       find a match.  If we do, cache it on the param (for future
-       lookups) and save it in the storage. */
-
-    OPAL_LIST_FOREACH (fv, file_values, mca_base_var_file_value_t) {
-        if (0 != strcmp(fv->mbvfv_var, var_full_name)
-            && 0 != strcmp(fv->mbvfv_var, var_long_name)) {
-            continue;
-        }
+    /* Look for a value read in from the files.  If we find one, cache it
+       on the param (for future lookups) and save it in the storage. */
 
-        /* found it */
-        if (VAR_IS_DEFAULT_ONLY(var[0])) {
-            opal_show_help("help-mca-var.txt", "default-only-param-set", true, var_full_name);
+    fv = find_file_value(file_values, file_index, var_full_name, var_long_name);
+    if (NULL == fv) {
+        return OPAL_ERR_NOT_FOUND;
+    }
 
-            return OPAL_ERR_NOT_FOUND;
-        }
+    if (VAR_IS_DEFAULT_ONLY(var[0])) {
+        opal_show_help("help-mca-var.txt", "default-only-param-set", true, var_full_name);
 
-        if (MCA_BASE_VAR_FLAG_ENVIRONMENT_ONLY & original->mbv_flags) {
-            opal_show_help("help-mca-var.txt", "environment-only-param", true, var_full_name,
-                           fv->mbvfv_value, fv->mbvfv_file);
+        return OPAL_ERR_NOT_FOUND;
+    }
 
-            return OPAL_ERR_NOT_FOUND;
-        }
+    if (MCA_BASE_VAR_FLAG_ENVIRONMENT_ONLY & original->mbv_flags) {
+        opal_show_help("help-mca-var.txt", "environment-only-param", true, var_full_name,
+                       fv->mbvfv_value, fv->mbvfv_file);
 
-        if (MCA_BASE_VAR_SOURCE_OVERRIDE == original->mbv_source) {
-            if (!mca_base_var_suppress_override_warning) {
-                opal_show_help("help-mca-var.txt", "overridden-param-set", true, var_full_name);
-            }
+        return OPAL_ERR_NOT_FOUND;
+    }
 
-            return OPAL_ERR_NOT_FOUND;
+    if (MCA_BASE_VAR_SOURCE_OVERRIDE == original->mbv_source) {
+        if (!mca_base_var_suppress_override_warning) {
+            opal_show_help("help-mca-var.txt", "overridden-param-set", true, var_full_name);
         }
 
-        if (deprecated) {
-            const char *new_variable = "None (going away)";
-
-            if (is_synonym) {
-                new_variable = original->mbv_full_name;
-            }
+        return OPAL_ERR_NOT_FOUND;
+    }
 
-            opal_show_help("help-mca-var.txt", "deprecated-mca-file", true, var_full_name,
-                           fv->mbvfv_file, new_variable);
-        }
+    if (deprecated) {
+        const char *new_variable = "None (going away)";
 
-        original->mbv_file_value = (void *) fv;
-        original->mbv_source = MCA_BASE_VAR_SOURCE_FILE;
         if (is_synonym) {
-            var->mbv_file_value = (void *) fv;
-            var->mbv_source = MCA_BASE_VAR_SOURCE_FILE;
+            new_variable = original->mbv_full_name;
         }
 
-        return var_set_from_string(original, fv->mbvfv_value);
+        opal_show_help("help-mca-var.txt", "deprecated-mca-file", true, var_full_name,
+                       fv->mbvfv_file, new_variable);
     }
 
-    return OPAL_ERR_NOT_FOUND;
+    original->mbv_file_value = (void *) fv;
+    original->mbv_source = MCA_BASE_VAR_SOURCE_FILE;
+    if (is_synonym) {
+        var->mbv_file_value = (void *) fv;
+        var->mbv_source = MCA_BASE_VAR_SOURCE_FILE;
+    }
+
+    return var_set_from_string(original, fv->mbvfv_value);
 }
 
 /*
@@ -1808,7 +1923,8 @@ static int var_set_initial(mca_base_var_t *var, mca_base_var_t *original)
        order. If the default only flag is set the user will get a
        warning if they try to set a value from the environment or a
        file. */
-    ret = var_set_from_file(var, original, &mca_base_var_override_values);
+    ret = var_set_from_file(var, original, &mca_base_var_override_values,
+                            &mca_base_var_override_index);
     if (OPAL_SUCCESS == ret) {
         var->mbv_flags = ~MCA_BASE_VAR_FLAG_SETTABLE
                          & (var->mbv_flags | MCA_BASE_VAR_FLAG_OVERRIDE);
@@ -1820,12 +1936,13 @@ static int var_set_initial(mca_base_var_t *var, mca_base_var_t *original)
         return ret;
     }
 
-    ret = var_set_from_file(var, original, &mca_base_envar_file_values);
+    ret = var_set_from_file(var, original, &mca_base_envar_file_values,
+                            &mca_base_envar_file_index);
     if (OPAL_ERR_NOT_FOUND != ret) {
         return ret;
     }
 
-    ret = var_set_from_file(var, original, &mca_base_var_file_values);
+    ret = var_set_from_file(var, original, &mca_base_var_file_values, &mca_base_var_file_index);
     if (OPAL_ERR_NOT_FOUND != ret) {
         return ret;
     }
@@ -157,6 +157,25 @@ mca_btl_base_descriptor_t *mca_btl_sm_alloc(struct mca_btl_base_module_t *btl,
  */
 int mca_btl_sm_free(struct mca_btl_base_module_t *btl, mca_btl_base_descriptor_t *des);
 
+/**
+ * Attach to the shared memory segment of a local peer.
+ *
+ * add_procs only sets up the endpoints; the segment of a peer is attached
+ * the first time a fragment is sent to it or received from it, so the
+ * cost of startup does not grow with the number of local peers a process
+ * never talks to. Returns immediately if the segment is already attached.
+ *
+ * @param endpoint (IN)  endpoint of the peer
+ */
+int mca_btl_sm_endpoint_attach(struct mca_btl_base_endpoint_t *endpoint);
+
+/**
+ * Attach to the segment of a peer that wrote into our fifo or fast box,
+ * and return its base address. Failing is fatal as the fragment can not
+ * be read.
+ */
+char *mca_btl_sm_endpoint_attach_recv(struct mca_btl_base_endpoint_t *endpoint);
+
 END_C_DECLS
 
 #endif
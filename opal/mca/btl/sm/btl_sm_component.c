@@ -33,6 +33,8 @@
 
 #include "opal/mca/btl/base/btl_base_error.h"
 #include "opal/mca/threads/mutex.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/fd.h"
 #include "opal/util/output.h"
 #include "opal/util/printf.h"
 #include "opal/util/show_help.h"
@@ -48,8 +50,13 @@
 #    include <sys/stat.h>
 #endif
 
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#ifdef HAVE_SYS_UN_H
+#    include <sys/un.h>
+#endif
 
 #ifdef HAVE_SYS_PRCTL_H
 #    include <sys/prctl.h>
@@ -237,15 +244,23 @@ static int mca_btl_sm_component_open(void)
     OBJ_CONSTRUCT(&mca_btl_sm_component.pending_endpoints, opal_list_t);
     OBJ_CONSTRUCT(&mca_btl_sm_component.pending_fragments, opal_list_t);
 
+    mca_btl_sm_component.wake_enabled = false;
+    mca_btl_sm_component.wake_fd = -1;
+    mca_btl_sm_component.wake_path = NULL;
+
     return OPAL_SUCCESS;
 }
 
+static void mca_btl_sm_wake_fini(mca_btl_sm_component_t *component);
+
 /*
  * component cleanup - sanity checking of queue lengths
  */
 
 static int mca_btl_sm_component_close(void)
 {
+    mca_btl_sm_wake_fini(&mca_btl_sm_component);
+
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_eager);
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_user);
     OBJ_DESTRUCT(&mca_btl_sm_component.sm_frags_max_send);
@@ -291,6 +306,140 @@ static int mca_btl_base_sm_modex_send(void)
     return rc;
 }
 
+/*
+ * Wake up support for opal_progress_wait(). Each process binds a datagram
+ * socket next to its backing file and registers it with the event library.
+ * Before going to sleep the process sets the sleeping flag in its fifo.
+ * Senders that see the flag send a single byte to the socket.
+ */
+static int mca_btl_sm_wake_format_path(char *path, size_t size, int32_t pid)
+{
+    return snprintf(path, size, "%s" OPAL_PATH_SEP "sm_wake.%s.%u.%d",
+                    mca_btl_sm_component.backing_directory, opal_process_info.nodename,
+                    geteuid(), pid);
+}
+
+void mca_btl_sm_wake_peer(int32_t pid)
+{
+#ifdef HAVE_SYS_UN_H
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    char byte = 0;
+    int len;
+
+    len = mca_btl_sm_wake_format_path(addr.sun_path, sizeof(addr.sun_path), pid);
+    if (0 > len || (size_t) len >= sizeof(addr.sun_path)) {
+        return;
+    }
+
+    /* failures are not fatal. the peer wakes up on its own after opal_progress_sleep_usec */
+    (void) sendto(mca_btl_sm_component.wake_fd, &byte, 1, 0, (struct sockaddr *) &addr,
+                  sizeof(addr));
+#endif
+}
+
+static void mca_btl_sm_wake_cb(int fd, short flags, void *arg)
+{
+    char buffer[16];
+
+    /* drain the socket. the event itself is what ends the sleep */
+    while (0 < recv(fd, buffer, sizeof(buffer), 0)) {
+    }
+}
+
+static int mca_btl_sm_sleep_cb(bool sleeping)
+{
+    sm_fifo_t *fifo = mca_btl_sm_component.my_fifo;
+    int count;
+
+    if (!sleeping) {
+        fifo->sleeping = 0;
+        return 0;
+    }
+
+    fifo->sleeping = 1;
+    /* pairs with the barrier in mca_btl_sm_fifo_notify() */
+    opal_atomic_mb();
+
+    count = mca_btl_sm_component_progress();
+    if (count > 0) {
+        fifo->sleeping = 0;
+    }
+
+    return count;
+}
+
+static void mca_btl_sm_wake_init(mca_btl_sm_component_t *component)
+{
+#ifdef HAVE_SYS_UN_H
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    int fd, len;
+
+    if (opal_progress_spin_usec < 0) {
+        /* processes never sleep */
+        return;
+    }
+
+    len = mca_btl_sm_wake_format_path(addr.sun_path, sizeof(addr.sun_path), (int32_t) getpid());
+    if (0 > len || (size_t) len >= sizeof(addr.sun_path)) {
+        BTL_VERBOSE(("backing directory path too long for the wake socket"));
+        return;
+    }
+
+    fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (0 > fd) {
+        BTL_VERBOSE(("could not create wake socket. errno = %d", errno));
+        return;
+    }
+
+    (void) unlink(addr.sun_path);
+    if (0 != bind(fd, (struct sockaddr *) &addr, sizeof(addr))) {
+        BTL_VERBOSE(("could not bind wake socket to %s. errno = %d", addr.sun_path, errno));
+        close(fd);
+        return;
+    }
+
+    (void) opal_fd_set_cloexec(fd);
+    (void) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    component->wake_path = strdup(addr.sun_path);
+    opal_pmix_register_cleanup(component->wake_path, false, false, false);
+
+    opal_event_set(opal_sync_event_base, &component->wake_event, fd,
+                   OPAL_EV_READ | OPAL_EV_PERSIST, mca_btl_sm_wake_cb, NULL);
+    opal_event_add(&component->wake_event, NULL);
+    component->wake_fd = fd;
+
+    if (OPAL_SUCCESS != opal_progress_register_sleep(mca_btl_sm_sleep_cb)) {
+        mca_btl_sm_wake_fini(component);
+        return;
+    }
+
+    component->wake_enabled = true;
+#endif
+}
+
+static void mca_btl_sm_wake_fini(mca_btl_sm_component_t *component)
+{
+    if (0 > component->wake_fd) {
+        return;
+    }
+
+    if (component->wake_enabled) {
+        (void) opal_progress_unregister_sleep(mca_btl_sm_sleep_cb);
+        component->wake_enabled = false;
+    }
+
+    opal_event_del(&component->wake_event);
+    close(component->wake_fd);
+    component->wake_fd = -1;
+
+    if (NULL != component->wake_path) {
+        (void) unlink(component->wake_path);
+        free(component->wake_path);
+        component->wake_path = NULL;
+    }
+}
+
 static mca_btl_base_registration_handle_t *
 mca_btl_sm_register_mem(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpoint_t *endpoint,
                         void *base, size_t size, uint32_t flags)
@@ -422,6 +571,9 @@ mca_btl_sm_component_init(int *num_btls, bool enable_progress_threads, bool enab
         goto failed;
     }
 
+    /* let sleeping processes be woken up by senders */
+    mca_btl_sm_wake_init(component);
+
     *num_btls = 1;
 
     /* get pointer to the btls */
@@ -91,6 +91,26 @@ typedef union mca_btl_sm_fbox_hdr_t {
 #define MCA_BTL_SM_FBOX_OFFSET_HBS(v) (!!((v) &MCA_BTL_SM_FBOX_HB_MASK))
 
 void mca_btl_sm_poll_handle_frag(mca_btl_sm_hdr_t *hdr, mca_btl_base_endpoint_t *endpoint);
+void mca_btl_sm_wake_peer(int32_t pid);
+
+/**
+ * Wake up the owner of a fifo if it is sleeping in opal_progress_wait(). Must
+ * be called after new data has been made visible to the owner (either in its
+ * fifo or in one of its fast boxes).
+ */
+static inline void mca_btl_sm_fifo_notify(struct sm_fifo_t *fifo)
+{
+    if (OPAL_LIKELY(!mca_btl_sm_component.wake_enabled)) {
+        return;
+    }
+
+    /* pairs with the barrier in the sleep callback. either the sleeper sees
+     * the new data or we see the sleeping flag */
+    opal_atomic_mb();
+    if (OPAL_UNLIKELY(fifo->sleeping) && opal_atomic_swap_32(&fifo->sleeping, 0)) {
+        mca_btl_sm_wake_peer(fifo->pid);
+    }
+}
 
 static inline void mca_btl_sm_fbox_set_header(mca_btl_sm_fbox_hdr_t *hdr, uint16_t tag,
                                               uint16_t seq, uint32_t size)
@@ -221,6 +241,8 @@ static inline bool mca_btl_sm_fbox_sendi(mca_btl_base_endpoint_t *ep, unsigned c
     opal_atomic_wmb();
     OPAL_THREAD_UNLOCK(&ep->lock);
 
+    mca_btl_sm_fifo_notify(ep->fifo);
+
     return true;
 }
 
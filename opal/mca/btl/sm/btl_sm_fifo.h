@@ -29,6 +29,8 @@
 
 #include "opal_config.h"
 
+#include <unistd.h>
+
 #include "opal/mca/btl/sm/btl_sm_fbox.h"
 #include "opal/mca/btl/sm/btl_sm_types.h"
 #include "opal/mca/btl/sm/btl_sm_virtual.h"
@@ -114,6 +116,8 @@ static inline void sm_fifo_init(sm_fifo_t *fifo)
     fifo->fifo_head = SM_FIFO_FREE;
     fifo->fifo_tail = SM_FIFO_FREE;
     fifo->fbox_available = mca_btl_sm_component.fbox_max;
+    fifo->sleeping = 0;
+    fifo->pid = (int32_t) getpid();
     mca_btl_sm_component.my_fifo = fifo;
 }
 
@@ -135,6 +139,8 @@ static inline void sm_fifo_write(sm_fifo_t *fifo, fifo_value_t value)
     }
 
     opal_atomic_wmb();
+
+    mca_btl_sm_fifo_notify(fifo);
 }
 
 /**
@@ -26,6 +26,7 @@
 #define MCA_BTL_SM_SEND_FRAG_H
 
 #include "opal_config.h"
+#include "opal/runtime/opal_trace.h"
 
 static inline mca_btl_sm_frag_t *mca_btl_sm_frag_alloc(opal_free_list_t *list,
                                                        struct mca_btl_base_endpoint_t *endpoint)
@@ -67,6 +68,11 @@ static inline void mca_btl_sm_frag_complete(mca_btl_sm_frag_t *frag)
     /* save the descriptor flags since the callback is allowed to free the frag */
     int des_flags = frag->base.des_flags;
 
+    OPAL_TRACE(OPAL_TRACE_BTL_SM_SEND_COMPLETE, frag->endpoint->proc->proc_name.vpid,
+               frag->hdr ? frag->hdr->tag : 0, 0,
+               frag->segments[0].seg_len
+                   + (2 == frag->base.des_segment_count ? frag->segments[1].seg_len : 0));
+
     if (OPAL_UNLIKELY(MCA_BTL_DES_SEND_ALWAYS_CALLBACK & des_flags)) {
         /* completion callback */
         frag->base.des_cbfunc(&mca_btl_sm.super, frag->endpoint, &frag->base, OPAL_SUCCESS);
@@ -149,8 +149,6 @@ static int sm_btl_first_time_init(mca_btl_sm_t *sm_btl, int n)
 static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal_proc_t *proc)
 {
     mca_btl_sm_component_t *component = &mca_btl_sm_component;
-    mca_btl_sm_modex_t *modex;
-    size_t msg_size;
     int rc;
 
     uint16_t peer_local_rank;
@@ -167,15 +165,11 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
     OBJ_CONSTRUCT(ep, mca_btl_sm_endpoint_t);
 
     ep->peer_smp_rank = peer_local_rank;
+    ep->proc = proc;
 
     if (peer_local_rank != MCA_BTL_SM_LOCAL_RANK) {
-        OPAL_MODEX_RECV_IMMEDIATE(rc, &component->super.btl_version, &proc->proc_name,
-                                  (void **) &modex, &msg_size);
-        if (OPAL_SUCCESS != rc) {
-            return rc;
-        }
-
-        /* attach to the remote segment */
+        /* the single copy endpoint decides whether RDMA is available, so it can not
+         * wait for the first communication */
         ep->smsc_endpoint = NULL;  /* assume no one sided support */
         if( NULL != mca_smsc ) {
             ep->smsc_endpoint = MCA_SMSC_CALL(get_endpoint, proc);
@@ -186,43 +180,98 @@ static int init_sm_endpoint(struct mca_btl_base_endpoint_t **ep_out, struct opal
             mca_btl_sm.super.btl_put = NULL;
             mca_btl_sm.super.btl_flags &= ~MCA_BTL_FLAGS_RDMA;
         }
-        if (mca_smsc_base_has_feature(MCA_SMSC_FEATURE_CAN_MAP)) {
-            ep->smsc_map_context = MCA_SMSC_CALL(map_peer_region, ep->smsc_endpoint, /*flag=*/0,
-                                                 (void *) (uintptr_t) modex->segment_base,
-                                                 mca_btl_sm_component.segment_size,
-                                                 (void **) &ep->segment_base);
-        } else {
-            /* store a copy of the segment information for detach */
-            ep->seg_ds = malloc(modex->seg_ds_size);
-            if (NULL == ep->seg_ds) {
-                return OPAL_ERR_OUT_OF_RESOURCE;
-            }
 
-            memcpy(ep->seg_ds, &modex->seg_ds, modex->seg_ds_size);
+        OBJ_CONSTRUCT(&ep->lock, opal_mutex_t);
 
-            ep->segment_base = opal_shmem_segment_attach(ep->seg_ds);
-            if (NULL == ep->segment_base) {
-                return OPAL_ERROR;
-            }
-        }
+        /* the peer's segment is attached by mca_btl_sm_endpoint_attach() */
+        return OPAL_SUCCESS;
+    }
 
-        OBJ_CONSTRUCT(&ep->lock, opal_mutex_t);
+    /* set up the segment base so we can calculate a virtual to real for local pointers */
+    ep->segment_base = component->my_segment;
+    ep->fifo = (struct sm_fifo_t *) ep->segment_base;
 
-        free(modex);
+    return OPAL_SUCCESS;
+}
+
+int mca_btl_sm_endpoint_attach(struct mca_btl_base_endpoint_t *ep)
+{
+    static opal_mutex_t attach_lock = OPAL_MUTEX_STATIC_INIT;
+    mca_btl_sm_modex_t *modex;
+    char *segment_base = NULL;
+    size_t msg_size;
+    int rc;
+
+    if (NULL == ep->proc) {
+        return OPAL_ERR_UNREACH;
+    }
+
+    /* not the component lock: segments may be attached while it is held */
+    OPAL_THREAD_LOCK(&attach_lock);
+    if (NULL != ep->segment_base) {
+        OPAL_THREAD_UNLOCK(&attach_lock);
+        return OPAL_SUCCESS;
+    }
+
+    OPAL_MODEX_RECV_IMMEDIATE(rc, &mca_btl_sm_component.super.btl_version, &ep->proc->proc_name,
+                              (void **) &modex, &msg_size);
+    if (OPAL_SUCCESS != rc) {
+        OPAL_THREAD_UNLOCK(&attach_lock);
+        return rc;
+    }
+
+    if (mca_smsc_base_has_feature(MCA_SMSC_FEATURE_CAN_MAP)) {
+        ep->smsc_map_context = MCA_SMSC_CALL(map_peer_region, ep->smsc_endpoint, /*flag=*/0,
+                                             (void *) (uintptr_t) modex->segment_base,
+                                             mca_btl_sm_component.segment_size,
+                                             (void **) &segment_base);
     } else {
-        /* set up the segment base so we can calculate a virtual to real for local pointers */
-        ep->segment_base = component->my_segment;
+        /* store a copy of the segment information for detach */
+        ep->seg_ds = malloc(modex->seg_ds_size);
+        if (NULL != ep->seg_ds) {
+            memcpy(ep->seg_ds, &modex->seg_ds, modex->seg_ds_size);
+            segment_base = opal_shmem_segment_attach(ep->seg_ds);
+            if (NULL == segment_base) {
+                free(ep->seg_ds);
+                ep->seg_ds = NULL;
+            }
+        }
     }
+    free(modex);
 
-    ep->fifo = (struct sm_fifo_t *) ep->segment_base;
+    if (NULL == segment_base) {
+        OPAL_THREAD_UNLOCK(&attach_lock);
+        BTL_ERROR(("could not attach to the shared memory segment of local peer %d",
+                   ep->peer_smp_rank));
+        return OPAL_ERROR;
+    }
+
+    /* the senders check fifo and the receivers segment_base without the lock */
+    opal_atomic_wmb();
+    ep->fifo = (struct sm_fifo_t *) segment_base;
+    ep->segment_base = segment_base;
+    OPAL_THREAD_UNLOCK(&attach_lock);
 
     return OPAL_SUCCESS;
 }
 
+char *mca_btl_sm_endpoint_attach_recv(struct mca_btl_base_endpoint_t *ep)
+{
+    if (OPAL_SUCCESS != mca_btl_sm_endpoint_attach(ep)) {
+        if (NULL != mca_btl_sm.error_cb) {
+            mca_btl_sm.error_cb(&mca_btl_sm.super, MCA_BTL_ERROR_FLAGS_FATAL, NULL,
+                                "could not attach to the shared memory segment of a local peer");
+        }
+        abort();
+    }
+
+    return ep->segment_base;
+}
+
 static int fini_sm_endpoint(struct mca_btl_base_endpoint_t *ep)
 {
     /* check if the endpoint is initialized. avoids a double-destruct */
-    if (ep->fifo) {
+    if (ep->proc) {
         OBJ_DESTRUCT(ep);
     }
 
@@ -553,6 +602,7 @@ static void mca_btl_sm_endpoint_destructor(mca_btl_sm_endpoint_t *ep)
     ep->fbox_out.fbox = NULL;
     ep->segment_base = NULL;
     ep->fifo = NULL;
+    ep->proc = NULL;
 }
 
 OBJ_CLASS_INSTANCE(mca_btl_sm_endpoint_t, opal_list_item_t, mca_btl_sm_endpoint_constructor,
@@ -41,6 +41,13 @@ int mca_btl_sm_send(struct mca_btl_base_module_t *btl, struct mca_btl_base_endpo
     mca_btl_sm_frag_t *frag = (mca_btl_sm_frag_t *) descriptor;
     const size_t total_size = frag->segments[0].seg_len;
 
+    if (OPAL_UNLIKELY(NULL == endpoint->fifo)) {
+        int rc = mca_btl_sm_endpoint_attach(endpoint);
+        if (OPAL_SUCCESS != rc) {
+            return rc;
+        }
+    }
+
     if (frag->base.des_cbfunc) {
         /* in order to work around a long standing ob1 bug (see #3845) we have to always
          * make the callback. once this is fixed in ob1 we can restore the code below. */
@@ -46,6 +46,16 @@ int mca_btl_sm_sendi(struct mca_btl_base_module_t *btl, struct mca_btl_base_endp
     void *data_ptr = NULL;
     size_t length;
 
+    if (OPAL_UNLIKELY(NULL == endpoint->fifo)) {
+        int rc = mca_btl_sm_endpoint_attach(endpoint);
+        if (OPAL_SUCCESS != rc) {
+            if (descriptor) {
+                *descriptor = NULL;
+            }
+            return rc;
+        }
+    }
+
     /* don't attempt sendi if there are pending fragments on the endpoint */
     if (OPAL_UNLIKELY(opal_list_get_size(&endpoint->pending_frags))) {
         if (descriptor) {
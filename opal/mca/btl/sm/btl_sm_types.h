@@ -36,6 +36,7 @@
 #include "opal/class/opal_free_list.h"
 #include "opal/mca/btl/btl.h"
 #include "opal/mca/smsc/smsc.h"
+#include "opal/util/event.h"
 
 /*
  * Modex data
@@ -70,11 +71,13 @@ typedef struct mca_btl_base_endpoint_t {
 
     uint16_t peer_smp_rank;        /**< my peer's SMP process rank.  Used for accessing
                                     *   SMP specfic data structures. */
+    struct opal_proc_t *proc;      /**< peer process */
     opal_atomic_size_t send_count; /**< number of fragments sent to this peer */
     char *segment_base;            /**< start of the peer's segment (in the address space
-                                    *   of this process) */
+                                    *   of this process). NULL until the segment is attached
+                                    *   at the first communication with the peer. */
 
-    struct sm_fifo_t *fifo; /**< */
+    struct sm_fifo_t *fifo; /**< peer's fifo, NULL until the segment is attached */
 
     opal_mutex_t lock; /**< lock to protect endpoint structures from concurrent
                         *   access */
@@ -133,6 +136,11 @@ struct mca_btl_sm_component_t {
     char *backing_directory; /**< directory to place shared memory backing files */
 
     mca_mpool_base_module_t *mpool;
+
+    bool wake_enabled;       /**< peers may sleep in opal_progress_wait() */
+    int wake_fd;             /**< datagram socket used to wake up sleeping peers */
+    char *wake_path;         /**< path wake_fd is bound to */
+    opal_event_t wake_event; /**< read event for wake_fd */
 };
 typedef struct mca_btl_sm_component_t mca_btl_sm_component_t;
 
@@ -232,6 +240,10 @@ struct sm_fifo_t {
     atomic_fifo_value_t fifo_head;
     atomic_fifo_value_t fifo_tail;
     opal_atomic_int32_t fbox_available;
+    /** owner of the fifo is (about to go) to sleep in opal_progress_wait() */
+    opal_atomic_int32_t sleeping;
+    /** pid of the owner. used to find its wake socket */
+    int32_t pid;
 };
 typedef struct sm_fifo_t sm_fifo_t;
 
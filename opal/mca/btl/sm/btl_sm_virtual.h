@@ -66,9 +66,15 @@ static inline fifo_value_t virtual2relativepeer(struct mca_btl_base_endpoint_t *
 
 static inline void *relative2virtual(fifo_value_t offset)
 {
-    return (void *) (intptr_t)(
-        (offset & MCA_BTL_SM_OFFSET_MASK)
-        + mca_btl_sm_component.endpoints[offset >> MCA_BTL_SM_OFFSET_BITS].segment_base);
+    struct mca_btl_base_endpoint_t *endpoint = mca_btl_sm_component.endpoints
+                                               + (offset >> MCA_BTL_SM_OFFSET_BITS);
+    char *segment_base = endpoint->segment_base;
+
+    if (OPAL_UNLIKELY(NULL == segment_base)) {
+        segment_base = mca_btl_sm_endpoint_attach_recv(endpoint);
+    }
+
+    return (void *) (intptr_t)((offset & MCA_BTL_SM_OFFSET_MASK) + segment_base);
 }
 
 #endif /* MCA_BTL_SM_VIRTUAL_H */
@@ -57,6 +57,7 @@
 #include "opal/util/event.h"
 #include "opal/util/net.h"
 #include "opal/util/printf.h"
+#include "opal/runtime/opal_trace.h"
 #include "opal/util/proc.h"
 #include "opal/util/show_help.h"
 #include "opal/util/string_copy.h"
@@ -73,6 +74,23 @@
 
 const char mca_btl_tcp_magic_id_string[MCA_BTL_TCP_MAGIC_STRING_LENGTH] = "OPAL-TCP-BTL";
 
+static inline size_t mca_btl_tcp_frag_payload(const mca_btl_tcp_frag_t *frag)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < frag->base.des_segment_count; ++i) {
+        size += frag->base.des_segments[i].seg_len;
+    }
+    return size;
+}
+
+/*
+ * Record the completion of a send in the event tracer
+ */
+#define MCA_BTL_TCP_ENDPOINT_TRACE_SEND(frag)                                                 \
+    OPAL_TRACE(OPAL_TRACE_BTL_TCP_SEND_COMPLETE,                                              \
+               (frag)->endpoint->endpoint_proc->proc_opal->proc_name.vpid,                    \
+               (frag)->hdr.base.tag, 0, mca_btl_tcp_frag_payload(frag))
+
 /*
  * Initialize state of the endpoint instance.
  *
@@ -368,6 +386,7 @@ int mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t *btl_endpoint, mca_btl_tcp
                 int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
 
                 OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+                MCA_BTL_TCP_ENDPOINT_TRACE_SEND(frag);
                 if (frag->base.des_flags & MCA_BTL_DES_SEND_ALWAYS_CALLBACK) {
                     frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, frag->rc);
                 }
@@ -1113,6 +1132,7 @@ static void mca_btl_tcp_endpoint_send_handler(int sd, short flags, void *user)
 
             /* if required - update request status and release fragment */
             OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+            MCA_BTL_TCP_ENDPOINT_TRACE_SEND(frag);
             assert(frag->base.des_flags & MCA_BTL_DES_SEND_ALWAYS_CALLBACK);
             if (NULL != frag->base.des_cbfunc) {
                 frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, frag->rc);
@@ -38,6 +38,9 @@
 
 #define MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU MCA_RCACHE_FLAGS_MOD_RESV0
 
+/** maximum value of rcache_grdma_lru_batch */
+#define MCA_RCACHE_GRDMA_LRU_BATCH_MAX 64
+
 BEGIN_C_DECLS
 
 struct mca_rcache_grdma_cache_t {
@@ -57,6 +60,8 @@ struct mca_rcache_grdma_component_t {
     char *rcache_name;
     bool print_stats;
     int leave_pinned;
+    /** number of LRU updates a thread collects before applying them */
+    int lru_batch;
 };
 typedef struct mca_rcache_grdma_component_t mca_rcache_grdma_component_t;
 
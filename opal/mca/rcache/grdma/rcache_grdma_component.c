@@ -82,6 +82,17 @@ static int grdma_register(void)
         NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
         &mca_rcache_grdma_component.print_stats);
 
+    mca_rcache_grdma_component.lru_batch = 32;
+    (void) mca_base_component_var_register(
+        &mca_rcache_grdma_component.super.rcache_version, "lru_batch",
+        "number of cache hits whose LRU update each thread collects before applying them "
+        "under the cache lock (0 = update the LRU on every hit, maximum: 64)",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+        &mca_rcache_grdma_component.lru_batch);
+    if (mca_rcache_grdma_component.lru_batch > MCA_RCACHE_GRDMA_LRU_BATCH_MAX) {
+        mca_rcache_grdma_component.lru_batch = MCA_RCACHE_GRDMA_LRU_BATCH_MAX;
+    }
+
     return OPAL_SUCCESS;
 }
 
@@ -74,6 +74,61 @@ static inline bool registration_is_cacheable(mca_rcache_base_registration_t *reg
     return registration_flags_cacheable(reg->flags);
 }
 
+/* reference count of a registration that is being destroyed. lookups never take a
+ * reference on such a registration. */
+#define MCA_RCACHE_GRDMA_REF_DYING -1
+
+/**
+ * Take a reference on a registration found in the cache. Fails if the registration
+ * is being destroyed, otherwise the previous reference count is returned in ref_cnt.
+ */
+static inline bool registration_get(mca_rcache_base_registration_t *reg, int32_t *ref_cnt)
+{
+    int32_t old_cnt = reg->ref_count;
+
+    do {
+        if (old_cnt < 0) {
+            return false;
+        }
+    } while (!opal_atomic_compare_exchange_strong_32(&reg->ref_count, &old_cnt, old_cnt + 1));
+
+    *ref_cnt = old_cnt;
+    return true;
+}
+
+/**
+ * Claim an unreferenced registration for destruction. Only one thread succeeds, and
+ * no lookup can take a reference on the registration afterwards.
+ */
+static inline bool registration_claim(mca_rcache_base_registration_t *reg)
+{
+    int32_t expected = 0;
+
+    return opal_atomic_compare_exchange_strong_32(&reg->ref_count, &expected,
+                                                  MCA_RCACHE_GRDMA_REF_DYING);
+}
+
+/*
+ * Cache hits do not take registrations out of the LRU, they only make them the most
+ * recently used ones. Threads collect these updates and apply them in batches to
+ * avoid taking the cache lock on every hit.
+ */
+#if OPAL_HAVE_THREAD_LOCAL
+struct mca_rcache_grdma_lru_batch_t {
+    mca_rcache_grdma_cache_t *cache;
+    int32_t generation;
+    int count;
+    mca_rcache_base_registration_t *regs[MCA_RCACHE_GRDMA_LRU_BATCH_MAX];
+};
+typedef struct mca_rcache_grdma_lru_batch_t mca_rcache_grdma_lru_batch_t;
+
+static opal_thread_local mca_rcache_grdma_lru_batch_t mca_rcache_grdma_lru_batch;
+
+/* bumped when a module is finalized, which drops the batches of all threads since they
+ * may point to registrations of that module */
+static opal_atomic_int32_t mca_rcache_grdma_lru_generation = 1;
+#endif
+
 #if OPAL_CUDA_GDR_SUPPORT
 static int check_for_cuda_freed_memory(mca_rcache_base_module_t *rcache, void *addr, size_t size);
 #endif /* OPAL_CUDA_GDR_SUPPORT */
@@ -137,8 +192,6 @@ static inline int dereg_mem(mca_rcache_base_registration_t *reg)
     mca_rcache_grdma_module_t *rcache_grdma = (mca_rcache_grdma_module_t *) reg->rcache;
     int rc;
 
-    reg->ref_count = 0;
-
     if (!(reg->flags & MCA_RCACHE_FLAGS_CACHE_BYPASS)) {
         mca_rcache_base_vma_delete(rcache_grdma->cache->vma_module, reg);
     }
@@ -166,41 +219,107 @@ static inline void do_unregistration_gc(mca_rcache_base_module_t *rcache)
     }
 }
 
+/* must be called with the vma lock held */
+static inline void mca_rcache_grdma_lru_move_to_tail(mca_rcache_grdma_cache_t *cache,
+                                                     mca_rcache_base_registration_t *grdma_reg)
+{
+    /* registrations that left the LRU since the update was recorded are skipped */
+    if (grdma_reg->flags & MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU) {
+        opal_list_remove_item(&cache->lru_list, (opal_list_item_t *) grdma_reg);
+        opal_list_append(&cache->lru_list, (opal_list_item_t *) grdma_reg);
+    }
+}
+
+#if OPAL_HAVE_THREAD_LOCAL
+static void mca_rcache_grdma_lru_flush(mca_rcache_grdma_lru_batch_t *batch)
+{
+    opal_mutex_lock(&batch->cache->vma_module->vma_lock);
+    for (int i = 0; i < batch->count; ++i) {
+        mca_rcache_grdma_lru_move_to_tail(batch->cache, batch->regs[i]);
+    }
+    opal_mutex_unlock(&batch->cache->vma_module->vma_lock);
+
+    batch->count = 0;
+}
+#endif
+
+/**
+ * Record that a registration in the LRU was used again.
+ */
+static inline void mca_rcache_grdma_lru_touch(mca_rcache_grdma_cache_t *cache,
+                                              mca_rcache_base_registration_t *grdma_reg)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    if (0 < mca_rcache_grdma_component.lru_batch) {
+        mca_rcache_grdma_lru_batch_t *batch = &mca_rcache_grdma_lru_batch;
+
+        if (batch->generation != mca_rcache_grdma_lru_generation) {
+            batch->generation = mca_rcache_grdma_lru_generation;
+            batch->count = 0;
+        } else if (batch->cache != cache && 0 < batch->count) {
+            mca_rcache_grdma_lru_flush(batch);
+        }
+
+        batch->cache = cache;
+        batch->regs[batch->count++] = grdma_reg;
+        if (batch->count >= mca_rcache_grdma_component.lru_batch) {
+            mca_rcache_grdma_lru_flush(batch);
+        }
+        return;
+    }
+#endif
+
+    opal_mutex_lock(&cache->vma_module->vma_lock);
+    mca_rcache_grdma_lru_move_to_tail(cache, grdma_reg);
+    opal_mutex_unlock(&cache->vma_module->vma_lock);
+}
+
 static inline mca_rcache_base_registration_t *
 mca_rcache_grdma_remove_lru_head(mca_rcache_grdma_cache_t *cache)
 {
     mca_rcache_base_registration_t *old_reg;
-    int32_t old_flags;
+    size_t count;
 
-    do {
-        opal_mutex_lock(&cache->vma_module->vma_lock);
-        old_reg = (mca_rcache_base_registration_t *) opal_list_remove_first(&cache->lru_list);
-        if (NULL == old_reg) {
-            opal_mutex_unlock(&cache->vma_module->vma_lock);
-            break;
-        }
+#if OPAL_HAVE_THREAD_LOCAL
+    /* apply our own pending updates so we do not evict what we just used */
+    if (cache == mca_rcache_grdma_lru_batch.cache && 0 < mca_rcache_grdma_lru_batch.count
+        && mca_rcache_grdma_lru_batch.generation == mca_rcache_grdma_lru_generation) {
+        mca_rcache_grdma_lru_flush(&mca_rcache_grdma_lru_batch);
+    }
+#endif
 
-        do {
-            int32_t new_flags;
-            old_flags = old_reg->flags;
-            /* registration has been selected for removal and is no longer in the LRU. mark it
-             * as such. */
-            new_flags = (old_flags & ~MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU) | MCA_RCACHE_FLAGS_INVALID;
-            if (opal_atomic_compare_exchange_strong_32((opal_atomic_int32_t *) &old_reg->flags,
-                                                       &old_flags, new_flags)) {
-                break;
-            }
-        } while (1);
-        opal_mutex_unlock(&cache->vma_module->vma_lock);
+    opal_mutex_lock(&cache->vma_module->vma_lock);
+
+    /* registrations in use stay in the LRU, look at each of them at most once */
+    for (count = opal_list_get_size(&cache->lru_list); count > 0; --count) {
+        old_reg = (mca_rcache_base_registration_t *) opal_list_remove_first(&cache->lru_list);
 
-        if (old_flags & MCA_RCACHE_FLAGS_INVALID) {
+        if (old_reg->flags & MCA_RCACHE_FLAGS_INVALID) {
             /* registration was already invalidated. in this case its fate is being determined
              * by another thread. */
+            (void) opal_atomic_fetch_and_32((opal_atomic_int32_t *) &old_reg->flags,
+                                            ~MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU);
             continue;
         }
 
+        if (!registration_claim(old_reg)) {
+            /* in use, so it is the most recently used registration */
+            opal_list_append(&cache->lru_list, (opal_list_item_t *) old_reg);
+            continue;
+        }
+
+        /* registration has been selected for removal and is no longer in the LRU. mark it
+         * as such. */
+        (void) opal_atomic_fetch_and_32((opal_atomic_int32_t *) &old_reg->flags,
+                                        ~MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU);
+        (void) opal_atomic_fetch_or_32((opal_atomic_int32_t *) &old_reg->flags,
+                                       MCA_RCACHE_FLAGS_INVALID);
+        opal_mutex_unlock(&cache->vma_module->vma_lock);
+
         return old_reg;
-    } while (1);
+    }
+
+    opal_mutex_unlock(&cache->vma_module->vma_lock);
 
     return NULL;
 }
@@ -243,14 +362,17 @@ static inline void mca_rcache_grdma_add_to_lru(mca_rcache_grdma_module_t *rcache
 {
     opal_mutex_lock(&rcache_grdma->cache->vma_module->vma_lock);
 
-    opal_list_append(&rcache_grdma->cache->lru_list, (opal_list_item_t *) grdma_reg);
+    /* a registration invalidated in the meantime is on its way to the gc list */
+    if (!(grdma_reg->flags & (MCA_RCACHE_FLAGS_INVALID | MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU))) {
+        opal_list_append(&rcache_grdma->cache->lru_list, (opal_list_item_t *) grdma_reg);
 
-    /* ensure the append is complete before setting the flag */
-    opal_atomic_wmb();
+        /* ensure the append is complete before setting the flag */
+        opal_atomic_wmb();
 
-    /* mark this registration as being in the LRU */
-    opal_atomic_fetch_or_32((opal_atomic_int32_t *) &grdma_reg->flags,
-                            MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU);
+        /* mark this registration as being in the LRU */
+        opal_atomic_fetch_or_32((opal_atomic_int32_t *) &grdma_reg->flags,
+                                MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU);
+    }
 
     opal_mutex_unlock(&rcache_grdma->cache->vma_module->vma_lock);
 }
@@ -258,18 +380,16 @@ static inline void mca_rcache_grdma_add_to_lru(mca_rcache_grdma_module_t *rcache
 static inline void mca_rcache_grdma_remove_from_lru(mca_rcache_grdma_module_t *rcache_grdma,
                                                     mca_rcache_base_registration_t *grdma_reg)
 {
-    /* if the reference count was observed to be 0 (which must be the case for this
-     * function to be called then some thread deregistered the region. it may be the
-     * case that the deregistration is still ongoing so wait until the deregistration
-     * thread has marked this registration as being in the lru before continuing */
-    while (!(grdma_reg->flags & MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU)) {
-    }
-
-    /* opal lists are not thread safe at this time so we must lock :'( */
+    /* opal lists are not thread safe at this time so we must lock :'(. the flag only
+     * changes with the lock held. a deregistration that has not added the registration
+     * to the LRU yet will see it is invalid and leave it out. */
     opal_mutex_lock(&rcache_grdma->cache->vma_module->vma_lock);
-    opal_list_remove_item(&rcache_grdma->cache->lru_list, (opal_list_item_t *) grdma_reg);
-    /* clear the LRU flag */
-    grdma_reg->flags &= ~MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU;
+    if (grdma_reg->flags & MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU) {
+        opal_list_remove_item(&rcache_grdma->cache->lru_list, (opal_list_item_t *) grdma_reg);
+        /* clear the LRU flag */
+        (void) opal_atomic_fetch_and_32((opal_atomic_int32_t *) &grdma_reg->flags,
+                                        ~MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU);
+    }
     opal_mutex_unlock(&rcache_grdma->cache->vma_module->vma_lock);
 }
 
@@ -290,15 +410,19 @@ static int mca_rcache_grdma_check_cached(mca_rcache_base_registration_t *grdma_r
         return mca_rcache_grdma_add_to_gc(grdma_reg);
     }
 
-    int32_t ref_cnt = opal_atomic_fetch_add_32(&grdma_reg->ref_count, 1);
-    args->reg = grdma_reg;
-
-    if (0 == ref_cnt) {
-        mca_rcache_grdma_remove_from_lru(rcache_grdma, grdma_reg);
+    /* the registration stays in the LRU while it is in use, this keeps the cache lock
+     * off the hit path */
+    int32_t ref_cnt;
+    if (!registration_get(grdma_reg, &ref_cnt)) {
+        /* being evicted or invalidated */
+        return 0;
     }
+    args->reg = grdma_reg;
 
     /* This segment fits fully within an existing segment. */
-    (void) opal_atomic_fetch_add_32((opal_atomic_int32_t *) &rcache_grdma->stat_cache_hit, 1);
+    if (mca_rcache_grdma_component.print_stats) {
+        (void) opal_atomic_fetch_add_32((opal_atomic_int32_t *) &rcache_grdma->stat_cache_hit, 1);
+    }
     OPAL_OUTPUT_VERBOSE((MCA_BASE_VERBOSE_TRACE, opal_rcache_base_framework.framework_output,
                          "returning existing registration %p. references %d", (void *) grdma_reg,
                          ref_cnt));
@@ -359,7 +483,9 @@ static int mca_rcache_grdma_register(mca_rcache_base_module_t *rcache, void *add
         /* get updated access flags */
         access_flags = find_args.access_flags;
 
-        OPAL_THREAD_ADD_FETCH32((opal_atomic_int32_t *) &rcache_grdma->stat_cache_miss, 1);
+        if (mca_rcache_grdma_component.print_stats) {
+            OPAL_THREAD_ADD_FETCH32((opal_atomic_int32_t *) &rcache_grdma->stat_cache_miss, 1);
+        }
     }
 
     item = opal_free_list_get_mt(&rcache_grdma->reg_list);
@@ -423,6 +549,7 @@ static int mca_rcache_grdma_find(mca_rcache_base_module_t *rcache, void *addr, s
     mca_rcache_grdma_module_t *rcache_grdma = (mca_rcache_grdma_module_t *) rcache;
     unsigned long page_size = opal_getpagesize();
     unsigned char *base, *bound;
+    int32_t ref_cnt;
     int rc;
 
     base = OPAL_DOWN_ALIGN_PTR(addr, page_size, unsigned char *);
@@ -433,13 +560,10 @@ static int mca_rcache_grdma_find(mca_rcache_base_module_t *rcache, void *addr, s
     rc = mca_rcache_base_vma_find(rcache_grdma->cache->vma_module, base, bound - base + 1, reg);
     if (NULL != *reg
         && (mca_rcache_grdma_component.leave_pinned || ((*reg)->flags & MCA_RCACHE_FLAGS_PERSIST)
-            || ((*reg)->base == base && (*reg)->bound == bound))) {
+            || ((*reg)->base == base && (*reg)->bound == bound))
+        && registration_get(*reg, &ref_cnt)) {
         assert(((void *) (*reg)->bound) >= addr);
-        if (0 == (*reg)->ref_count && mca_rcache_grdma_component.leave_pinned) {
-            opal_list_remove_item(&rcache_grdma->cache->lru_list, (opal_list_item_t *) (*reg));
-        }
         rcache_grdma->stat_cache_found++;
-        opal_atomic_add_fetch_32(&(*reg)->ref_count, 1);
     } else {
         rcache_grdma->stat_cache_notfound++;
     }
@@ -467,10 +591,21 @@ static int mca_rcache_grdma_deregister(mca_rcache_base_module_t *rcache,
     }
 
     if (registration_is_cacheable(reg)) {
-        mca_rcache_grdma_add_to_lru(rcache_grdma, reg);
+        if (reg->flags & MCA_RCACHE_GRDMA_REG_FLAG_IN_LRU) {
+            /* still in the LRU from an earlier use, only its position changes */
+            mca_rcache_grdma_lru_touch(rcache_grdma->cache, reg);
+        } else {
+            mca_rcache_grdma_add_to_lru(rcache_grdma, reg);
+        }
         return OPAL_SUCCESS;
     }
 
+    if (!registration_claim(reg)) {
+        /* another thread found the registration in the cache in the meantime */
+        return OPAL_SUCCESS;
+    }
+
+    mca_rcache_grdma_remove_from_lru(rcache_grdma, reg);
     return dereg_mem(reg);
 }
 
@@ -486,17 +621,16 @@ static int mca_rcache_grdma_add_to_gc(mca_rcache_base_registration_t *grdma_reg)
     uint32_t flags = opal_atomic_fetch_or_32((opal_atomic_int32_t *) &grdma_reg->flags,
                                              MCA_RCACHE_FLAGS_INVALID);
 
-    if ((flags & MCA_RCACHE_FLAGS_INVALID) || 0 != grdma_reg->ref_count) {
-        /* nothing to do */
+    if ((flags & MCA_RCACHE_FLAGS_INVALID) || !registration_claim(grdma_reg)) {
+        /* nothing to do. a registration in use is destroyed when its last reference
+         * is returned. */
         return OPAL_SUCCESS;
     }
 
     /* This may be called from free() so avoid recursively calling into free by just
      * shifting this registration into the garbage collection list. The cleanup will
      * be done on the next registration attempt. */
-    if (registration_flags_cacheable(flags)) {
-        mca_rcache_grdma_remove_from_lru(rcache_grdma, grdma_reg);
-    }
+    mca_rcache_grdma_remove_from_lru(rcache_grdma, grdma_reg);
 
     opal_lifo_push_atomic(&rcache_grdma->cache->gc_lifo, (opal_list_item_t *) grdma_reg);
 
@@ -578,6 +712,11 @@ static void mca_rcache_grdma_finalize(mca_rcache_base_module_t *rcache)
                     (long) mca_rcache_base_vma_size(rcache_grdma->cache->vma_module));
     }
 
+#if OPAL_HAVE_THREAD_LOCAL
+    /* pending LRU updates of any thread may refer to registrations of this module */
+    (void) opal_atomic_fetch_add_32(&mca_rcache_grdma_lru_generation, 1);
+#endif
+
     do_unregistration_gc(&rcache_grdma->super);
 
     (void) mca_rcache_base_vma_iterate(rcache_grdma->cache->vma_module, NULL, (size_t) -1, true,
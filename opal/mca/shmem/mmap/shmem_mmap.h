@@ -32,6 +32,16 @@ BEGIN_C_DECLS
 extern int opal_shmem_mmap_relocate_backing_file;
 extern char *opal_shmem_mmap_backing_file_base_dir;
 extern bool opal_shmem_mmap_nfs_warning;
+extern int opal_shmem_mmap_hugepages;
+extern char *opal_shmem_mmap_hugepage_dir;
+extern size_t opal_shmem_mmap_hugepage_size;
+
+/**
+ * values of opal_shmem_mmap_hugepages
+ */
+#define OPAL_SHMEM_MMAP_HUGEPAGES_NONE      0
+#define OPAL_SHMEM_MMAP_HUGEPAGES_THP       1
+#define OPAL_SHMEM_MMAP_HUGEPAGES_HUGETLBFS 2
 
 /**
  * globally exported variable to hold the mmap component.
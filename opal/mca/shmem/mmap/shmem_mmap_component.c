@@ -43,6 +43,9 @@ const char *opal_shmem_mmap_component_version_string
 int opal_shmem_mmap_relocate_backing_file = 0;
 char *opal_shmem_mmap_backing_file_base_dir = NULL;
 bool opal_shmem_mmap_nfs_warning = true;
+int opal_shmem_mmap_hugepages = OPAL_SHMEM_MMAP_HUGEPAGES_NONE;
+char *opal_shmem_mmap_hugepage_dir = NULL;
+size_t opal_shmem_mmap_hugepage_size = 0;
 
 /**
  * local functions
@@ -161,6 +164,45 @@ static int mmap_register(void)
         return ret;
     }
 
+    opal_shmem_mmap_hugepages = OPAL_SHMEM_MMAP_HUGEPAGES_NONE;
+    ret = mca_base_component_var_register(
+        &mca_shmem_mmap_component.super.base_version, "hugepages",
+        "Back shared memory segments with huge pages to reduce TLB misses "
+        "(0 = do not use huge pages, 1 = advise the kernel to use transparent "
+        "huge pages, 2 = create segments on a hugetlbfs mount, and fall back "
+        "to transparent huge pages if that is not possible).",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+        MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_shmem_mmap_hugepages);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_shmem_mmap_hugepage_dir = NULL;
+    ret = mca_base_component_var_register(&mca_shmem_mmap_component.super.base_version,
+                                          "hugepage_dir",
+                                          "hugetlbfs mount where segments are created when "
+                                          "shmem_mmap_hugepages is 2 (default: search "
+                                          "/proc/mounts).",
+                                          MCA_BASE_VAR_TYPE_STRING, NULL, 0,
+                                          MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                          MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_shmem_mmap_hugepage_dir);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_shmem_mmap_hugepage_size = 0;
+    ret = mca_base_component_var_register(&mca_shmem_mmap_component.super.base_version,
+                                          "hugepage_size",
+                                          "Size of the huge pages to look for in /proc/mounts "
+                                          "when shmem_mmap_hugepages is 2, e.g. 2097152 or "
+                                          "1073741824 (0 = smallest available).",
+                                          MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0,
+                                          MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                          MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_shmem_mmap_hugepage_size);
+    if (0 > ret) {
+        return ret;
+    }
+
     return OPAL_SUCCESS;
 }
 
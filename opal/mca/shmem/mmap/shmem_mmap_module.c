@@ -48,6 +48,18 @@
 #ifdef HAVE_SYS_STAT_H
 #    include <sys/stat.h>
 #endif /* HAVE_SYS_STAT_H */
+#ifdef HAVE_SYS_VFS_H
+#    include <sys/vfs.h>
+#endif /* HAVE_SYS_VFS_H */
+#ifdef HAVE_SYS_MOUNT_H
+#    include <sys/mount.h>
+#endif /* HAVE_SYS_MOUNT_H */
+#ifdef HAVE_SYS_STATVFS_H
+#    include <sys/statvfs.h>
+#endif /* HAVE_SYS_STATVFS_H */
+#ifdef HAVE_MNTENT_H
+#    include <mntent.h>
+#endif /* HAVE_MNTENT_H */
 
 #include "opal/constants.h"
 #include "opal/mca/shmem/base/base.h"
@@ -62,6 +74,16 @@
 
 #include "shmem_mmap.h"
 
+/*
+ * Note that some OS's (e.g., NetBSD and Solaris) have statfs(), but
+ * no struct statfs (!).  So check to make sure we have struct statfs
+ * before allowing the use of statfs().
+ */
+#if defined(HAVE_STATFS) \
+    && (defined(HAVE_STRUCT_STATFS_F_FSTYPENAME) || defined(HAVE_STRUCT_STATFS_F_TYPE))
+#    define USE_STATFS 1
+#endif
+
 /* for tons of debug output: -mca shmem_base_verbose 70 */
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -84,6 +106,10 @@ static int module_finalize(void);
 static int enough_space(const char *filename, size_t space_req, uint64_t *space_avail,
                         bool *result);
 
+/* hugetlbfs mount used for new segments, NULL if none is usable */
+static char *hugetlbfs_dir = NULL;
+static size_t hugetlbfs_page_size = 0;
+
 /*
  * mmap shmem module
  */
@@ -163,17 +189,114 @@ out:
     return rc;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * returns the block size of the file system holding path, which is the page
+ * size on hugetlbfs. returns 0 if it cannot be determined.
+ */
+static size_t fs_block_size(const char *path)
+{
+#if defined(USE_STATFS)
+    struct statfs info;
+
+    if (0 == statfs(path, &info)) {
+        return (size_t) info.f_bsize;
+    }
+#elif defined(HAVE_STATVFS)
+    struct statvfs info;
+
+    if (0 == statvfs(path, &info)) {
+        return (size_t) info.f_bsize;
+    }
+#endif
+    return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * picks the hugetlbfs mount new segments are created on: the one given by
+ * shmem_mmap_hugepage_dir, or else the writable mount in /proc/mounts with the
+ * requested page size (the smallest page size if none was requested).
+ */
+static void find_hugetlbfs(void)
+{
+    if (NULL != opal_shmem_mmap_hugepage_dir && '\0' != opal_shmem_mmap_hugepage_dir[0]) {
+        hugetlbfs_page_size = fs_block_size(opal_shmem_mmap_hugepage_dir);
+        if (0 != hugetlbfs_page_size
+            && 0 == access(opal_shmem_mmap_hugepage_dir, R_OK | W_OK | X_OK)) {
+            hugetlbfs_dir = strdup(opal_shmem_mmap_hugepage_dir);
+        }
+        return;
+    }
+
+#ifdef HAVE_MNTENT_H
+    FILE *fh;
+    struct mntent *mntent;
+
+    fh = setmntent("/proc/mounts", "r");
+    if (NULL == fh) {
+        return;
+    }
+
+    while (NULL != (mntent = getmntent(fh))) {
+        size_t page_size;
+
+        if (0 != strcmp(mntent->mnt_type, "hugetlbfs")
+            || 0 != access(mntent->mnt_dir, R_OK | W_OK | X_OK)) {
+            continue;
+        }
+        page_size = fs_block_size(mntent->mnt_dir);
+        if (0 == page_size
+            || (0 != opal_shmem_mmap_hugepage_size && page_size != opal_shmem_mmap_hugepage_size)
+            || (NULL != hugetlbfs_dir && page_size >= hugetlbfs_page_size)) {
+            continue;
+        }
+        free(hugetlbfs_dir);
+        hugetlbfs_dir = strdup(mntent->mnt_dir);
+        hugetlbfs_page_size = page_size;
+    }
+
+    endmntent(fh);
+#endif /* HAVE_MNTENT_H */
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * advises the kernel to back the mapping with transparent huge pages. this is
+ * only a hint: it fails harmlessly where transparent huge pages are not
+ * available (on tmpfs they also have to be enabled in
+ * /sys/kernel/mm/transparent_hugepage/shmem_enabled).
+ */
+static inline void advise_hugepages(void *addr, size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+    if (OPAL_SHMEM_MMAP_HUGEPAGES_NONE != opal_shmem_mmap_hugepages) {
+        (void) madvise(addr, size, MADV_HUGEPAGE);
+    }
+#endif
+}
+
 /* ////////////////////////////////////////////////////////////////////////// */
 static int module_init(void)
 {
-    /* nothing to do */
+    if (OPAL_SHMEM_MMAP_HUGEPAGES_HUGETLBFS == opal_shmem_mmap_hugepages) {
+        find_hugetlbfs();
+        if (NULL == hugetlbfs_dir) {
+            OPAL_OUTPUT_VERBOSE((10, opal_shmem_base_framework.framework_output,
+                                 "%s: %s: no usable hugetlbfs mount, falling back to "
+                                 "transparent huge pages\n",
+                                 mca_shmem_mmap_component.super.base_version.mca_type_name,
+                                 mca_shmem_mmap_component.super.base_version.mca_component_name));
+        }
+    }
     return OPAL_SUCCESS;
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
 static int module_finalize(void)
 {
-    /* nothing to do */
+    free(hugetlbfs_dir);
+    hugetlbfs_dir = NULL;
     return OPAL_SUCCESS;
 }
 
@@ -256,6 +379,66 @@ static char *get_uniq_file_name(const char *base_path, const char *hash_key)
     return uniq_name_buf;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * creates the segment on the hugetlbfs mount. the size is rounded up to a
+ * multiple of the huge page size. failures are not reported to the user
+ * because segment_create falls back to regular pages.
+ */
+static int segment_create_hugetlbfs(opal_shmem_ds_t *ds_buf, const char *file_name, size_t size)
+{
+    size_t real_size = (size + hugetlbfs_page_size - 1) / hugetlbfs_page_size * hugetlbfs_page_size;
+    char *real_file_name = NULL;
+    void *segment = MAP_FAILED;
+    int fd, err = 0;
+
+    if (NULL == (real_file_name = get_uniq_file_name(hugetlbfs_dir, file_name))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    if (-1 == (fd = open(real_file_name, O_CREAT | O_RDWR, 0600))) {
+        err = errno;
+    }
+    /* the huge pages are reserved by mmap, so this is where we find out
+     * whether enough of them are free */
+    else if (0 != ftruncate(fd, real_size)
+             || MAP_FAILED
+                    == (segment = mmap(NULL, real_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                                       0))) {
+        err = errno;
+        close(fd);
+        unlink(real_file_name);
+    }
+    if (0 != err) {
+        OPAL_OUTPUT_VERBOSE((10, opal_shmem_base_framework.framework_output,
+                             "%s: %s: could not create %s on hugetlbfs (%s), "
+                             "falling back to regular pages\n",
+                             mca_shmem_mmap_component.super.base_version.mca_type_name,
+                             mca_shmem_mmap_component.super.base_version.mca_component_name,
+                             real_file_name, strerror(err)));
+        free(real_file_name);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    (void) close(fd);
+
+    ds_buf->seg_cpid = getpid();
+    ds_buf->seg_id = fd;
+    ds_buf->seg_size = real_size;
+    ds_buf->seg_base_addr = segment;
+    (void) opal_string_copy(ds_buf->seg_name, real_file_name, OPAL_PATH_MAX);
+    OPAL_SHMEM_DS_SET_VALID(ds_buf);
+
+    OPAL_OUTPUT_VERBOSE((70, opal_shmem_base_framework.framework_output,
+                         "%s: %s: create successful on hugetlbfs "
+                         "(id: %d, size: %lu, page size: %lu, name: %s)\n",
+                         mca_shmem_mmap_component.super.base_version.mca_type_name,
+                         mca_shmem_mmap_component.super.base_version.mca_component_name,
+                         ds_buf->seg_id, (unsigned long) ds_buf->seg_size,
+                         (unsigned long) hugetlbfs_page_size, ds_buf->seg_name));
+
+    free(real_file_name);
+    return OPAL_SUCCESS;
+}
+
 /* ////////////////////////////////////////////////////////////////////////// */
 static int segment_create(opal_shmem_ds_t *ds_buf, const char *file_name, size_t size)
 {
@@ -269,6 +452,13 @@ static int segment_create(opal_shmem_ds_t *ds_buf, const char *file_name, size_t
     /* init the contents of opal_shmem_ds_t */
     shmem_ds_reset(ds_buf);
 
+    if (NULL != hugetlbfs_dir) {
+        if (OPAL_SUCCESS == segment_create_hugetlbfs(ds_buf, file_name, size)) {
+            return OPAL_SUCCESS;
+        }
+        shmem_ds_reset(ds_buf);
+    }
+
     /* change the path of shmem mmap's backing store? */
     if (0 != opal_shmem_mmap_relocate_backing_file) {
         int err;
@@ -375,6 +565,7 @@ static int segment_create(opal_shmem_ds_t *ds_buf, const char *file_name, size_t
     }
     /* all is well */
     else {
+        advise_hugepages(segment, size);
 
         /* -- initialize the contents of opal_shmem_ds_t -- */
         ds_buf->seg_cpid = my_pid;
@@ -454,6 +645,7 @@ static void *segment_attach(opal_shmem_ds_t *ds_buf)
             close(ds_buf->seg_id);
             return NULL;
         }
+        advise_hugepages(ds_buf->seg_base_addr, ds_buf->seg_size);
         /* all is well */
         /* if close fails here, that's okay.  just let the user know and
          * continue.  if we got this far, open and mmap were successful...
@@ -20,4 +20,12 @@ extern mca_smsc_module_t *selected_module;
 int mca_smsc_base_select(void);
 void mca_smsc_base_register_default_params(mca_smsc_component_t *component, int default_priority);
 
+/**
+ * Copy a list of regions with one call of a contiguous copy function per contiguous piece.
+ * For modules that can not transfer a vector of regions at once.
+ */
+int mca_smsc_base_copy_iov(mca_smsc_module_copy_fn_t copy_fn, mca_smsc_endpoint_t *endpoint,
+                           const struct iovec *local_iov, size_t local_count,
+                           const struct iovec *remote_iov, size_t remote_count, void *reg_data);
+
 #endif /* OPAL_MCA_SMSC_BASE_BASE_H */
@@ -107,6 +107,44 @@ int mca_smsc_base_select(void)
     return OPAL_SUCCESS;
 }
 
+int mca_smsc_base_copy_iov(mca_smsc_module_copy_fn_t copy_fn, mca_smsc_endpoint_t *endpoint,
+                           const struct iovec *local_iov, size_t local_count,
+                           const struct iovec *remote_iov, size_t remote_count, void *reg_data)
+{
+    size_t local_index = 0, remote_index = 0, local_offset = 0, remote_offset = 0;
+
+    while (local_index < local_count && remote_index < remote_count) {
+        size_t local_left = local_iov[local_index].iov_len - local_offset;
+        size_t remote_left = remote_iov[remote_index].iov_len - remote_offset;
+        size_t size = (local_left < remote_left) ? local_left : remote_left;
+
+        if (0 < size) {
+            int rc = copy_fn(endpoint,
+                             (void *) ((uintptr_t) local_iov[local_index].iov_base + local_offset),
+                             (void *) ((uintptr_t) remote_iov[remote_index].iov_base
+                                       + remote_offset),
+                             size, reg_data);
+            if (OPAL_SUCCESS != rc) {
+                return rc;
+            }
+        }
+
+        local_offset += size;
+        if (local_offset == local_iov[local_index].iov_len) {
+            ++local_index;
+            local_offset = 0;
+        }
+
+        remote_offset += size;
+        if (remote_offset == remote_iov[remote_index].iov_len) {
+            ++remote_index;
+            remote_offset = 0;
+        }
+    }
+
+    return OPAL_SUCCESS;
+}
+
 void mca_smsc_base_register_default_params(mca_smsc_component_t *component, int default_priority)
 {
 
@@ -26,6 +26,19 @@
 #    include <sys/uio.h>
 #endif /* OPAL_CMA_NEED_SYSCALL_DEFS */
 
+#include <limits.h>
+#include <string.h>
+
+/* largest number of iovec entries passed to a single process_vm_readv/writev call */
+#if defined(IOV_MAX)
+#    define MCA_SMSC_CMA_IOV_MAX IOV_MAX
+#else
+#    define MCA_SMSC_CMA_IOV_MAX 1024
+#endif
+
+/* number of entries rewritten on the stack when a list is resumed in the middle of an entry */
+#define MCA_SMSC_CMA_IOV_SCRATCH 64
+
 OBJ_CLASS_INSTANCE(mca_smsc_cma_endpoint_t, opal_object_t, NULL, NULL);
 
 mca_smsc_endpoint_t *mca_smsc_cma_get_endpoint(opal_proc_t *peer_proc)
@@ -185,6 +198,128 @@ int mca_smsc_cma_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address, v
     return OPAL_SUCCESS;
 }
 
+struct mca_smsc_cma_iov_cursor_t {
+    const struct iovec *iov;
+    size_t count;
+    size_t index;
+    size_t offset;
+};
+typedef struct mca_smsc_cma_iov_cursor_t mca_smsc_cma_iov_cursor_t;
+
+static inline void mca_smsc_cma_cursor_skip_empty(mca_smsc_cma_iov_cursor_t *cursor)
+{
+    while (cursor->index < cursor->count && 0 == cursor->iov[cursor->index].iov_len) {
+        ++cursor->index;
+    }
+}
+
+static inline void mca_smsc_cma_cursor_advance(mca_smsc_cma_iov_cursor_t *cursor, size_t length)
+{
+    while (length > 0) {
+        size_t left = cursor->iov[cursor->index].iov_len - cursor->offset;
+        if (length < left) {
+            cursor->offset += length;
+            return;
+        }
+
+        length -= left;
+        cursor->offset = 0;
+        ++cursor->index;
+    }
+
+    mca_smsc_cma_cursor_skip_empty(cursor);
+}
+
+/**
+ * Get the entries for the next system call. The caller's list is used as is unless the
+ * first entry was partially transferred, in which case a shortened copy is made in scratch.
+ */
+static inline const struct iovec *mca_smsc_cma_cursor_get(mca_smsc_cma_iov_cursor_t *cursor,
+                                                          struct iovec *scratch,
+                                                          unsigned long *count)
+{
+    size_t left = cursor->count - cursor->index;
+
+    if (0 == cursor->offset) {
+        *count = (unsigned long) (left < MCA_SMSC_CMA_IOV_MAX ? left : MCA_SMSC_CMA_IOV_MAX);
+        return cursor->iov + cursor->index;
+    }
+
+    *count = (unsigned long) (left < MCA_SMSC_CMA_IOV_SCRATCH ? left : MCA_SMSC_CMA_IOV_SCRATCH);
+    memcpy(scratch, cursor->iov + cursor->index, *count * sizeof(scratch[0]));
+    scratch[0].iov_base = (void *) ((uintptr_t) scratch[0].iov_base + cursor->offset);
+    scratch[0].iov_len -= cursor->offset;
+
+    return scratch;
+}
+
+static int mca_smsc_cma_copy_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                 size_t local_count, const struct iovec *remote_iov,
+                                 size_t remote_count, bool is_write)
+{
+    mca_smsc_cma_endpoint_t *cma_endpoint = (mca_smsc_cma_endpoint_t *) endpoint;
+    mca_smsc_cma_iov_cursor_t local = {.iov = local_iov, .count = local_count};
+    mca_smsc_cma_iov_cursor_t remote = {.iov = remote_iov, .count = remote_count};
+    struct iovec local_scratch[MCA_SMSC_CMA_IOV_SCRATCH];
+    struct iovec remote_scratch[MCA_SMSC_CMA_IOV_SCRATCH];
+
+    mca_smsc_cma_cursor_skip_empty(&local);
+    mca_smsc_cma_cursor_skip_empty(&remote);
+
+    /* as many entries as the kernel takes are transferred by each call. a call may stop
+     * early (see the comment in mca_smsc_cma_copy_to) in which case the lists are resumed
+     * where it stopped */
+    while (local.index < local.count && remote.index < remote.count) {
+        const struct iovec *liov, *riov;
+        unsigned long lcount, rcount;
+        ssize_t ret;
+
+        liov = mca_smsc_cma_cursor_get(&local, local_scratch, &lcount);
+        riov = mca_smsc_cma_cursor_get(&remote, remote_scratch, &rcount);
+
+        if (is_write) {
+            ret = process_vm_writev(cma_endpoint->pid, liov, lcount, riov, rcount, 0);
+        } else {
+            ret = process_vm_readv(cma_endpoint->pid, liov, lcount, riov, rcount, 0);
+        }
+
+        if (0 >= ret) {
+            OPAL_OUTPUT_VERBOSE((MCA_BASE_VERBOSE_ERROR, opal_smsc_base_framework.framework_output,
+                                 "CMA %s of %lu local and %lu remote entries returned %ld, "
+                                 "errno = %d",
+                                 is_write ? "write" : "read", lcount, rcount, (long) ret, errno));
+            return OPAL_ERROR;
+        }
+
+        mca_smsc_cma_cursor_advance(&local, (size_t) ret);
+        mca_smsc_cma_cursor_advance(&remote, (size_t) ret);
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int mca_smsc_cma_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                             size_t local_count, const struct iovec *remote_iov,
+                             size_t remote_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    return mca_smsc_cma_copy_iov(endpoint, local_iov, local_count, remote_iov, remote_count,
+                                 /*is_write=*/true);
+}
+
+int mca_smsc_cma_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                               size_t local_count, const struct iovec *remote_iov,
+                               size_t remote_count, void *reg_handle)
+{
+    /* ignore the registration handle as it is not used for CMA */
+    (void) reg_handle;
+
+    return mca_smsc_cma_copy_iov(endpoint, local_iov, local_count, remote_iov, remote_count,
+                                 /*is_write=*/false);
+}
+
 /* unsupported interfaces defined to support MCA direct */
 void *mca_smsc_cma_map_peer_region(mca_smsc_endpoint_t *endpoint, uint64_t flags,
                                    void *remote_address, size_t size, void **local_mapping)
@@ -210,4 +345,6 @@ mca_smsc_module_t mca_smsc_cma_module = {
     .return_endpoint = mca_smsc_cma_return_endpoint,
     .copy_to = mca_smsc_cma_copy_to,
     .copy_from = mca_smsc_cma_copy_from,
+    .copy_to_iov = mca_smsc_cma_copy_to_iov,
+    .copy_from_iov = mca_smsc_cma_copy_from_iov,
 };
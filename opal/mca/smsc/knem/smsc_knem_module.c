@@ -133,6 +133,22 @@ int mca_smsc_knem_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address,
                                      /*is_write=*/false);
 }
 
+int mca_smsc_knem_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                              size_t local_count, const struct iovec *remote_iov,
+                              size_t remote_count, void *reg_data)
+{
+    return mca_smsc_base_copy_iov(mca_smsc_knem_copy_to, endpoint, local_iov, local_count,
+                                  remote_iov, remote_count, reg_data);
+}
+
+int mca_smsc_knem_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                size_t local_count, const struct iovec *remote_iov,
+                                size_t remote_count, void *reg_data)
+{
+    return mca_smsc_base_copy_iov(mca_smsc_knem_copy_from, endpoint, local_iov, local_count,
+                                  remote_iov, remote_count, reg_data);
+}
+
 /* unsupported interfaces (for MCA direct) */
 void *mca_smsc_knem_map_peer_region(mca_smsc_endpoint_t *endpoint, uint64_t flags,
                                     void *remote_address, size_t size, void **local_mapping)
@@ -152,6 +168,8 @@ mca_smsc_knem_module_t mca_smsc_knem_module = {
         .return_endpoint = mca_smsc_knem_return_endpoint,
         .copy_to = mca_smsc_knem_copy_to,
         .copy_from = mca_smsc_knem_copy_from,
+        .copy_to_iov = mca_smsc_knem_copy_to_iov,
+        .copy_from_iov = mca_smsc_knem_copy_from_iov,
         .register_region = mca_smsc_knem_register_region,
         .deregister_region = mca_smsc_knem_deregister_region,
     }, 
@@ -24,6 +24,8 @@
 #include "opal/class/opal_object.h"
 #include "opal/util/proc.h"
 
+#include <sys/uio.h>
+
 #define MCA_SMSC_BASE_MAJOR_VERSION 1
 #define MCA_SMSC_BASE_MINOR_VERSION 0
 #define MCA_SMSC_BASE_PATCH_VERSION 0
@@ -74,6 +76,26 @@ typedef void (*mca_smsc_module_return_endpoint_fn_t)(mca_smsc_endpoint_t *endpoi
 typedef int (*mca_smsc_module_copy_fn_t)(mca_smsc_endpoint_t *endpoint, void *local_address,
                                          void *remote_address, size_t size, void *reg_data);
 
+/**
+ * @brief Copy a list of regions to/from a peer process.
+ *
+ * @param(in) endpoint       shared-memory single-copy endpoint
+ * @param(in) local_iov      local regions
+ * @param(in) local_count    number of local regions
+ * @param(in) remote_iov     regions valid in the peer's address space
+ * @param(in) remote_count   number of remote regions
+ * @param(in) reg_data       pointer to memory containing registration data (if required)
+ *
+ * The data is copied in order. The local and remote regions may be split differently but must
+ * cover the same number of bytes. Lists generated by opal_convertor_raw() can be passed as is.
+ * A module must provide both copy_from_iov and copy_to_iov. Modules without a native vector
+ * transfer can use mca_smsc_base_copy_iov().
+ */
+typedef int (*mca_smsc_module_copy_iov_fn_t)(mca_smsc_endpoint_t *endpoint,
+                                             const struct iovec *local_iov, size_t local_count,
+                                             const struct iovec *remote_iov, size_t remote_count,
+                                             void *reg_data);
+
 /**
  * @brief Map a peer's memory onto local memory.
  *
@@ -156,6 +178,10 @@ struct mca_smsc_module_t {
     mca_smsc_module_copy_fn_t copy_to;
     /** Copy data from a peer's memory space. */
     mca_smsc_module_copy_fn_t copy_from;
+    /** Copy a list of regions into a peer's memory space. */
+    mca_smsc_module_copy_iov_fn_t copy_to_iov;
+    /** Copy a list of regions from a peer's memory space. */
+    mca_smsc_module_copy_iov_fn_t copy_from_iov;
 
     /* Defined if MCA_SMSC_FEATURE_CAN_MAP is set. */
     /** Map a peer memory region into this processes address space. The module is allowed to cache
@@ -24,6 +24,13 @@ int mca_smsc_xpmem_copy_to(mca_smsc_endpoint_t *endpoint, void *local_address, v
 int mca_smsc_xpmem_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address,
                              void *remote_address, size_t size, void *reg_handle);
 
+int mca_smsc_xpmem_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                               size_t local_count, const struct iovec *remote_iov,
+                               size_t remote_count, void *reg_data);
+int mca_smsc_xpmem_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                 size_t local_count, const struct iovec *remote_iov,
+                                 size_t remote_count, void *reg_data);
+
 /**
  * @brief Map a peer memory region into this processes address space.
  *
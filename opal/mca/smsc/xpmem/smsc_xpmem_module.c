@@ -288,6 +288,22 @@ int mca_smsc_xpmem_copy_from(mca_smsc_endpoint_t *endpoint, void *local_address,
     return OPAL_SUCCESS;
 }
 
+int mca_smsc_xpmem_copy_to_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                               size_t local_count, const struct iovec *remote_iov,
+                               size_t remote_count, void *reg_data)
+{
+    return mca_smsc_base_copy_iov(mca_smsc_xpmem_copy_to, endpoint, local_iov, local_count,
+                                  remote_iov, remote_count, reg_data);
+}
+
+int mca_smsc_xpmem_copy_from_iov(mca_smsc_endpoint_t *endpoint, const struct iovec *local_iov,
+                                 size_t local_count, const struct iovec *remote_iov,
+                                 size_t remote_count, void *reg_data)
+{
+    return mca_smsc_base_copy_iov(mca_smsc_xpmem_copy_from, endpoint, local_iov, local_count,
+                                  remote_iov, remote_count, reg_data);
+}
+
 /* unsupported interfaces defined to support MCA direct */
 void *mca_smsc_xpmem_register_region(void *local_address, size_t size)
 {
@@ -305,6 +321,8 @@ mca_smsc_xpmem_module_t mca_smsc_xpmem_module = {
         .return_endpoint = mca_smsc_xpmem_return_endpoint,
         .copy_to = mca_smsc_xpmem_copy_to,
         .copy_from = mca_smsc_xpmem_copy_from,
+        .copy_to_iov = mca_smsc_xpmem_copy_to_iov,
+        .copy_from_iov = mca_smsc_xpmem_copy_from_iov,
         .map_peer_region = mca_smsc_xpmem_map_peer_region,
         .unmap_peer_region = mca_smsc_xpmem_unmap_peer_region,
     }, 
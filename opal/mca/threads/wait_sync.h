@@ -83,6 +83,7 @@ typedef struct ompi_wait_sync_t {
         opal_thread_internal_cond_signal(&(sync)->condition); \
         opal_thread_internal_mutex_unlock(&(sync)->lock);     \
         (sync)->signaling = false;                            \
+        opal_progress_wakeup();                               \
     }
 
 #define WAIT_SYNC_SIGNALLED(sync)  \
@@ -100,8 +101,9 @@ static inline int sync_wait_st(ompi_wait_sync_t *sync)
     assert(NULL == sync->next);
     wait_sync_list = sync;
 
+    uint64_t idle_since = 0;
     while (sync->count > 0) {
-        opal_progress();
+        opal_progress_wait(&idle_since);
     }
     wait_sync_list = NULL;
 
@@ -69,7 +69,9 @@
 
 #include "opal/mca/backtrace/base/base.h"
 #include "opal/mca/threads/base/base.h"
+#include "opal/runtime/opal_init_timing.h"
 #include "opal/runtime/opal_progress.h"
+#include "opal/runtime/opal_trace.h"
 #include "opal/util/opal_environ.h"
 
 #include "opal/constants.h"
@@ -463,6 +465,7 @@ int opal_init_util(int *pargc, char ***pargv)
 {
     int ret;
     char *error = NULL;
+    double start = opal_init_timing_now();
     OPAL_TIMING_ENV_INIT(otmng);
 
     if (opal_util_initialized != 0) {
@@ -605,6 +608,8 @@ int opal_init_util(int *pargc, char ***pargv)
 
     OPAL_TIMING_ENV_NEXT(otmng, "opal_if_init");
 
+    opal_init_timing_record("opal_init_util", opal_init_timing_now() - start);
+
     ++opal_util_initialized;
 
     return OPAL_SUCCESS;
@@ -625,6 +630,7 @@ static mca_base_framework_t *opal_init_frameworks[] = {
 
 int opal_init(int *pargc, char ***pargv)
 {
+    double start = opal_init_timing_now();
     int ret;
 
     if (opal_initialized != 0) {
@@ -675,6 +681,11 @@ int opal_init(int *pargc, char ***pargv)
     /* we want to tick the event library whenever possible */
     opal_progress_event_users_increment();
 
+    /* the tracer flushes from the progress engine on signal */
+    if (OPAL_SUCCESS != (ret = opal_trace_init())) {
+        return opal_init_error("opal_trace_init", ret);
+    }
+
     /* setup the shmem framework */
     if (OPAL_SUCCESS != (ret = opal_shmem_base_select())) {
         return opal_init_error("opal_shmem_base_select", ret);
@@ -685,6 +696,9 @@ int opal_init(int *pargc, char ***pargv)
         return opal_init_error("opal_reachable_base_select", ret);
     }
 
+    /* includes opal_init_util */
+    opal_init_timing_record("opal_init", opal_init_timing_now() - start);
+
     ++opal_initialized;
 
     return OPAL_SUCCESS;
@@ -0,0 +1,74 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "opal/mca/threads/mutex.h"
+#include "opal/runtime/opal_init_timing.h"
+#include "opal/util/string_copy.h"
+
+static opal_init_timing_phase_t opal_init_timing_phases[OPAL_INIT_TIMING_MAX_PHASES];
+static int opal_init_timing_nphases = 0;
+/* frameworks may be opened lazily from any thread */
+static opal_mutex_t opal_init_timing_lock = OPAL_MUTEX_STATIC_INIT;
+
+double opal_init_timing_now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+    }
+#endif
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + 1e-6 * (double) tv.tv_usec;
+}
+
+void opal_init_timing_record(const char *name, double seconds)
+{
+    int i;
+
+    opal_mutex_lock(&opal_init_timing_lock);
+    for (i = 0; i < opal_init_timing_nphases; ++i) {
+        if (0 == strncmp(opal_init_timing_phases[i].name, name, OPAL_INIT_TIMING_NAME_LEN - 1)) {
+            break;
+        }
+    }
+    if (i == opal_init_timing_nphases) {
+        if (OPAL_INIT_TIMING_MAX_PHASES == i) {
+            opal_mutex_unlock(&opal_init_timing_lock);
+            return;
+        }
+        opal_string_copy(opal_init_timing_phases[i].name, name, OPAL_INIT_TIMING_NAME_LEN);
+        opal_init_timing_phases[i].seconds = 0.0;
+        ++opal_init_timing_nphases;
+    }
+    opal_init_timing_phases[i].seconds += seconds;
+    opal_mutex_unlock(&opal_init_timing_lock);
+}
+
+int opal_init_timing_count(void)
+{
+    return opal_init_timing_nphases;
+}
+
+const opal_init_timing_phase_t *opal_init_timing_get(int index)
+{
+    if (0 > index || index >= opal_init_timing_nphases) {
+        return NULL;
+    }
+    return opal_init_timing_phases + index;
+}
@@ -0,0 +1,67 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Wall clock time spent in the phases of the library startup.
+ *
+ * Unlike the OPAL_TIMING_ENV_* macros this is always compiled in: there
+ * are only a few dozen phases, and recording one costs a clock read and
+ * a short string compare. The phases are the major steps of opal_init()
+ * and ompi_mpi_init(), and the open of every MCA framework and the
+ * selection of the frameworks that use mca_base_select(). Recording the
+ * same phase twice accumulates the times. ompi_mpi_init() exposes the
+ * phases as MPI_T performance variables, see ompi/tools/ompi_init_timing.
+ */
+
+#ifndef OPAL_RUNTIME_OPAL_INIT_TIMING_H
+#define OPAL_RUNTIME_OPAL_INIT_TIMING_H
+
+#include "opal_config.h"
+
+BEGIN_C_DECLS
+
+#define OPAL_INIT_TIMING_MAX_PHASES 128
+#define OPAL_INIT_TIMING_NAME_LEN 64
+
+typedef struct opal_init_timing_phase_t {
+    char name[OPAL_INIT_TIMING_NAME_LEN];
+    double seconds;
+} opal_init_timing_phase_t;
+
+/** Current time in seconds, from a monotonic clock. */
+OPAL_DECLSPEC double opal_init_timing_now(void);
+
+/**
+ * Add time to a phase, creating it if needed. Phases beyond
+ * OPAL_INIT_TIMING_MAX_PHASES are dropped.
+ */
+OPAL_DECLSPEC void opal_init_timing_record(const char *name, double seconds);
+
+/** Number of phases recorded so far. */
+OPAL_DECLSPEC int opal_init_timing_count(void);
+
+/** Get a phase by index, in the order the phases were first recorded. */
+OPAL_DECLSPEC const opal_init_timing_phase_t *opal_init_timing_get(int index);
+
+/**
+ * Record the time since the clock was last set as the given phase, and
+ * restart the clock.
+ */
+#define OPAL_INIT_TIMING_LAP(clock, name)                          \
+    do {                                                           \
+        double _now = opal_init_timing_now();                      \
+        opal_init_timing_record((name), _now - (clock));           \
+        (clock) = _now;                                            \
+    } while (0)
+
+END_C_DECLS
+
+#endif /* OPAL_RUNTIME_OPAL_INIT_TIMING_H */
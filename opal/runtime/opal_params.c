@@ -44,6 +44,7 @@
 #include "opal/mca/threads/threads.h"
 #include "opal/runtime/opal.h"
 #include "opal/runtime/opal_params.h"
+#include "opal/runtime/opal_trace.h"
 #include "opal/util/opal_environ.h"
 #include "opal/util/printf.h"
 #include "opal/util/show_help.h"
@@ -75,6 +76,8 @@ int opal_abort_delay = 0;
 
 int opal_max_thread_in_progress = 1;
 
+int opal_free_list_magazine_size = 0;
+
 static bool opal_register_done = false;
 
 static void opal_deregister_params(void)
@@ -173,6 +176,54 @@ int opal_register_params(void)
                                 &opal_progress_yield_when_idle);
 #endif
 
+    opal_progress_adaptive = false;
+    ret = mca_base_var_register("opal", "opal", "progress", "adaptive",
+                                "Poll progress callbacks that keep reporting no events less "
+                                "often (exponential backoff). When false (the default) every "
+                                "callback is called on each pass of opal_progress",
+                                MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL, &opal_progress_adaptive);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_progress_max_backoff = 16;
+    ret = mca_base_var_register("opal", "opal", "progress", "max_backoff",
+                                "Maximum number of opal_progress passes an idle progress "
+                                "callback is skipped when adaptive progress is enabled",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                &opal_progress_max_backoff);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_progress_spin_usec = -1;
+    ret = mca_base_var_register("opal", "opal", "progress", "spin_usec",
+                                "Time in microseconds a thread blocked in a wait keeps polling "
+                                "without progressing any event before it goes to sleep. Sleeping "
+                                "threads are woken up by the shared memory and TCP transports or "
+                                "after opal_progress_sleep_usec. A negative value disables "
+                                "sleeping (default: -1)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL, &opal_progress_spin_usec);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_progress_sleep_usec = 1000;
+    ret = mca_base_var_register("opal", "opal", "progress", "sleep_usec",
+                                "Maximum time in microseconds a blocked thread sleeps before "
+                                "polling again (see opal_progress_spin_usec). This bounds the "
+                                "wakeup latency of transports that can not wake a sleeping "
+                                "process (default: 1000)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                &opal_progress_sleep_usec);
+    if (0 > ret) {
+        return ret;
+    }
+
 #if OPAL_ENABLE_DEBUG
     opal_progress_debug = false;
     ret = mca_base_var_register("opal", "opal", "progress", "debug",
@@ -359,6 +410,15 @@ int opal_register_params(void)
                                  MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_max_thread_in_progress);
 
+    /* Per-thread caches in front of the free lists. Only used with MPI_THREAD_MULTIPLE. */
+    (void) mca_base_var_register("opal", "opal", NULL, "free_list_magazine_size",
+                                 "Number of items held by each magazine of the per-thread free "
+                                 "list caches. The caches reduce contention on the free lists "
+                                 "when multiple threads allocate and release requests and "
+                                 "fragments concurrently. 0 disables the caches. Default: 0",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_free_list_magazine_size);
+
     /* The ddt engine has a few parameters */
     ret = opal_datatype_register_params();
     if (OPAL_SUCCESS != ret) {
@@ -370,6 +430,11 @@ int opal_register_params(void)
         return ret;
     }
 
+    ret = opal_trace_register_params();
+    if (OPAL_SUCCESS != ret) {
+        return ret;
+    }
+
     opal_finalize_register_cleanup(opal_deregister_params);
 
     return OPAL_SUCCESS;
@@ -85,6 +85,12 @@ OPAL_DECLSPEC extern bool opal_abort_print_stack;
  */
 OPAL_DECLSPEC extern int opal_abort_delay;
 
+/**
+ * Number of items in the per-thread magazines of the free lists (0
+ * disables the per-thread caches).
+ */
+OPAL_DECLSPEC extern int opal_free_list_magazine_size;
+
 #    if OPAL_ENABLE_DEBUG
 extern bool opal_progress_debug;
 #    endif
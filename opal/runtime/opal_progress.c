@@ -27,7 +27,21 @@
 
 #include "opal_config.h"
 
+#include <errno.h>
+#include <stddef.h>
+#include <sys/time.h>
+#ifdef HAVE_UNISTD_H
+#    include <unistd.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#    include <fcntl.h>
+#endif
+#ifdef HAVE_SYS_EVENTFD_H
+#    include <sys/eventfd.h>
+#endif
+
 #include "opal/constants.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/mca/threads/threads.h"
 #include "opal/mca/timer/base/base.h"
@@ -35,11 +49,41 @@
 #include "opal/runtime/opal_params.h"
 #include "opal/runtime/opal_progress.h"
 #include "opal/util/event.h"
+#include "opal/util/fd.h"
 #include "opal/util/output.h"
 
 #define OPAL_PROGRESS_USE_TIMERS       (OPAL_TIMER_CYCLE_SUPPORTED || OPAL_TIMER_USEC_SUPPORTED)
 #define OPAL_PROGRESS_ONLY_USEC_NATIVE (OPAL_TIMER_USEC_NATIVE && !OPAL_TIMER_CYCLE_NATIVE)
 
+/* the cost of a callback is measured on one call out of OPAL_PROGRESS_SAMPLE_MASK + 1 */
+#define OPAL_PROGRESS_SAMPLE_MASK 0x3f
+
+/* number of entries in the per-callback performance variables */
+#define OPAL_PROGRESS_PVAR_COUNT 32
+
+/**
+ * Statistics kept for each registered callback. They are updated without
+ * atomics so they may be slightly off when multiple threads are in
+ * opal_progress() at the same time.
+ */
+typedef struct opal_progress_cb_stats_t {
+    /** number of times the callback was called */
+    uint64_t calls;
+    /** number of events reported by the callback */
+    uint64_t events;
+    /** number of passes in which the callback was skipped */
+    uint64_t skipped;
+    /** time spent in the sampled calls (timer ticks) */
+    uint64_t sampled_time;
+    /** number of sampled calls */
+    uint64_t samples;
+    /** number of passes to skip after the next empty call */
+    uint32_t backoff;
+    /** number of passes left to skip (decremented concurrently by all the
+     * threads in opal_progress) */
+    opal_atomic_int32_t skip;
+} opal_progress_cb_stats_t;
+
 #if OPAL_ENABLE_DEBUG
 bool opal_progress_debug = false;
 #endif
@@ -49,6 +93,11 @@ bool opal_progress_debug = false;
  */
 static int opal_progress_event_flag = OPAL_EVLOOP_ONCE | OPAL_EVLOOP_NONBLOCK;
 int opal_progress_spin_count = 10000;
+bool opal_progress_adaptive = false;
+int opal_progress_max_backoff = 16;
+int opal_progress_spin_usec = -1;
+int opal_progress_sleep_usec = 1000;
+opal_atomic_int32_t opal_progress_num_sleepers = 0;
 
 /*
  * Local variables
@@ -57,16 +106,36 @@ static opal_atomic_lock_t progress_lock;
 
 /* callbacks to progress */
 static volatile opal_progress_callback_t *callbacks = NULL;
+static opal_progress_cb_stats_t *volatile callbacks_stats = NULL;
 static size_t callbacks_len = 0;
 static size_t callbacks_size = 0;
 
 static volatile opal_progress_callback_t *callbacks_lp = NULL;
+static opal_progress_cb_stats_t *volatile callbacks_lp_stats = NULL;
 static size_t callbacks_lp_len = 0;
 static size_t callbacks_lp_size = 0;
 
+/* arrays replaced by a registration while other threads may still be
+ * reading them in opal_progress(). they are released at finalize */
+static void **retired_arrays = NULL;
+static size_t retired_arrays_len = 0;
+
 /* do we want to yield() if nothing happened */
 bool opal_progress_yield_when_idle = false;
 
+/* only one thread at a time runs the event library */
+static opal_atomic_int32_t event_loop_lock = 0;
+
+/* hybrid wait support */
+#define OPAL_PROGRESS_MAX_SLEEP_CALLBACKS 8
+static opal_progress_sleep_callback_t sleep_callbacks[OPAL_PROGRESS_MAX_SLEEP_CALLBACKS];
+static int sleep_callbacks_len = 0;
+static bool sleep_initialized = false;
+/* eventfd (both entries) or pipe used by opal_progress_wakeup() */
+static int wakeup_fds[2] = {-1, -1};
+static opal_event_t wakeup_event;
+static opal_event_t sleep_timer_event;
+
 #if OPAL_PROGRESS_USE_TIMERS
 static opal_timer_t event_progress_last_time = 0;
 static opal_timer_t event_progress_delta = 0;
@@ -99,7 +168,7 @@ static int fake_cb(void)
 
 static int _opal_progress_unregister(opal_progress_callback_t cb,
                                      volatile opal_progress_callback_t *callback_array,
-                                     size_t *callback_array_len);
+                                     opal_progress_cb_stats_t *stats, size_t *callback_array_len);
 
 static void opal_progress_finalize(void)
 {
@@ -110,15 +179,111 @@ static void opal_progress_finalize(void)
     callbacks_size = 0;
     free((void *) callbacks);
     callbacks = NULL;
+    free(callbacks_stats);
+    callbacks_stats = NULL;
 
     callbacks_lp_len = 0;
     callbacks_lp_size = 0;
     free((void *) callbacks_lp);
     callbacks_lp = NULL;
+    free(callbacks_lp_stats);
+    callbacks_lp_stats = NULL;
+
+    for (size_t i = 0; i < retired_arrays_len; ++i) {
+        free(retired_arrays[i]);
+    }
+    free(retired_arrays);
+    retired_arrays = NULL;
+    retired_arrays_len = 0;
+
+    sleep_callbacks_len = 0;
+    if (sleep_initialized) {
+        opal_event_del(&wakeup_event);
+        close(wakeup_fds[0]);
+        if (wakeup_fds[1] != wakeup_fds[0]) {
+            close(wakeup_fds[1]);
+        }
+        wakeup_fds[0] = wakeup_fds[1] = -1;
+        sleep_initialized = false;
+    }
 
     opal_atomic_unlock(&progress_lock);
 }
 
+static int opal_progress_pvar_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                                     void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = OPAL_PROGRESS_PVAR_COUNT;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+/*
+ * Read one of the per-callback statistics. Entries are the high priority
+ * callbacks in registration order followed by the low priority ones. Unused
+ * entries are 0.
+ */
+static int opal_progress_pvar_read(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    size_t offset = (size_t) pvar->ctx;
+    unsigned long long *array = (unsigned long long *) value;
+    int n = 0;
+
+    for (size_t i = 0; i < callbacks_len && n < OPAL_PROGRESS_PVAR_COUNT; ++i) {
+        array[n++] = *((uint64_t *) ((char *) (callbacks_stats + i) + offset));
+    }
+
+    for (size_t i = 0; i < callbacks_lp_len && n < OPAL_PROGRESS_PVAR_COUNT; ++i) {
+        array[n++] = *((uint64_t *) ((char *) (callbacks_lp_stats + i) + offset));
+    }
+
+    while (n < OPAL_PROGRESS_PVAR_COUNT) {
+        array[n++] = 0;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static void opal_progress_register_pvar(const char *name, const char *desc, int var_class,
+                                        size_t offset)
+{
+    (void) mca_base_pvar_register("opal", "opal", "progress", name, desc, OPAL_INFO_LVL_8,
+                                  var_class, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                  MCA_BASE_VAR_BIND_NO_OBJECT,
+                                  MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                  opal_progress_pvar_read, NULL, opal_progress_pvar_notify,
+                                  (void *) offset);
+}
+
+static void opal_progress_register_pvars(void)
+{
+    opal_progress_register_pvar("callback_calls",
+                                "Number of times each progress callback was called",
+                                MCA_BASE_PVAR_CLASS_COUNTER,
+                                offsetof(opal_progress_cb_stats_t, calls));
+    opal_progress_register_pvar("callback_events",
+                                "Number of events reported by each progress callback",
+                                MCA_BASE_PVAR_CLASS_COUNTER,
+                                offsetof(opal_progress_cb_stats_t, events));
+    opal_progress_register_pvar("callback_skipped",
+                                "Number of opal_progress passes in which each progress callback "
+                                "was skipped by the adaptive scheduler",
+                                MCA_BASE_PVAR_CLASS_COUNTER,
+                                offsetof(opal_progress_cb_stats_t, skipped));
+    opal_progress_register_pvar("callback_sampled_time",
+                                "Time (timer ticks) spent in the sampled calls of each progress "
+                                "callback",
+                                MCA_BASE_PVAR_CLASS_AGGREGATE,
+                                offsetof(opal_progress_cb_stats_t, sampled_time));
+    opal_progress_register_pvar("callback_samples",
+                                "Number of calls of each progress callback included in "
+                                "callback_sampled_time",
+                                MCA_BASE_PVAR_CLASS_COUNTER,
+                                offsetof(opal_progress_cb_stats_t, samples));
+}
+
 /* init the progress engine - called from orte_init */
 int opal_progress_init(void)
 {
@@ -138,12 +303,18 @@ int opal_progress_init(void)
 
     callbacks = malloc(callbacks_size * sizeof(callbacks[0]));
     callbacks_lp = malloc(callbacks_lp_size * sizeof(callbacks_lp[0]));
+    callbacks_stats = calloc(callbacks_size, sizeof(callbacks_stats[0]));
+    callbacks_lp_stats = calloc(callbacks_lp_size, sizeof(callbacks_lp_stats[0]));
 
-    if (NULL == callbacks || NULL == callbacks_lp) {
+    if (NULL == callbacks || NULL == callbacks_lp || NULL == callbacks_stats
+        || NULL == callbacks_lp_stats) {
         free((void *) callbacks);
         free((void *) callbacks_lp);
+        free(callbacks_stats);
+        free(callbacks_lp_stats);
         callbacks_size = callbacks_lp_size = 0;
         callbacks = callbacks_lp = NULL;
+        callbacks_stats = callbacks_lp_stats = NULL;
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
@@ -162,6 +333,10 @@ int opal_progress_init(void)
     OPAL_OUTPUT((debug_output, "progress: initialized num users to: %d", num_event_users));
     OPAL_OUTPUT(
         (debug_output, "progress: initialized poll rate to: %ld", (long) event_progress_delta));
+    OPAL_OUTPUT((debug_output, "progress: initialized adaptive to: %s (max backoff %d)",
+                 opal_progress_adaptive ? "true" : "false", opal_progress_max_backoff));
+
+    opal_progress_register_pvars();
 
     opal_finalize_register_cleanup(opal_progress_finalize);
 
@@ -170,10 +345,9 @@ int opal_progress_init(void)
 
 static int opal_progress_events(void)
 {
-    static opal_atomic_int32_t lock = 0;
     int events = 0;
 
-    if (opal_progress_event_flag != 0 && !OPAL_THREAD_SWAP_32(&lock, 1)) {
+    if (opal_progress_event_flag != 0 && !OPAL_THREAD_SWAP_32(&event_loop_lock, 1)) {
 #if OPAL_PROGRESS_USE_TIMERS
 #    if OPAL_PROGRESS_ONLY_USEC_NATIVE
         opal_timer_t now = opal_timer_base_get_usec();
@@ -196,12 +370,70 @@ static int opal_progress_events(void)
             events += opal_event_loop(opal_sync_event_base, opal_progress_event_flag);
         }
 #endif /* OPAL_PROGRESS_USE_TIMERS */
-        lock = 0;
+        event_loop_lock = 0;
     }
 
     return events;
 }
 
+static inline opal_timer_t opal_progress_now(void)
+{
+#if OPAL_PROGRESS_USE_TIMERS
+#    if OPAL_PROGRESS_ONLY_USEC_NATIVE
+    return opal_timer_base_get_usec();
+#    else
+    return opal_timer_base_get_cycles();
+#    endif
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Call a progress callback unless it is backing off. A callback that reports
+ * no events doubles the number of passes it is skipped (up to
+ * opal_progress_max_backoff). Any event resets the backoff.
+ */
+static inline int opal_progress_call(opal_progress_callback_t cb, opal_progress_cb_stats_t *stats)
+{
+    int events;
+
+    int32_t skip = stats->skip;
+
+    if (skip > 0) {
+        /* several threads may be here at once. only decrement if nobody else
+         * did, so the counter never wraps below zero */
+        if (opal_atomic_compare_exchange_strong_32(&stats->skip, &skip, skip - 1)) {
+            ++stats->skipped;
+        }
+        return 0;
+    }
+
+    if (OPAL_UNLIKELY(0 == (stats->calls & OPAL_PROGRESS_SAMPLE_MASK))) {
+        opal_timer_t start = opal_progress_now();
+        events = cb();
+        stats->sampled_time += opal_progress_now() - start;
+        ++stats->samples;
+    } else {
+        events = cb();
+    }
+    ++stats->calls;
+
+    if (events > 0) {
+        stats->events += events;
+        stats->backoff = 0;
+    } else if (0 < opal_progress_max_backoff
+               && stats->backoff < (uint32_t) opal_progress_max_backoff) {
+        stats->backoff = stats->backoff ? 2 * stats->backoff : 1;
+        if (stats->backoff > (uint32_t) opal_progress_max_backoff) {
+            stats->backoff = opal_progress_max_backoff;
+        }
+    }
+    stats->skip = (int32_t) stats->backoff;
+
+    return events;
+}
+
 /*
  * Progress the event library and any functions that have registered to
  * be called.  We don't propogate errors from the progress functions,
@@ -220,8 +452,21 @@ int opal_progress(void)
     int events = 0;
 
     /* progress all registered callbacks */
-    for (i = 0; i < callbacks_len; ++i) {
-        events += (callbacks[i])();
+    if (opal_progress_adaptive) {
+        /* the stats array is published before the length grows, so it
+         * covers every entry below the length read first */
+        size_t len = callbacks_len;
+        opal_progress_cb_stats_t *stats;
+
+        opal_atomic_rmb();
+        stats = callbacks_stats;
+        for (i = 0; i < len; ++i) {
+            events += opal_progress_call(callbacks[i], stats + i);
+        }
+    } else {
+        for (i = 0; i < callbacks_len; ++i) {
+            events += (callbacks[i])();
+        }
     }
 
     /* Run low priority callbacks and events once every 8 calls to opal_progress().
@@ -231,8 +476,19 @@ int opal_progress(void)
      * it's not a problem.
      */
     if (((num_calls++) & 0x7) == 0) {
-        for (i = 0; i < callbacks_lp_len; ++i) {
-            events += (callbacks_lp[i])();
+        if (opal_progress_adaptive) {
+            size_t len = callbacks_lp_len;
+            opal_progress_cb_stats_t *stats;
+
+            opal_atomic_rmb();
+            stats = callbacks_lp_stats;
+            for (i = 0; i < len; ++i) {
+                events += opal_progress_call(callbacks_lp[i], stats + i);
+            }
+        } else {
+            for (i = 0; i < callbacks_lp_len; ++i) {
+                events += (callbacks_lp[i])();
+            }
         }
 
         opal_progress_events();
@@ -365,8 +621,27 @@ static int opal_progress_find_cb(opal_progress_callback_t cb,
     return OPAL_ERR_NOT_FOUND;
 }
 
+/* keep an array until finalize. called with progress_lock held */
+static void opal_progress_retire(void *array)
+{
+    void **tmp;
+
+    if (NULL == array) {
+        return;
+    }
+
+    tmp = (void **) realloc(retired_arrays, (retired_arrays_len + 1) * sizeof(tmp[0]));
+    if (NULL == tmp) {
+        /* leak the array rather than free it under a running thread */
+        return;
+    }
+    retired_arrays = tmp;
+    retired_arrays[retired_arrays_len++] = array;
+}
+
 static int _opal_progress_register(opal_progress_callback_t cb,
-                                   volatile opal_progress_callback_t **cbs, size_t *cbs_size,
+                                   volatile opal_progress_callback_t **cbs,
+                                   opal_progress_cb_stats_t *volatile *stats, size_t *cbs_size,
                                    size_t *cbs_len)
 {
     int ret = OPAL_SUCCESS;
@@ -378,12 +653,20 @@ static int _opal_progress_register(opal_progress_callback_t cb,
     /* see if we need to allocate more space */
     if (*cbs_len + 1 > *cbs_size) {
         opal_progress_callback_t *tmp, *old;
+        opal_progress_cb_stats_t *tmp_stats, *old_stats;
 
         tmp = (opal_progress_callback_t *) malloc(sizeof(tmp[0]) * 2 * *cbs_size);
-        if (tmp == NULL) {
+        tmp_stats = (opal_progress_cb_stats_t *) calloc(2 * *cbs_size, sizeof(tmp_stats[0]));
+        if (tmp == NULL || tmp_stats == NULL) {
+            free(tmp);
+            free(tmp_stats);
             return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
         }
 
+        if (*stats) {
+            memcpy(tmp_stats, *stats, sizeof(tmp_stats[0]) * *cbs_size);
+        }
+
         if (*cbs) {
             /* copy old callbacks */
             memcpy(tmp, (void *) *cbs, sizeof(tmp[0]) * *cbs_size);
@@ -393,6 +676,11 @@ static int _opal_progress_register(opal_progress_callback_t cb,
             tmp[i] = fake_cb;
         }
 
+        /* the stats array has to be in place before a reader can see a
+         * length larger than the old array */
+        old_stats = *stats;
+        *stats = tmp_stats;
+
         opal_atomic_wmb();
 
         /* swap out callback array */
@@ -401,11 +689,15 @@ static int _opal_progress_register(opal_progress_callback_t cb,
 
         opal_atomic_wmb();
 
-        free(old);
+        /* other threads may still be calling through the old arrays */
+        opal_progress_retire(old);
+        opal_progress_retire(old_stats);
         *cbs_size *= 2;
     }
 
+    memset(*stats + *cbs_len, 0, sizeof((*stats)[0]));
     cbs[0][*cbs_len] = cb;
+    opal_atomic_wmb();
     ++*cbs_len;
 
     opal_atomic_wmb();
@@ -419,9 +711,10 @@ int opal_progress_register(opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    (void) _opal_progress_unregister(cb, callbacks_lp, &callbacks_lp_len);
+    (void) _opal_progress_unregister(cb, callbacks_lp, callbacks_lp_stats, &callbacks_lp_len);
 
-    ret = _opal_progress_register(cb, &callbacks, &callbacks_size, &callbacks_len);
+    ret = _opal_progress_register(cb, &callbacks, &callbacks_stats, &callbacks_size,
+                                  &callbacks_len);
 
     opal_atomic_unlock(&progress_lock);
 
@@ -434,9 +727,10 @@ int opal_progress_register_lp(opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    (void) _opal_progress_unregister(cb, callbacks, &callbacks_len);
+    (void) _opal_progress_unregister(cb, callbacks, callbacks_stats, &callbacks_len);
 
-    ret = _opal_progress_register(cb, &callbacks_lp, &callbacks_lp_size, &callbacks_lp_len);
+    ret = _opal_progress_register(cb, &callbacks_lp, &callbacks_lp_stats, &callbacks_lp_size,
+                                  &callbacks_lp_len);
 
     opal_atomic_unlock(&progress_lock);
 
@@ -445,7 +739,7 @@ int opal_progress_register_lp(opal_progress_callback_t cb)
 
 static int _opal_progress_unregister(opal_progress_callback_t cb,
                                      volatile opal_progress_callback_t *callback_array,
-                                     size_t *callback_array_len)
+                                     opal_progress_cb_stats_t *stats, size_t *callback_array_len)
 {
     int ret = opal_progress_find_cb(cb, callback_array, *callback_array_len);
     if (OPAL_ERR_NOT_FOUND == ret) {
@@ -461,10 +755,12 @@ static int _opal_progress_unregister(opal_progress_callback_t cb,
          * opal_progress(). */
         (void) opal_atomic_swap_ptr((opal_atomic_intptr_t *) (callback_array + i),
                                     (intptr_t) callback_array[i + 1]);
+        stats[i] = stats[i + 1];
     }
 
     --*callback_array_len;
     callback_array[*callback_array_len] = fake_cb;
+    memset(stats + *callback_array_len, 0, sizeof(stats[0]));
 
     return OPAL_SUCCESS;
 }
@@ -475,15 +771,185 @@ int opal_progress_unregister(opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    ret = _opal_progress_unregister(cb, callbacks, &callbacks_len);
+    ret = _opal_progress_unregister(cb, callbacks, callbacks_stats, &callbacks_len);
 
     if (OPAL_SUCCESS != ret) {
         /* if not in the high-priority array try to remove from the lp array.
          * a callback will never be in both. */
-        ret = _opal_progress_unregister(cb, callbacks_lp, &callbacks_lp_len);
+        ret = _opal_progress_unregister(cb, callbacks_lp, callbacks_lp_stats, &callbacks_lp_len);
     }
 
     opal_atomic_unlock(&progress_lock);
 
     return ret;
 }
+
+int opal_progress_register_sleep(opal_progress_sleep_callback_t cb)
+{
+    int ret = OPAL_SUCCESS;
+
+    opal_atomic_lock(&progress_lock);
+    if (sleep_callbacks_len == OPAL_PROGRESS_MAX_SLEEP_CALLBACKS) {
+        ret = OPAL_ERR_OUT_OF_RESOURCE;
+    } else {
+        sleep_callbacks[sleep_callbacks_len++] = cb;
+    }
+    opal_atomic_unlock(&progress_lock);
+
+    return ret;
+}
+
+int opal_progress_unregister_sleep(opal_progress_sleep_callback_t cb)
+{
+    int ret = OPAL_ERR_NOT_FOUND;
+
+    opal_atomic_lock(&progress_lock);
+    for (int i = 0; i < sleep_callbacks_len; ++i) {
+        if (sleep_callbacks[i] == cb) {
+            sleep_callbacks[i] = sleep_callbacks[--sleep_callbacks_len];
+            ret = OPAL_SUCCESS;
+            break;
+        }
+    }
+    opal_atomic_unlock(&progress_lock);
+
+    return ret;
+}
+
+static uint64_t opal_progress_usec(void)
+{
+#if OPAL_TIMER_USEC_SUPPORTED
+    return (uint64_t) opal_timer_base_get_usec();
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (uint64_t) tv.tv_sec * 1000000 + (uint64_t) tv.tv_usec;
+#endif
+}
+
+static void opal_progress_wakeup_cb(int fd, short flags, void *arg)
+{
+    uint64_t buffer[8];
+
+    /* drain the wakeup descriptor. the event itself is what ends the sleep */
+    while (0 < read(fd, buffer, sizeof(buffer))) {
+        if (wakeup_fds[0] == wakeup_fds[1]) {
+            /* an eventfd is drained by a single read */
+            break;
+        }
+    }
+}
+
+static void opal_progress_sleep_timeout_cb(int fd, short flags, void *arg)
+{
+    /* nothing to do. firing ends the sleep */
+}
+
+/* called with event_loop_lock held */
+static int opal_progress_sleep_init(void)
+{
+#ifdef HAVE_SYS_EVENTFD_H
+    wakeup_fds[0] = wakeup_fds[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (0 > wakeup_fds[0]) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+#else
+    if (0 != pipe(wakeup_fds)) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        (void) opal_fd_set_cloexec(wakeup_fds[i]);
+        (void) fcntl(wakeup_fds[i], F_SETFL, fcntl(wakeup_fds[i], F_GETFL) | O_NONBLOCK);
+    }
+#endif
+
+    opal_event_set(opal_sync_event_base, &wakeup_event, wakeup_fds[0],
+                   OPAL_EV_READ | OPAL_EV_PERSIST, opal_progress_wakeup_cb, NULL);
+    opal_event_add(&wakeup_event, NULL);
+    opal_event_evtimer_set(opal_sync_event_base, &sleep_timer_event,
+                           opal_progress_sleep_timeout_cb, NULL);
+
+    sleep_initialized = true;
+
+    return OPAL_SUCCESS;
+}
+
+void opal_progress_wakeup_sleepers(void)
+{
+    uint64_t value = 1;
+
+    if (OPAL_LIKELY(sleep_initialized)) {
+        /* a full pipe or an eventfd at its maximum value already guarantee a wakeup */
+        (void) write(wakeup_fds[1], &value, sizeof(value));
+    }
+}
+
+/*
+ * Block in the event library until one of its descriptors becomes ready or
+ * opal_progress_sleep_usec expires. The timeout bounds the wakeup latency for
+ * transports that have no way to wake a sleeping process.
+ */
+static void opal_progress_sleep(void)
+{
+    struct timeval tv;
+    int events = 0;
+
+    if (OPAL_THREAD_SWAP_32(&event_loop_lock, 1)) {
+        /* another thread owns (and may be sleeping in) the event library */
+        opal_thread_yield();
+        return;
+    }
+
+    if (OPAL_UNLIKELY(!sleep_initialized) && OPAL_SUCCESS != opal_progress_sleep_init()) {
+        event_loop_lock = 0;
+        opal_thread_yield();
+        return;
+    }
+
+    (void) OPAL_THREAD_ADD_FETCH32(&opal_progress_num_sleepers, 1);
+    opal_atomic_mb();
+
+    /* arm the wakeup mechanisms and catch anything that arrived in the meantime */
+    for (int i = 0; i < sleep_callbacks_len; ++i) {
+        events += sleep_callbacks[i](true);
+    }
+
+    if (0 == events) {
+        tv.tv_sec = opal_progress_sleep_usec / 1000000;
+        tv.tv_usec = opal_progress_sleep_usec % 1000000;
+        opal_event_evtimer_add(&sleep_timer_event, &tv);
+        (void) opal_event_loop(opal_sync_event_base, OPAL_EVLOOP_ONCE);
+        opal_event_evtimer_del(&sleep_timer_event);
+    }
+
+    for (int i = 0; i < sleep_callbacks_len; ++i) {
+        (void) sleep_callbacks[i](false);
+    }
+
+    (void) OPAL_THREAD_ADD_FETCH32(&opal_progress_num_sleepers, -1);
+    event_loop_lock = 0;
+}
+
+int opal_progress_wait_slow(uint64_t *idle_since)
+{
+    int events = opal_progress();
+    uint64_t now;
+
+    if (events > 0) {
+        *idle_since = 0;
+        return events;
+    }
+
+    now = opal_progress_usec();
+    if (0 == *idle_since) {
+        *idle_since = now;
+    } else if (now - *idle_since >= (uint64_t) opal_progress_spin_usec) {
+        opal_progress_sleep();
+        /* spin again before the next sleep. messages tend to come in bursts */
+        *idle_since = opal_progress_usec();
+    }
+
+    return events;
+}
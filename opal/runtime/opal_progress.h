@@ -174,6 +174,91 @@ OPAL_DECLSPEC extern int opal_progress_spin_count;
 /* do we want to call sched_yield() if nothing happened */
 OPAL_DECLSPEC extern bool opal_progress_yield_when_idle;
 
+/* do we want to back off progress callbacks that report no events */
+OPAL_DECLSPEC extern bool opal_progress_adaptive;
+
+/* maximum number of passes an idle callback is skipped */
+OPAL_DECLSPEC extern int opal_progress_max_backoff;
+
+/* hybrid wait: microseconds without events before a waiting thread sleeps
+ * (negative: never sleep) */
+OPAL_DECLSPEC extern int opal_progress_spin_usec;
+
+/* hybrid wait: maximum time (in microseconds) a thread sleeps at once */
+OPAL_DECLSPEC extern int opal_progress_sleep_usec;
+
+/* number of threads currently sleeping in opal_progress_wait() */
+OPAL_DECLSPEC extern opal_atomic_int32_t opal_progress_num_sleepers;
+
+/**
+ * Sleep callback function typedef
+ *
+ * Sleep callbacks are called with sleeping set to true right before a
+ * thread goes to sleep in opal_progress_wait() and with sleeping set to
+ * false when it wakes up. A component uses them to arm (and disarm) a
+ * mechanism that wakes the sleeper by making a file descriptor registered
+ * with opal_sync_event_base readable. When called with sleeping set to
+ * true the callback must return the number of events that arrived before
+ * the mechanism was armed. The thread will not sleep if any callback
+ * returns a non-zero value.
+ */
+typedef int (*opal_progress_sleep_callback_t)(bool sleeping);
+
+/**
+ * Register a sleep callback
+ */
+OPAL_DECLSPEC int opal_progress_register_sleep(opal_progress_sleep_callback_t cb);
+
+/**
+ * Deregister a previously registered sleep callback
+ */
+OPAL_DECLSPEC int opal_progress_unregister_sleep(opal_progress_sleep_callback_t cb);
+
+/**
+ * Internal function used by opal_progress_wait()
+ */
+OPAL_DECLSPEC int opal_progress_wait_slow(uint64_t *idle_since);
+
+/**
+ * Internal function used by opal_progress_wakeup()
+ */
+OPAL_DECLSPEC void opal_progress_wakeup_sleepers(void);
+
+/**
+ * Progress on behalf of a blocked thread
+ *
+ * @param[inout] idle_since  Wait state. Must be set to 0 before the first call
+ *
+ * Calls opal_progress(). If opal_progress_spin_usec is non-negative and no
+ * event has been progressed for that long the calling thread sleeps (for at
+ * most opal_progress_sleep_usec) until an event arrives on
+ * opal_sync_event_base, a sleep callback mechanism fires, or
+ * opal_progress_wakeup() is called.
+ *
+ * @return Number of events progressed
+ */
+static inline int opal_progress_wait(uint64_t *idle_since)
+{
+    if (OPAL_LIKELY(opal_progress_spin_usec < 0)) {
+        return opal_progress();
+    }
+
+    return opal_progress_wait_slow(idle_since);
+}
+
+/**
+ * Wake up threads sleeping in opal_progress_wait()
+ *
+ * Must be called after completing an operation another thread may be
+ * waiting on from outside of the progress engine.
+ */
+static inline void opal_progress_wakeup(void)
+{
+    if (OPAL_UNLIKELY(0 < opal_progress_num_sleepers)) {
+        opal_progress_wakeup_sleepers();
+    }
+}
+
 /**
  * Progress until flag is true or poll iterations completed
  */
@@ -0,0 +1,276 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "opal/constants.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/runtime/opal.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/runtime/opal_trace.h"
+#include "opal/util/bit_ops.h"
+#include "opal/util/output.h"
+#include "opal/util/printf.h"
+#include "opal/util/proc.h"
+
+int opal_trace_sample_rate = 0;
+static int opal_trace_buffer_records = 65536;
+static int opal_trace_signal = 0;
+static char *opal_trace_file = NULL;
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local opal_trace_buffer_t *opal_trace_buffer = NULL;
+#endif
+
+/* The buffers of all threads. Buffers are only added to the list and are
+ * kept until the process exits, as the threads own a pointer to them. */
+static opal_trace_buffer_t *opal_trace_buffers = NULL;
+static uint32_t opal_trace_nbuffers = 0;
+static opal_mutex_t opal_trace_lock = OPAL_MUTEX_STATIC_INIT;
+
+static volatile sig_atomic_t opal_trace_flush_requested = 0;
+static bool opal_trace_progress_registered = false;
+
+int opal_trace_register_params(void)
+{
+    (void) mca_base_var_register("opal", "opal", "trace", "sample_rate",
+                                 "Record one out of this many communication events of each "
+                                 "thread in the event tracer. 0 disables the tracer. Default: 0",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_sample_rate);
+
+    (void) mca_base_var_register("opal", "opal", "trace", "buffer_records",
+                                 "Number of records in the trace ring buffer of each thread, "
+                                 "rounded up to a power of two. Only the most recent records "
+                                 "are written out. Default: 65536",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_buffer_records);
+
+    opal_trace_file = "opal_trace";
+    (void) mca_base_var_register("opal", "opal", "trace", "file",
+                                 "Prefix of the trace files. Each process writes "
+                                 "<prefix>.<vpid>.<pid>.trc. Default: opal_trace",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_file);
+
+    (void) mca_base_var_register("opal", "opal", "trace", "signal",
+                                 "Signal number that makes the processes write their trace "
+                                 "files without stopping, e.g. 12 for SIGUSR2. 0 means the "
+                                 "files are only written at finalize. Default: 0",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_8,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_trace_signal);
+
+    return OPAL_SUCCESS;
+}
+
+opal_trace_buffer_t *opal_trace_buffer_create(void)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    opal_trace_buffer_t *buffer;
+
+    buffer = calloc(1, sizeof(*buffer)
+                           + (size_t) opal_trace_buffer_records * sizeof(opal_trace_record_t));
+    if (NULL == buffer) {
+        return NULL;
+    }
+    buffer->mask = opal_trace_buffer_records - 1;
+    /* sample the first event */
+    buffer->countdown = 1;
+
+    opal_mutex_lock(&opal_trace_lock);
+    buffer->thread = opal_trace_nbuffers++;
+    buffer->next = opal_trace_buffers;
+    opal_trace_buffers = buffer;
+    opal_mutex_unlock(&opal_trace_lock);
+
+    opal_trace_buffer = buffer;
+    return buffer;
+#else
+    return NULL;
+#endif
+}
+
+static void opal_trace_signal_handler(int sig)
+{
+    (void) sig;
+    opal_trace_flush_requested = 1;
+}
+
+/* The file is not written from the signal handler, which may run in the
+ * middle of a record or of a malloc. */
+static int opal_trace_progress(void)
+{
+    if (OPAL_LIKELY(0 == opal_trace_flush_requested)) {
+        return 0;
+    }
+    opal_trace_flush_requested = 0;
+    (void) opal_trace_flush();
+    return 0;
+}
+
+void opal_trace_finalize(void)
+{
+    if (0 == opal_trace_sample_rate) {
+        return;
+    }
+
+    if (opal_trace_progress_registered) {
+        opal_progress_unregister(opal_trace_progress);
+        signal(opal_trace_signal, SIG_DFL);
+        opal_trace_progress_registered = false;
+    }
+
+    (void) opal_trace_flush();
+    opal_trace_sample_rate = 0;
+}
+
+int opal_trace_init(void)
+{
+    if (0 >= opal_trace_sample_rate) {
+        opal_trace_sample_rate = 0;
+        return OPAL_SUCCESS;
+    }
+
+#if !OPAL_HAVE_THREAD_LOCAL
+    opal_output(0, "opal_trace: thread local storage is not available, tracing disabled");
+    opal_trace_sample_rate = 0;
+    return OPAL_SUCCESS;
+#endif
+
+    if (opal_trace_buffer_records < 2) {
+        opal_trace_buffer_records = 2;
+    }
+    opal_trace_buffer_records = opal_next_poweroftwo_inclusive(opal_trace_buffer_records);
+
+    if (0 < opal_trace_signal) {
+        struct sigaction act;
+
+        memset(&act, 0, sizeof(act));
+        act.sa_handler = opal_trace_signal_handler;
+        act.sa_flags = SA_RESTART;
+        sigemptyset(&act.sa_mask);
+        if (0 == sigaction(opal_trace_signal, &act, NULL)) {
+            opal_progress_register_lp(opal_trace_progress);
+            opal_trace_progress_registered = true;
+        } else {
+            opal_output(0, "opal_trace: could not install a handler for signal %d: %s",
+                        opal_trace_signal, strerror(errno));
+        }
+    }
+
+    opal_finalize_register_cleanup(opal_trace_finalize);
+
+    return OPAL_SUCCESS;
+}
+
+int opal_trace_flush(void)
+{
+    opal_trace_file_header_t *header;
+    opal_trace_buffer_t *buffer;
+    uint64_t capacity = (uint64_t) opal_trace_buffer_records;
+    uint64_t *heads = NULL;
+    size_t length;
+    char *filename, *ptr;
+    uint32_t i;
+    int fd, ret = OPAL_SUCCESS;
+
+    opal_mutex_lock(&opal_trace_lock);
+
+    /* take a snapshot of the heads so the file size is known up front */
+    if (0 < opal_trace_nbuffers) {
+        heads = malloc(opal_trace_nbuffers * sizeof(heads[0]));
+        if (NULL == heads) {
+            opal_mutex_unlock(&opal_trace_lock);
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    length = sizeof(*header);
+    for (buffer = opal_trace_buffers, i = 0; NULL != buffer; buffer = buffer->next, ++i) {
+        heads[i] = buffer->head;
+        length += sizeof(opal_trace_thread_header_t)
+                  + (size_t) (heads[i] < capacity ? heads[i] : capacity)
+                        * sizeof(opal_trace_record_t);
+    }
+    opal_atomic_rmb();
+
+    if (0 > opal_asprintf(&filename, "%s.%u.%u.trc", opal_trace_file,
+                          (unsigned) OPAL_PROC_MY_NAME.vpid, (unsigned) getpid())) {
+        ret = OPAL_ERR_OUT_OF_RESOURCE;
+        goto out;
+    }
+
+    fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (0 > fd || 0 != ftruncate(fd, (off_t) length)) {
+        opal_output(0, "opal_trace: could not create %s: %s", filename, strerror(errno));
+        if (0 <= fd) {
+            close(fd);
+        }
+        free(filename);
+        ret = OPAL_ERR_FILE_OPEN_FAILURE;
+        goto out;
+    }
+
+    ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == ptr) {
+        opal_output(0, "opal_trace: could not map %s: %s", filename, strerror(errno));
+        free(filename);
+        ret = OPAL_ERR_FILE_WRITE_FAILURE;
+        goto out;
+    }
+    free(filename);
+
+    header = (opal_trace_file_header_t *) ptr;
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, "OPALTRC", 8);
+    header->version = OPAL_TRACE_FORMAT_VERSION;
+    header->record_size = sizeof(opal_trace_record_t);
+    header->cycles_per_sec = opal_timer_base_get_freq();
+    header->jobid = OPAL_PROC_MY_NAME.jobid;
+    header->vpid = OPAL_PROC_MY_NAME.vpid;
+    header->pid = (uint32_t) getpid();
+    header->nthreads = opal_trace_nbuffers;
+    ptr += sizeof(*header);
+
+    for (buffer = opal_trace_buffers, i = 0; NULL != buffer; buffer = buffer->next, ++i) {
+        opal_trace_thread_header_t *thread = (opal_trace_thread_header_t *) ptr;
+        uint64_t head = heads[i];
+        uint64_t count = head < capacity ? head : capacity;
+        uint64_t first = (head - count) & buffer->mask;
+        uint64_t tail = capacity - first < count ? capacity - first : count;
+
+        thread->thread = buffer->thread;
+        thread->nrecords = (uint32_t) count;
+        thread->dropped = head - count;
+        ptr += sizeof(*thread);
+
+        /* oldest records first */
+        memcpy(ptr, buffer->records + first, tail * sizeof(opal_trace_record_t));
+        memcpy(ptr + tail * sizeof(opal_trace_record_t), buffer->records,
+               (count - tail) * sizeof(opal_trace_record_t));
+        ptr += count * sizeof(opal_trace_record_t);
+    }
+
+    munmap((void *) header, length);
+
+out:
+    opal_mutex_unlock(&opal_trace_lock);
+    free(heads);
+    return ret;
+}
@@ -0,0 +1,177 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Sampling event tracer for the communication hot path.
+ *
+ * Each thread writes fixed-size binary records into its own ring buffer,
+ * so recording an event needs neither locks nor atomics. The buffers are
+ * written to a memory mapped file per process at finalize, or when the
+ * signal selected with opal_trace_signal is received. Only the most recent
+ * records of each thread are kept. contrib/opal-trace-to-json.py converts
+ * the files to the Chrome trace event format.
+ *
+ * The tracer is controlled by the opal_trace_sample_rate MCA parameter:
+ * 0 disables it, N records one out of N events of each thread.
+ */
+
+#ifndef OPAL_RUNTIME_OPAL_TRACE_H
+#define OPAL_RUNTIME_OPAL_TRACE_H
+
+#include "opal_config.h"
+
+#include "opal/prefetch.h"
+#include "opal/mca/threads/thread_usage.h"
+#include "opal/sys/atomic.h"
+
+#include MCA_timer_IMPLEMENTATION_HEADER
+
+BEGIN_C_DECLS
+
+/* Bumped when the layout of the file or of the records changes */
+#define OPAL_TRACE_FORMAT_VERSION 1
+
+typedef enum {
+    OPAL_TRACE_PML_SEND_START = 1,
+    OPAL_TRACE_PML_SEND_COMPLETE,
+    OPAL_TRACE_PML_RECV_POST,
+    OPAL_TRACE_PML_RECV_MATCH,
+    OPAL_TRACE_PML_RECV_COMPLETE,
+    OPAL_TRACE_BTL_SM_SEND_COMPLETE,
+    OPAL_TRACE_BTL_TCP_SEND_COMPLETE,
+    OPAL_TRACE_NUM_EVENTS
+} opal_trace_event_t;
+
+/**
+ * One trace record, as stored in the file. The timestamp is in cycles of
+ * the opal timer; the file header holds the frequency.
+ */
+typedef struct opal_trace_record_t {
+    uint64_t timestamp;
+    uint64_t size;
+    uint32_t event;
+    int32_t peer;
+    int32_t tag;
+    uint32_t cid;
+} opal_trace_record_t;
+
+/**
+ * Header of a trace file, followed by one opal_trace_thread_header_t and
+ * its records, oldest first, for each thread.
+ */
+typedef struct opal_trace_file_header_t {
+    char magic[8]; /**< "OPALTRC" */
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t cycles_per_sec;
+    uint32_t jobid;
+    uint32_t vpid;
+    uint32_t pid;
+    uint32_t nthreads;
+} opal_trace_file_header_t;
+
+typedef struct opal_trace_thread_header_t {
+    uint32_t thread;
+    uint32_t nrecords;
+    /** number of records dropped because the ring was full */
+    uint64_t dropped;
+} opal_trace_thread_header_t;
+
+/**
+ * Per-thread ring buffer. Only the owning thread writes the records and
+ * head; the flush reads them.
+ */
+typedef struct opal_trace_buffer_t {
+    struct opal_trace_buffer_t *next;
+    volatile uint64_t head; /**< number of records ever written */
+    uint64_t mask;
+    int countdown; /**< events to skip before the next sample */
+    uint32_t thread;
+    opal_trace_record_t records[];
+} opal_trace_buffer_t;
+
+/** Non-zero when tracing is enabled. */
+OPAL_DECLSPEC extern int opal_trace_sample_rate;
+
+#if OPAL_HAVE_THREAD_LOCAL
+OPAL_DECLSPEC extern opal_thread_local opal_trace_buffer_t *opal_trace_buffer;
+#endif
+
+OPAL_DECLSPEC int opal_trace_register_params(void);
+
+/**
+ * Set up the tracer. Called from opal_init(). Tracing is disabled if the
+ * compiler has no thread local storage.
+ */
+OPAL_DECLSPEC int opal_trace_init(void);
+
+/**
+ * Write the trace file and stop tracing. Registered as an opal_finalize()
+ * cleanup, and called by MPI_Finalize, which does not call
+ * opal_finalize(). Calling it again does nothing.
+ */
+OPAL_DECLSPEC void opal_trace_finalize(void);
+
+/**
+ * Write the buffers of all threads to the trace file of the process.
+ * Threads may keep recording while this runs, in which case the oldest
+ * records of their ring may be overwritten while being copied.
+ */
+OPAL_DECLSPEC int opal_trace_flush(void);
+
+OPAL_DECLSPEC opal_trace_buffer_t *opal_trace_buffer_create(void);
+
+static inline void opal_trace_record(opal_trace_event_t event, int32_t peer, int32_t tag,
+                                     uint32_t cid, uint64_t size)
+{
+#if OPAL_HAVE_THREAD_LOCAL
+    opal_trace_buffer_t *buffer = opal_trace_buffer;
+    opal_trace_record_t *record;
+
+    if (OPAL_UNLIKELY(NULL == buffer)) {
+        buffer = opal_trace_buffer_create();
+        if (NULL == buffer) {
+            return;
+        }
+    }
+
+    if (--buffer->countdown > 0) {
+        return;
+    }
+    buffer->countdown = opal_trace_sample_rate;
+
+    record = buffer->records + (buffer->head & buffer->mask);
+    record->timestamp = opal_timer_base_get_cycles();
+    record->size = size;
+    record->event = event;
+    record->peer = peer;
+    record->tag = tag;
+    record->cid = cid;
+    opal_atomic_wmb();
+    buffer->head = buffer->head + 1;
+#endif
+}
+
+/**
+ * Record an event if tracing is enabled. This is a single predictable
+ * branch when it is not.
+ */
+#define OPAL_TRACE(event, peer, tag, cid, size)                                    \
+    do {                                                                           \
+        if (OPAL_UNLIKELY(0 != opal_trace_sample_rate)) {                          \
+            opal_trace_record((event), (int32_t) (peer), (int32_t) (tag),          \
+                              (uint32_t) (cid), (uint64_t) (size));                \
+        }                                                                          \
+    } while (0)
+
+END_C_DECLS
+
+#endif /* OPAL_RUNTIME_OPAL_TRACE_H */
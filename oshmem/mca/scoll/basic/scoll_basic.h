@@ -40,6 +40,9 @@ OSHMEM_DECLSPEC extern int mca_scoll_basic_param_barrier_algorithm;
 extern int mca_scoll_basic_param_broadcast_algorithm;
 extern int mca_scoll_basic_param_collect_algorithm;
 extern int mca_scoll_basic_param_reduce_algorithm;
+extern bool mca_scoll_basic_param_reduce_algorithm_set;
+extern size_t mca_scoll_basic_param_reduce_rabenseifner_min;
+extern size_t mca_scoll_basic_param_reduce_segsize;
 
 /* API functions */
 
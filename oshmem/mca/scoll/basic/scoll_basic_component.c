@@ -33,6 +33,9 @@ int mca_scoll_basic_param_broadcast_algorithm = SCOLL_ALG_BROADCAST_BINOMIAL;
 int mca_scoll_basic_param_collect_algorithm =
         SCOLL_ALG_COLLECT_RECURSIVE_DOUBLING;
 int mca_scoll_basic_param_reduce_algorithm = SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING;
+bool mca_scoll_basic_param_reduce_algorithm_set = false;
+size_t mca_scoll_basic_param_reduce_rabenseifner_min = 262144;
+size_t mca_scoll_basic_param_reduce_segsize = 65536;
 
 /*
  * Local function
@@ -79,6 +82,7 @@ static int basic_register(void)
 {
     char help_msg[200];
     mca_base_component_t *comp = &mca_scoll_basic_component.scoll_version;
+    int var_id;
 
     mca_scoll_basic_priority_param = 75;
     (void) mca_base_component_var_register(comp,
@@ -132,19 +136,46 @@ static int basic_register(void)
                                            &mca_scoll_basic_param_collect_algorithm);
 
     sprintf(help_msg,
-            "Algorithm selection for Reduce (%d - Central Counter, %d - Tournament, %d - Recursive Doubling %d - Linear %d - Log)",
+            "Algorithm selection for Reduce (%d - Central Counter, %d - Tournament, %d - Recursive Doubling %d - Linear %d - Log %d - Rabenseifner)",
             SCOLL_ALG_REDUCE_CENTRAL_COUNTER,
             SCOLL_ALG_REDUCE_TOURNAMENT,
             SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING,
             SCOLL_ALG_REDUCE_LEGACY_LINEAR,
-            SCOLL_ALG_REDUCE_LEGACY_LOG);
+            SCOLL_ALG_REDUCE_LEGACY_LOG,
+            SCOLL_ALG_REDUCE_RABENSEIFNER);
+    var_id = mca_base_component_var_register(comp,
+                                             "reduce_alg",
+                                             help_msg,
+                                             MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                             OPAL_INFO_LVL_9,
+                                             MCA_BASE_VAR_SCOPE_READONLY,
+                                             &mca_scoll_basic_param_reduce_algorithm);
+    /* an algorithm requested by the user is not overridden by reduce_rabenseifner_min */
+    if (0 <= var_id) {
+        mca_base_var_source_t source = MCA_BASE_VAR_SOURCE_DEFAULT;
+
+        mca_base_var_get_value(var_id, NULL, &source, NULL);
+        mca_scoll_basic_param_reduce_algorithm_set = (MCA_BASE_VAR_SOURCE_DEFAULT != source);
+    }
+
     (void) mca_base_component_var_register(comp,
-                                           "reduce_alg",
-                                           help_msg,
-                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           "reduce_rabenseifner_min",
+                                           "Minimal message size in bytes for which the default Reduce algorithm "
+                                           "is replaced by the Rabenseifner (reduce-scatter + allgather) algorithm, unless reduce_alg "
+                                           "is set (0 - disable)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_basic_param_reduce_rabenseifner_min);
+
+    (void) mca_base_component_var_register(comp,
+                                           "reduce_segsize",
+                                           "Segment size in bytes used to pipeline data transfers and reduction "
+                                           "in the Rabenseifner Reduce algorithm",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY,
-                                           &mca_scoll_basic_param_reduce_algorithm);
+                                           &mca_scoll_basic_param_reduce_segsize);
 
     return OSHMEM_SUCCESS;
 }
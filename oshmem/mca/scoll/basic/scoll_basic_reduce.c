@@ -14,6 +14,9 @@
 
 #include "opal/util/bit_ops.h"
 
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+
 #include "oshmem/constants.h"
 #include "oshmem/op/op.h"
 #include "oshmem/mca/spml/spml.h"
@@ -56,6 +59,13 @@ static int _algorithm_log(struct oshmem_group_t *group,
                            size_t nlong,
                            long *pSync,
                            void *pWrk);
+static int _algorithm_rabenseifner(struct oshmem_group_t *group,
+                                    struct oshmem_op_t *op,
+                                    void *target,
+                                    const void *source,
+                                    size_t nlong,
+                                    long *pSync,
+                                    void *pWrk);
 
 int mca_scoll_basic_reduce(struct oshmem_group_t *group,
                            struct oshmem_op_t *op,
@@ -84,8 +94,17 @@ int mca_scoll_basic_reduce(struct oshmem_group_t *group,
         }
 
         if (pSync) {
-            alg = (alg == SCOLL_DEFAULT_ALG ?
-                    mca_scoll_basic_param_reduce_algorithm : alg);
+            if (alg == SCOLL_DEFAULT_ALG) {
+                alg = mca_scoll_basic_param_reduce_algorithm;
+                /* Large vectors are bandwidth bound: split them across the group,
+                 * unless the user asked for an algorithm */
+                if (!mca_scoll_basic_param_reduce_algorithm_set &&
+                    mca_scoll_basic_param_reduce_rabenseifner_min &&
+                    (nlong >= mca_scoll_basic_param_reduce_rabenseifner_min) &&
+                    (group->proc_count > 2)) {
+                    alg = SCOLL_ALG_REDUCE_RABENSEIFNER;
+                }
+            }
             switch (alg) {
             case SCOLL_ALG_REDUCE_CENTRAL_COUNTER:
                 {
@@ -142,6 +161,17 @@ int mca_scoll_basic_reduce(struct oshmem_group_t *group,
                                          pWrk);
                     break;
                 }
+            case SCOLL_ALG_REDUCE_RABENSEIFNER:
+                {
+                    rc = _algorithm_rabenseifner(group,
+                                                  op,
+                                                  target,
+                                                  source,
+                                                  nlong,
+                                                  pSync,
+                                                  pWrk);
+                    break;
+                }
             default:
                 {
                     rc = _algorithm_central_counter(group,
@@ -816,3 +846,265 @@ static int _algorithm_log(struct oshmem_group_t *group,
     /* All done */
     return rc;
 }
+
+/*
+ Map OSHMEM operation to the OMPI one so that the combine step goes through
+ the op framework and picks up accelerated kernels (e.g. op:avx) when they
+ were selected for the datatype. NULL is returned when there is no match.
+ */
+static struct ompi_op_t *_ompi_op_lookup(struct oshmem_op_t *op,
+                                         struct ompi_datatype_t **dtype)
+{
+    struct ompi_op_t *mpi_op = NULL;
+
+    switch (op->dt) {
+    case OSHMEM_OP_TYPE_FLOAT:
+    case OSHMEM_OP_TYPE_FREAL4:
+        *dtype = &ompi_mpi_float.dt;
+        break;
+    case OSHMEM_OP_TYPE_DOUBLE:
+    case OSHMEM_OP_TYPE_FREAL8:
+        *dtype = &ompi_mpi_double.dt;
+        break;
+    case OSHMEM_OP_TYPE_LDOUBLE:
+        *dtype = &ompi_mpi_long_double.dt;
+        break;
+    case OSHMEM_OP_TYPE_FCOMPLEX:
+        *dtype = &ompi_mpi_c_float_complex.dt;
+        break;
+    case OSHMEM_OP_TYPE_DCOMPLEX:
+        *dtype = &ompi_mpi_c_double_complex.dt;
+        break;
+    case OSHMEM_OP_TYPE_FREAL16:
+        return NULL;
+    default:
+        switch (op->dt_size) {
+        case 8:
+            *dtype = &ompi_mpi_int64_t.dt;
+            break;
+        case 4:
+            *dtype = &ompi_mpi_int32_t.dt;
+            break;
+        case 2:
+            *dtype = &ompi_mpi_int16_t.dt;
+            break;
+        case 1:
+            *dtype = &ompi_mpi_int8_t.dt;
+            break;
+        default:
+            return NULL;
+        }
+    }
+
+    switch (op->op) {
+    case OSHMEM_OP_AND:
+        mpi_op = &ompi_mpi_op_band.op;
+        break;
+    case OSHMEM_OP_OR:
+        mpi_op = &ompi_mpi_op_bor.op;
+        break;
+    case OSHMEM_OP_XOR:
+        mpi_op = &ompi_mpi_op_bxor.op;
+        break;
+    case OSHMEM_OP_MAX:
+        mpi_op = &ompi_mpi_op_max.op;
+        break;
+    case OSHMEM_OP_MIN:
+        mpi_op = &ompi_mpi_op_min.op;
+        break;
+    case OSHMEM_OP_SUM:
+        mpi_op = &ompi_mpi_op_sum.op;
+        break;
+    case OSHMEM_OP_PROD:
+        mpi_op = &ompi_mpi_op_prod.op;
+        break;
+    default:
+        return NULL;
+    }
+
+    if (-1 == ompi_op_ddt_map[(*dtype)->id] ||
+        NULL == mpi_op->o_func.intrinsic.fns[ompi_op_ddt_map[(*dtype)->id]]) {
+        return NULL;
+    }
+
+    return mpi_op;
+}
+
+/*
+ Reduce-scatter followed by allgather (Rabenseifner).
+ The vector is split into NP blocks on element boundary and every PE owns one
+ of them. At reduce-scatter stage a PE fetches its block from the source of
+ every peer in ring order (so at each step all PEs read from different peers)
+ and combines it into a local accumulator. Transfers are pipelined by segments:
+ the next segment is requested with get_nb while the current one is reduced.
+ At allgather stage every PE fetches reduced blocks from the owners' target.
+ Outlay:
+ Each PE moves 2*(NP-1)/NP*nlong bytes and combines (NP-1)/NP*nlong bytes
+ independent of NP, so it is suitable for large vectors.
+ pWrk is not used, the accumulator is allocated locally.
+ */
+static int _algorithm_rabenseifner(struct oshmem_group_t *group,
+                                    struct oshmem_op_t *op,
+                                    void *target,
+                                    const void *source,
+                                    size_t nlong,
+                                    long *pSync,
+                                    void *pWrk)
+{
+    int rc = OSHMEM_SUCCESS;
+    int my_id = oshmem_proc_group_find_id(group, group->my_pe);
+    int size = group->proc_count;
+    size_t count = nlong / op->dt_size;
+    size_t blk_count = count / size;
+    size_t blk_extra = count % size;
+    size_t my_offset = 0;
+    size_t my_nlong = 0;
+    size_t seg_nlong = 0;
+    size_t nsegs = 0;
+    size_t total = 0;
+    size_t t = 0;
+    char *accum = NULL;
+    char *stage[2] = {NULL, NULL};
+    struct ompi_datatype_t *dtype = NULL;
+    struct ompi_op_t *mpi_op = NULL;
+    int peer_id = 0;
+    int peer_pe = 0;
+    int i = 0;
+
+    SCOLL_VERBOSE(12, "[#%d] Reduce algorithm: Rabenseifner", group->my_pe);
+
+/* Offset (in bytes) and length (in bytes) of the block owned by the given id */
+#define BLOCK_OFFSET(id) \
+    ((((size_t)(id)) * blk_count + ((size_t)(id) < blk_extra ? (size_t)(id) : blk_extra)) * op->dt_size)
+#define BLOCK_NLONG(id) \
+    ((blk_count + ((size_t)(id) < blk_extra ? 1 : 0)) * op->dt_size)
+
+    my_offset = BLOCK_OFFSET(my_id);
+    my_nlong = BLOCK_NLONG(my_id);
+
+    /* Segment is aligned on datatype size */
+    seg_nlong = (mca_scoll_basic_param_reduce_segsize / op->dt_size) * op->dt_size;
+    if (!seg_nlong || seg_nlong > my_nlong) {
+        seg_nlong = my_nlong;
+    }
+    nsegs = seg_nlong ? (my_nlong + seg_nlong - 1) / seg_nlong : 0;
+    total = nsegs * (size - 1);
+
+    mpi_op = _ompi_op_lookup(op, &dtype);
+
+    if (my_nlong) {
+        accum = malloc(my_nlong + 2 * seg_nlong);
+        if (NULL == accum) {
+            return OSHMEM_ERR_OUT_OF_RESOURCE;
+        }
+        stage[0] = accum + my_nlong;
+        stage[1] = stage[0] + seg_nlong;
+        memcpy(accum, (char *) source + my_offset, my_nlong);
+    }
+
+    /* Make sure all peers entered the collective and sources are ready */
+    rc = BARRIER_FUNC(group, (pSync + 2), SCOLL_DEFAULT_ALG);
+    if (rc != OSHMEM_SUCCESS) {
+        goto cleanup_and_return;
+    }
+
+    /* Reduce-scatter stage */
+    SCOLL_VERBOSE(14,
+                  "[#%d] reduce-scatter: block %d (%d bytes) in %d segments",
+                  group->my_pe, my_id, (int)my_nlong, (int)nsegs);
+    if (total) {
+        peer_pe = oshmem_proc_pe_vpid(group, (my_id + 1) % size);
+        rc = MCA_SPML_CALL(get_nb(oshmem_ctx_default,
+                                  (char *) source + my_offset,
+                                  seg_nlong, stage[0], peer_pe, NULL));
+    }
+    for (t = 0; (t < total) && (rc == OSHMEM_SUCCESS); t++) {
+        size_t seg_offset = (t % nsegs) * seg_nlong;
+        size_t cur_nlong = (my_nlong - seg_offset < seg_nlong ?
+                            my_nlong - seg_offset : seg_nlong);
+
+        /* Complete current segment */
+        rc = MCA_SPML_CALL(quiet(oshmem_ctx_default));
+        if (rc != OSHMEM_SUCCESS) {
+            break;
+        }
+
+        /* Request next segment while the current one is reduced */
+        if (t + 1 < total) {
+            size_t next_offset = ((t + 1) % nsegs) * seg_nlong;
+            size_t next_nlong = (my_nlong - next_offset < seg_nlong ?
+                                 my_nlong - next_offset : seg_nlong);
+
+            peer_id = (int)((my_id + 1 + (t + 1) / nsegs) % size);
+            peer_pe = oshmem_proc_pe_vpid(group, peer_id);
+            rc = MCA_SPML_CALL(get_nb(oshmem_ctx_default,
+                                      (char *) source + my_offset + next_offset,
+                                      next_nlong, stage[(t + 1) & 1], peer_pe, NULL));
+        }
+
+        if (mpi_op) {
+            ompi_op_reduce(mpi_op, stage[t & 1], accum + seg_offset,
+                           cur_nlong / op->dt_size, dtype);
+        } else {
+            op->o_func.c_fn(stage[t & 1], accum + seg_offset,
+                            (int)(cur_nlong / op->dt_size));
+        }
+    }
+    if (rc != OSHMEM_SUCCESS) {
+        goto cleanup_and_return;
+    }
+
+    /* Nobody has to read source any longer before target is overwritten */
+    if (source == target) {
+        rc = BARRIER_FUNC(group, (pSync + 2), SCOLL_DEFAULT_ALG);
+        if (rc != OSHMEM_SUCCESS) {
+            goto cleanup_and_return;
+        }
+    }
+
+    if (my_nlong) {
+        memcpy((char *) target + my_offset, accum, my_nlong);
+    }
+
+    /* Wait for all blocks to be reduced */
+    rc = BARRIER_FUNC(group, (pSync + 2), SCOLL_DEFAULT_ALG);
+    if (rc != OSHMEM_SUCCESS) {
+        goto cleanup_and_return;
+    }
+
+    /* Allgather stage */
+    SCOLL_VERBOSE(14, "[#%d] allgather reduced blocks", group->my_pe);
+    for (i = 1; (i < size) && (rc == OSHMEM_SUCCESS); i++) {
+        size_t offset = 0;
+        size_t blk_nlong = 0;
+
+        peer_id = (my_id + i) % size;
+        peer_pe = oshmem_proc_pe_vpid(group, peer_id);
+        offset = BLOCK_OFFSET(peer_id);
+        blk_nlong = BLOCK_NLONG(peer_id);
+        if (blk_nlong) {
+            rc = MCA_SPML_CALL(get_nb(oshmem_ctx_default,
+                                      (char *) target + offset,
+                                      blk_nlong, (char *) target + offset,
+                                      peer_pe, NULL));
+        }
+    }
+    if (rc == OSHMEM_SUCCESS) {
+        rc = MCA_SPML_CALL(quiet(oshmem_ctx_default));
+    }
+
+    /* Peers can still read from our target */
+    if (rc == OSHMEM_SUCCESS) {
+        rc = BARRIER_FUNC(group, (pSync + 2), SCOLL_DEFAULT_ALG);
+    }
+
+#undef BLOCK_OFFSET
+#undef BLOCK_NLONG
+
+cleanup_and_return:
+    if (NULL != accum) {
+        free(accum);
+    }
+
+    return rc;
+}
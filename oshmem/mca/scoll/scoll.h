@@ -112,6 +112,7 @@ typedef int
 #define SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING     2
 #define SCOLL_ALG_REDUCE_LEGACY_LINEAR          3   /* Based linear algorithm from OMPI coll:basic */
 #define SCOLL_ALG_REDUCE_LEGACY_LOG             4   /* Based log algorithm from OMPI coll:basic */
+#define SCOLL_ALG_REDUCE_RABENSEIFNER           5   /* Reduce-scatter followed by allgather */
 
 typedef int (*mca_scoll_base_module_barrier_fn_t)(struct oshmem_group_t *group,
                                                   long *pSync,
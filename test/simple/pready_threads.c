@@ -0,0 +1,148 @@
+/*
+ * Multithreaded producers for partitioned communication. Rank 0 has several
+ * threads that each fill a slice of the partitions of a persistent
+ * partitioned send and mark them ready with MPI_Pready, while rank 1
+ * receives them. Reports the average time of a round and of an MPI_Pready
+ * call. Compare different values of "--mca part_persist_min_transfer_size".
+ *
+ * Usage: mpirun -n 2 ./pready_threads [threads] [partitions] [count] [rounds]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+
+struct producer_t {
+    pthread_t thread;
+    int id;
+    double pready_time;
+};
+
+static int nthreads = 4, partitions = 4096, count = 16, rounds = 100;
+static int *buf;
+static MPI_Request request;
+static pthread_barrier_t round_start, round_end;
+
+static void *producer(void *arg)
+{
+    struct producer_t *p = (struct producer_t *) arg;
+    int first = (int) ((long) partitions * p->id / nthreads);
+    int last = (int) ((long) partitions * (p->id + 1) / nthreads);
+    int r, i, j;
+
+    for (r = 0; r < rounds; r++) {
+        pthread_barrier_wait(&round_start);
+        for (i = first; i < last; i++) {
+            double start;
+
+            for (j = 0; j < count; j++) {
+                buf[i * count + j] = r + i + j;
+            }
+            start = MPI_Wtime();
+            MPI_Pready(i, request);
+            p->pready_time += MPI_Wtime() - start;
+        }
+        pthread_barrier_wait(&round_end);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    struct producer_t *producers = NULL;
+    int provided, rank, size, r, i, errors = 0;
+    double start, elapsed, pready_time = 0.0;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (MPI_THREAD_MULTIPLE != provided || 2 > size) {
+        if (0 == rank) {
+            fprintf(stderr, "need MPI_THREAD_MULTIPLE and at least 2 processes\n");
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    if (1 < argc) {
+        nthreads = atoi(argv[1]);
+    }
+    if (2 < argc) {
+        partitions = atoi(argv[2]);
+    }
+    if (3 < argc) {
+        count = atoi(argv[3]);
+    }
+    if (4 < argc) {
+        rounds = atoi(argv[4]);
+    }
+
+    buf = (int *) malloc((size_t) partitions * count * sizeof(int));
+
+    if (0 == rank) {
+        MPI_Psend_init(buf, partitions, count, MPI_INT, 1, 0, MPI_COMM_WORLD, MPI_INFO_NULL,
+                       &request);
+
+        producers = (struct producer_t *) calloc(nthreads, sizeof(struct producer_t));
+        pthread_barrier_init(&round_start, NULL, nthreads + 1);
+        pthread_barrier_init(&round_end, NULL, nthreads + 1);
+        for (i = 0; i < nthreads; i++) {
+            producers[i].id = i;
+            pthread_create(&producers[i].thread, NULL, producer, &producers[i]);
+        }
+    } else if (1 == rank) {
+        MPI_Precv_init(buf, partitions, count, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_INFO_NULL,
+                       &request);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    start = MPI_Wtime();
+    for (r = 0; r < rounds; r++) {
+        if (0 == rank) {
+            MPI_Start(&request);
+            pthread_barrier_wait(&round_start);
+            pthread_barrier_wait(&round_end);
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+        } else if (1 == rank) {
+            MPI_Start(&request);
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            for (i = 0; i < partitions * count; i++) {
+                if (buf[i] != r + i / count + i % count) {
+                    errors++;
+                    break;
+                }
+            }
+        }
+        /* the sender must not overwrite the buffer before it was checked */
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+    elapsed = MPI_Wtime() - start;
+
+    if (0 == rank) {
+        for (i = 0; i < nthreads; i++) {
+            pthread_join(producers[i].thread, NULL);
+            pready_time += producers[i].pready_time;
+        }
+        pthread_barrier_destroy(&round_start);
+        pthread_barrier_destroy(&round_end);
+        free(producers);
+
+        printf("%d threads, %d partitions of %d ints: %.2f usec/round, %.3f usec/MPI_Pready\n",
+               nthreads, partitions, count, 1e6 * elapsed / rounds,
+               1e6 * pready_time / ((double) rounds * partitions));
+    } else if (1 == rank) {
+        printf("receiver: %d rounds, %d errors\n", rounds, errors);
+    }
+
+    if (1 >= rank) {
+        MPI_Request_free(&request);
+    }
+    free(buf);
+
+    MPI_Finalize();
+    return 0 == errors ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/*
+ * Shared memory ping-pong latency for a range of message sizes. Run all
+ * ranks on one node and compare the default shared memory segments with
+ * huge page backed ones:
+ *
+ *   mpirun -n 2 ./sm_pingpong
+ *   mpirun -n 2 --mca shmem_mmap_hugepages 2 ./sm_pingpong
+ *
+ * With more than two ranks, rank 0 ping-pongs with every other rank in turn,
+ * which touches many peers' segments the way a crowded node does.
+ *
+ * A stride larger than 1 sends every stride-th double of a buffer instead of
+ * contiguous bytes, which exercises the non-contiguous single-copy path:
+ *
+ *   mpirun -n 2 --mca smsc cma ./sm_pingpong 10000 1048576 4
+ *
+ * Usage: mpirun -n <n> ./sm_pingpong [iterations] [max size] [stride]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+int main(int argc, char *argv[])
+{
+    int rank, size, iters = 10000, max_size = 1 << 20, stride = 1;
+    int msg_size, peer, i, count;
+    MPI_Datatype type = MPI_CHAR;
+    size_t buf_size;
+    char *buf;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (1 < argc) {
+        iters = atoi(argv[1]);
+    }
+    if (2 < argc) {
+        max_size = atoi(argv[2]);
+    }
+    if (3 < argc) {
+        stride = atoi(argv[3]);
+    }
+    if (2 > size) {
+        if (0 == rank) {
+            fprintf(stderr, "need at least 2 processes\n");
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    buf_size = (size_t) (max_size > 0 ? max_size : 1) * (stride > 1 ? stride : 1);
+    buf = (char *) malloc(buf_size);
+    memset(buf, rank, buf_size);
+
+    if (0 == rank) {
+        printf("%10s %12s\n", "bytes", "usec/half-rtt");
+    }
+
+    for (msg_size = 0; msg_size <= max_size; msg_size = msg_size ? 2 * msg_size : 1) {
+        double start, elapsed;
+
+        /* message sizes are in bytes of payload in both cases */
+        count = msg_size;
+        if (1 < stride) {
+            if (msg_size < (int) sizeof(double)) {
+                continue;
+            }
+            MPI_Type_vector(msg_size / sizeof(double), 1, stride, MPI_DOUBLE, &type);
+            MPI_Type_commit(&type);
+            count = 1;
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        start = MPI_Wtime();
+        for (i = 0; i < iters; i++) {
+            if (0 == rank) {
+                /* cycle over all peers so that every segment is touched */
+                peer = 1 + i % (size - 1);
+                MPI_Send(buf, count, type, peer, 0, MPI_COMM_WORLD);
+                MPI_Recv(buf, count, type, peer, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            } else if (rank == 1 + i % (size - 1)) {
+                MPI_Recv(buf, count, type, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Send(buf, count, type, 0, 0, MPI_COMM_WORLD);
+            }
+        }
+        elapsed = MPI_Wtime() - start;
+
+        if (1 < stride) {
+            MPI_Type_free(&type);
+        }
+
+        if (0 == rank) {
+            printf("%10d %12.3f\n", msg_size, 1e6 * elapsed / (2.0 * iters));
+        }
+        if (0 == max_size) {
+            break;
+        }
+    }
+
+    free(buf);
+
+    MPI_Finalize();
+    return 0;
+}
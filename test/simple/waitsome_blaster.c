@@ -0,0 +1,107 @@
+/*
+ * Drain a large number of outstanding receives with MPI_Waitsome (or
+ * MPI_Testsome), as irregular sparse solvers do. Compare with
+ * "--mca mpi_request_cq_threshold 0" to see the cost of scanning the whole
+ * request array on every call.
+ *
+ * Usage: mpirun -n 2 ./waitsome_blaster [nreqs] [test]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+int main(int argc, char *argv[])
+{
+    int rank, size, partner, nreqs = 50000, use_test = 0;
+    int outcount, done = 0, calls = 0, errors = 0;
+    int *rbuf, *sbuf, *indices;
+    char *seen;
+    MPI_Request *rreqs, *sreqs;
+    double start, elapsed;
+    int i;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (1 < argc) {
+        nreqs = atoi(argv[1]);
+    }
+    if (2 < argc && 0 == strcmp(argv[2], "test")) {
+        use_test = 1;
+    }
+
+    /* pair up ranks, an odd one out talks to itself */
+    partner = rank ^ 1;
+    if (partner >= size) {
+        partner = rank;
+    }
+
+    rbuf = (int *) malloc(nreqs * sizeof(int));
+    sbuf = (int *) malloc(nreqs * sizeof(int));
+    indices = (int *) malloc(nreqs * sizeof(int));
+    seen = (char *) calloc(nreqs, 1);
+    rreqs = (MPI_Request *) malloc(nreqs * sizeof(MPI_Request));
+    sreqs = (MPI_Request *) malloc(nreqs * sizeof(MPI_Request));
+
+    for (i = 0; i < nreqs; i++) {
+        rbuf[i] = -1;
+        sbuf[i] = i;
+        MPI_Irecv(&rbuf[i], 1, MPI_INT, partner, 0, MPI_COMM_WORLD, &rreqs[i]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    start = MPI_Wtime();
+    for (i = 0; i < nreqs; i++) {
+        MPI_Isend(&sbuf[i], 1, MPI_INT, partner, 0, MPI_COMM_WORLD, &sreqs[i]);
+    }
+
+    for (;;) {
+        if (use_test) {
+            MPI_Testsome(nreqs, rreqs, &outcount, indices, MPI_STATUSES_IGNORE);
+        } else {
+            MPI_Waitsome(nreqs, rreqs, &outcount, indices, MPI_STATUSES_IGNORE);
+        }
+        if (MPI_UNDEFINED == outcount) {
+            break;
+        }
+        calls++;
+        for (i = 0; i < outcount; i++) {
+            if (seen[indices[i]] || MPI_REQUEST_NULL != rreqs[indices[i]]) {
+                errors++;
+            }
+            seen[indices[i]] = 1;
+        }
+        done += outcount;
+    }
+    elapsed = MPI_Wtime() - start;
+
+    MPI_Waitall(nreqs, sreqs, MPI_STATUSES_IGNORE);
+
+    /* messages with the same tag are matched in order */
+    for (i = 0; i < nreqs; i++) {
+        if (rbuf[i] != i || !seen[i]) {
+            errors++;
+        }
+    }
+    if (done != nreqs) {
+        errors++;
+    }
+
+    printf("[%d] %s: %d requests completed in %d calls, %.3f s (%.2f usec/request), %d errors\n",
+           rank, use_test ? "MPI_Testsome" : "MPI_Waitsome", done, calls, elapsed,
+           1e6 * elapsed / (double) nreqs, errors);
+
+    free(rbuf);
+    free(sbuf);
+    free(indices);
+    free(seen);
+    free(rreqs);
+    free(sreqs);
+
+    MPI_Finalize();
+    return 0 == errors ? 0 : 1;
+}
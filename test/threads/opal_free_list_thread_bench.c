@@ -0,0 +1,177 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Contention benchmark for opal_free_list_t. Every thread repeatedly takes a
+ * small batch of items from a shared free list and returns it, which is the
+ * allocation pattern of requests and fragments under MPI_THREAD_MULTIPLE. The
+ * benchmark is run once with the per-thread magazine caches disabled and once
+ * with them enabled.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "opal/class/opal_free_list.h"
+#include "opal/constants.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/runtime/opal.h"
+#include "opal/runtime/opal_params.h"
+#include "support.h"
+
+#define OPAL_FREE_LIST_TEST_THREAD_COUNT 8
+#define ITERATIONS                       1000000
+#define ITEM_COUNT                       1024
+#define BATCH_SIZE                       8
+#define MAGAZINE_SIZE                    32
+
+#if !defined(timersub)
+#    define timersub(a, b, r)                           \
+        do {                                            \
+            (r)->tv_sec = (a)->tv_sec - (b)->tv_sec;    \
+            if ((a)->tv_usec < (b)->tv_usec) {          \
+                (r)->tv_sec--;                          \
+                (a)->tv_usec += 1000000;                \
+            }                                           \
+            (r)->tv_usec = (a)->tv_usec - (b)->tv_usec; \
+        } while (0)
+#endif
+
+static void *thread_test(opal_object_t *arg)
+{
+    opal_thread_t *t = (opal_thread_t *) arg;
+    opal_free_list_t *flist = (opal_free_list_t *) t->t_arg;
+    opal_free_list_item_t *items[BATCH_SIZE];
+    intptr_t failed = 0;
+
+    for (int i = 0; i < ITERATIONS / BATCH_SIZE; ++i) {
+        for (int j = 0; j < BATCH_SIZE; ++j) {
+            items[j] = opal_free_list_get(flist);
+            if (NULL == items[j]) {
+                ++failed;
+            }
+        }
+
+        for (int j = 0; j < BATCH_SIZE; ++j) {
+            if (NULL != items[j]) {
+                opal_free_list_return(flist, items[j]);
+            }
+        }
+    }
+
+    return (void *) failed;
+}
+
+static void run_test(const char *name, int magazine_size)
+{
+    opal_thread_t threads[OPAL_FREE_LIST_TEST_THREAD_COUNT];
+    struct timeval start, stop, total;
+    opal_free_list_t flist;
+    opal_list_item_t *item;
+    intptr_t failed = 0;
+    size_t count = 0;
+    double timing;
+    int rc;
+
+    opal_free_list_magazine_size = magazine_size;
+
+    OBJ_CONSTRUCT(&flist, opal_free_list_t);
+    rc = opal_free_list_init(&flist, sizeof(opal_free_list_item_t), 8,
+                             OBJ_CLASS(opal_free_list_item_t), 0, 0, ITEM_COUNT, -1, ITEM_COUNT,
+                             NULL, 0, NULL, NULL, NULL);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        OBJ_DESTRUCT(&flist);
+        return;
+    }
+
+    if ((0 < magazine_size) == (NULL != flist.fl_caches)) {
+        test_success();
+    } else {
+        test_failure(" free list caches not configured as requested");
+    }
+
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < OPAL_FREE_LIST_TEST_THREAD_COUNT; ++i) {
+        OBJ_CONSTRUCT(&threads[i], opal_thread_t);
+        threads[i].t_run = thread_test;
+        threads[i].t_arg = &flist;
+        opal_thread_start(threads + i);
+    }
+
+    for (int i = 0; i < OPAL_FREE_LIST_TEST_THREAD_COUNT; ++i) {
+        void *ret;
+
+        opal_thread_join(threads + i, &ret);
+        failed += (intptr_t) ret;
+        OBJ_DESTRUCT(&threads[i]);
+    }
+    gettimeofday(&stop, NULL);
+
+    timersub(&stop, &start, &total);
+
+    timing = ((double) total.tv_sec + (double) total.tv_usec * 1e-6)
+             / (double) ((ITERATIONS / BATCH_SIZE) * BATCH_SIZE * OPAL_FREE_LIST_TEST_THREAD_COUNT);
+
+    printf("%s: Thread count: %d Time: %d s %d us %d nsec/getreturn\n", name,
+           OPAL_FREE_LIST_TEST_THREAD_COUNT, (int) total.tv_sec, (int) total.tv_usec,
+           (int) (timing / 1e-9));
+
+    if (0 == failed) {
+        test_success();
+    } else {
+        test_failure(" opal_free_list_get returned NULL");
+    }
+
+    /* every item must be accounted for once the caches are drained */
+    if (NULL != flist.fl_caches) {
+        (void) opal_free_list_reclaim_caches(&flist);
+    }
+
+    for (item = (opal_list_item_t *) flist.super.opal_lifo_head.data.item;
+         item != &flist.super.opal_lifo_ghost; item = opal_list_get_next(item)) {
+        ++count;
+    }
+
+    if (count == flist.fl_num_allocated) {
+        test_success();
+    } else {
+        test_failure(" free list lost items");
+    }
+
+    OBJ_DESTRUCT(&flist);
+}
+
+int main(int argc, char *argv[])
+{
+    int rc;
+
+    rc = opal_init_util(&argc, &argv);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        test_finalize();
+        exit(1);
+    }
+
+    test_init("opal_free_list_t thread contention");
+
+    opal_set_using_threads(true);
+
+    run_test("Shared LIFO", 0);
+#if OPAL_HAVE_THREAD_LOCAL
+    run_test("Magazine caches", MAGAZINE_SIZE);
+#endif
+
+    opal_finalize_util();
+
+    return test_finalize();
+}
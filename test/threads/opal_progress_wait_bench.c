@@ -0,0 +1,129 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Wakeup latency vs. CPU usage of opal_progress_wait(). A waiter thread
+ * blocks in opal_progress_wait() until the main thread posts a new round
+ * (after an idle delay) and calls opal_progress_wakeup(). The benchmark
+ * reports the average time between the post and the waiter noticing it, and
+ * the fraction of the wall time the waiter spent on a CPU, for pure spinning
+ * and for a few spin thresholds.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "opal/constants.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/runtime/opal.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/sys/atomic.h"
+#include "support.h"
+
+#define ROUNDS    200
+#define IDLE_USEC 2000
+
+static opal_atomic_int32_t round_posted = 0;
+static volatile uint64_t post_time[ROUNDS + 1];
+static uint64_t wake_latency = 0;
+static uint64_t waiter_cpu = 0;
+
+static uint64_t get_nsec(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static void *waiter_run(opal_object_t *arg)
+{
+    uint64_t cpu_start = get_nsec(CLOCK_THREAD_CPUTIME_ID);
+
+    wake_latency = 0;
+    for (int32_t r = 1; r <= ROUNDS; ++r) {
+        uint64_t idle_since = 0;
+
+        while (round_posted < r) {
+            opal_progress_wait(&idle_since);
+        }
+        wake_latency += get_nsec(CLOCK_MONOTONIC) - post_time[r];
+    }
+
+    waiter_cpu = get_nsec(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+
+    return NULL;
+}
+
+static void run_test(int spin_usec)
+{
+    struct timespec idle = {.tv_sec = 0, .tv_nsec = IDLE_USEC * 1000};
+    opal_thread_t *waiter;
+    uint64_t start, wall;
+    int rc;
+
+    opal_progress_spin_usec = spin_usec;
+    round_posted = 0;
+
+    waiter = OBJ_NEW(opal_thread_t);
+    waiter->t_run = waiter_run;
+
+    start = get_nsec(CLOCK_MONOTONIC);
+    rc = opal_thread_start(waiter);
+    test_verify_int(OPAL_SUCCESS, rc);
+
+    for (int32_t r = 1; r <= ROUNDS; ++r) {
+        nanosleep(&idle, NULL);
+        post_time[r] = get_nsec(CLOCK_MONOTONIC);
+        opal_atomic_wmb();
+        round_posted = r;
+        opal_progress_wakeup();
+    }
+
+    rc = opal_thread_join(waiter, NULL);
+    test_verify_int(OPAL_SUCCESS, rc);
+    wall = get_nsec(CLOCK_MONOTONIC) - start;
+
+    printf("spin_usec: %5d wakeup latency: %8.2f usec waiter cpu usage: %5.1f%%\n", spin_usec,
+           (double) wake_latency / (double) ROUNDS / 1000.0,
+           100.0 * (double) waiter_cpu / (double) wall);
+    fflush(stdout);
+
+    OBJ_RELEASE(waiter);
+}
+
+int main(int argc, char **argv)
+{
+    int rc;
+
+    test_init("opal_progress_wait");
+
+    rc = opal_init(&argc, &argv);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        test_finalize();
+        exit(1);
+    }
+    opal_set_using_threads(true);
+
+    /* pure spinning */
+    run_test(-1);
+    /* sleep as soon as nothing happens */
+    run_test(0);
+    /* spin for a while, then sleep */
+    run_test(100);
+    run_test(1000);
+
+    opal_finalize();
+
+    return test_finalize();
+}
@@ -0,0 +1,187 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Contention benchmark for the grdma registration cache. Every thread
+ * repeatedly registers and deregisters buffers from a shared pool, which is
+ * the pattern of RDMA transfers from many threads reusing the same buffers.
+ * The memory registration itself is faked so that only the cache is
+ * measured. Compare different values of rcache_grdma_lru_batch.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "opal/constants.h"
+#include "opal/mca/base/mca_base_framework.h"
+#include "opal/mca/rcache/base/base.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/runtime/opal.h"
+#include "opal/runtime/opal_params.h"
+#include "opal/util/sys_limits.h"
+#include "support.h"
+
+#define OPAL_RCACHE_TEST_THREAD_COUNT 8
+#define ITERATIONS                    200000
+#define BUFFER_COUNT                  64
+#define BUFFER_PAGES                  4
+
+#if !defined(timersub)
+#    define timersub(a, b, r)                           \
+        do {                                            \
+            (r)->tv_sec = (a)->tv_sec - (b)->tv_sec;    \
+            if ((a)->tv_usec < (b)->tv_usec) {          \
+                (r)->tv_sec--;                          \
+                (a)->tv_usec += 1000000;                \
+            }                                           \
+            (r)->tv_usec = (a)->tv_usec - (b)->tv_usec; \
+        } while (0)
+#endif
+
+static opal_atomic_int64_t register_calls = 0;
+static opal_atomic_int64_t deregister_calls = 0;
+static mca_rcache_base_module_t *rcache;
+static unsigned char *pool;
+static size_t buffer_size;
+
+static int fake_register_mem(void *reg_data, void *base, size_t size,
+                             mca_rcache_base_registration_t *reg)
+{
+    (void) opal_atomic_fetch_add_64(&register_calls, 1);
+    return OPAL_SUCCESS;
+}
+
+static int fake_deregister_mem(void *reg_data, mca_rcache_base_registration_t *reg)
+{
+    (void) opal_atomic_fetch_add_64(&deregister_calls, 1);
+    return OPAL_SUCCESS;
+}
+
+static void *thread_test(opal_object_t *arg)
+{
+    opal_thread_t *t = (opal_thread_t *) arg;
+    unsigned int seed = (unsigned int) (uintptr_t) t->t_arg;
+    mca_rcache_base_registration_t *reg;
+    intptr_t failed = 0;
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        unsigned char *buffer = pool + (size_t) (rand_r(&seed) % BUFFER_COUNT) * buffer_size;
+
+        if (OPAL_SUCCESS
+            != rcache->rcache_register(rcache, buffer, buffer_size, 0, MCA_RCACHE_ACCESS_ANY,
+                                       &reg)) {
+            ++failed;
+            continue;
+        }
+
+        if (reg->base > buffer || reg->bound < buffer + buffer_size - 1) {
+            ++failed;
+        }
+
+        rcache->rcache_deregister(rcache, reg);
+    }
+
+    return (void *) failed;
+}
+
+int main(int argc, char *argv[])
+{
+    opal_thread_t threads[OPAL_RCACHE_TEST_THREAD_COUNT];
+    mca_rcache_base_resources_t resources = {
+        .cache_name = "bench",
+        .reg_data = NULL,
+        .sizeof_reg = sizeof(mca_rcache_base_registration_t),
+        .register_mem = fake_register_mem,
+        .deregister_mem = fake_deregister_mem,
+    };
+    struct timeval start, stop, total;
+    int64_t registrations = (int64_t) ITERATIONS * OPAL_RCACHE_TEST_THREAD_COUNT;
+    intptr_t failed = 0;
+    double timing;
+    int rc;
+
+    rc = opal_init(&argc, &argv);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        test_finalize();
+        exit(1);
+    }
+
+    test_init("grdma registration cache thread contention");
+
+    opal_set_using_threads(true);
+
+    /* registrations are only cached with leave pinned */
+    opal_leave_pinned = 1;
+
+    rc = mca_base_framework_open(&opal_rcache_base_framework, 0);
+    test_verify_int(OPAL_SUCCESS, rc);
+
+    rcache = mca_rcache_base_module_create("grdma", NULL, &resources);
+    if (NULL == rcache) {
+        test_failure(" could not create a grdma registration cache");
+        (void) mca_base_framework_close(&opal_rcache_base_framework);
+        opal_finalize();
+        return test_finalize();
+    }
+
+    buffer_size = BUFFER_PAGES * opal_getpagesize();
+    rc = posix_memalign((void **) &pool, opal_getpagesize(), BUFFER_COUNT * buffer_size);
+    test_verify_int(0, rc);
+
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < OPAL_RCACHE_TEST_THREAD_COUNT; ++i) {
+        OBJ_CONSTRUCT(&threads[i], opal_thread_t);
+        threads[i].t_run = thread_test;
+        threads[i].t_arg = (void *) (uintptr_t) (i + 1);
+        opal_thread_start(threads + i);
+    }
+
+    for (int i = 0; i < OPAL_RCACHE_TEST_THREAD_COUNT; ++i) {
+        void *ret;
+
+        opal_thread_join(threads + i, &ret);
+        failed += (intptr_t) ret;
+        OBJ_DESTRUCT(&threads[i]);
+    }
+    gettimeofday(&stop, NULL);
+
+    timersub(&stop, &start, &total);
+
+    timing = ((double) total.tv_sec + (double) total.tv_usec * 1e-6) / (double) registrations;
+
+    printf("Thread count: %d Time: %d s %d us %d nsec/regdereg hit rate: %.2f%%\n",
+           OPAL_RCACHE_TEST_THREAD_COUNT, (int) total.tv_sec, (int) total.tv_usec,
+           (int) (timing / 1e-9),
+           100.0 * (double) (registrations - register_calls) / (double) registrations);
+
+    if (0 == failed) {
+        test_success();
+    } else {
+        test_failure(" registration failed or does not cover the buffer");
+    }
+
+    mca_rcache_base_module_destroy(rcache);
+
+    /* every registration must be gone once the cache is destroyed */
+    if (register_calls == deregister_calls) {
+        test_success();
+    } else {
+        test_failure(" registration cache leaked registrations");
+    }
+
+    free(pool);
+    (void) mca_base_framework_close(&opal_rcache_base_framework);
+    opal_finalize();
+
+    return test_finalize();
+}
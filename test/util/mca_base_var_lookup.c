@@ -0,0 +1,122 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check that MCA variables pick up their values from the environment,
+ * including variables set after the first registrations, and time the
+ * registration of many variables and their lookup by name (the path of
+ * MPI_T_cvar_get_index()).
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "opal/constants.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/runtime/opal.h"
+#include "opal/util/printf.h"
+#include "support.h"
+
+#define NUM_VARS    4000
+#define NUM_LOOKUPS 20
+
+static int values[NUM_VARS + 1];
+
+static double now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + 1e-6 * (double) tv.tv_usec;
+}
+
+static int register_var(int i)
+{
+    char name[32];
+
+    snprintf(name, sizeof(name), "var%d", i);
+    values[i] = -1;
+    return mca_base_var_register("opal", "test", "lookup", name, "Test variable",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &values[i]);
+}
+
+int main(int argc, char *argv[])
+{
+    char *env_name, *names[NUM_VARS], value[16];
+    double start, elapsed;
+    int i, vari, errors = 0;
+
+    test_init("mca_base_var_lookup");
+
+    /* every third variable is set in the environment */
+    for (i = 0; i < NUM_VARS; i += 3) {
+        opal_asprintf(&env_name, OPAL_MCA_PREFIX "test_lookup_var%d", i);
+        snprintf(value, sizeof(value), "%d", i);
+        setenv(env_name, value, 1);
+        free(env_name);
+    }
+
+    if (OPAL_SUCCESS != opal_init_util(&argc, &argv)) {
+        test_fail_stop("opal_init_util failed", 1);
+    }
+
+    start = now();
+    for (i = 0; i < NUM_VARS; ++i) {
+        if (0 > register_var(i)) {
+            ++errors;
+        }
+    }
+    elapsed = now() - start;
+    printf("registered %d variables in %.3f ms (%.2f us each)\n", NUM_VARS, elapsed * 1e3,
+           elapsed * 1e6 / NUM_VARS);
+    test_verify_int(0, errors);
+
+    errors = 0;
+    for (i = 0; i < NUM_VARS; ++i) {
+        if (values[i] != (0 == i % 3 ? i : -1)) {
+            ++errors;
+        }
+    }
+    test_verify_int(0, errors);
+
+    /* a variable set after the environment was indexed */
+    opal_asprintf(&env_name, OPAL_MCA_PREFIX "test_lookup_var%d", NUM_VARS);
+    setenv(env_name, "17", 1);
+    free(env_name);
+    (void) register_var(NUM_VARS);
+    test_verify_int(17, values[NUM_VARS]);
+
+    for (i = 0; i < NUM_VARS; ++i) {
+        opal_asprintf(&names[i], "test_lookup_var%d", i);
+    }
+    start = now();
+    errors = 0;
+    for (int round = 0; round < NUM_LOOKUPS; ++round) {
+        for (i = 0; i < NUM_VARS; ++i) {
+            if (OPAL_SUCCESS != mca_base_var_find_by_name(names[i], &vari)) {
+                ++errors;
+            }
+        }
+    }
+    elapsed = now() - start;
+    printf("%d lookups by name in %.3f ms (%.0f lookups/s)\n", NUM_LOOKUPS * NUM_VARS,
+           elapsed * 1e3, NUM_LOOKUPS * NUM_VARS / elapsed);
+    test_verify_int(0, errors);
+
+    for (i = 0; i < NUM_VARS; ++i) {
+        free(names[i]);
+    }
+    opal_finalize_util();
+
+    return test_finalize();
+}